@@ -0,0 +1,265 @@
+#pragma once
+
+#include <necrolog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace shv {
+namespace benchmark {
+
+/// prevent compiler from optimizing out computation of value
+template<typename T>
+inline void doNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r"(&value) : "memory");
+#else
+	static const void * volatile sink;
+	sink = &value;
+#endif
+}
+
+/**
+Minimal microbenchmark runner
+
+Every benchmark function is called with number of iterations to run,
+iteration count is calibrated to run at least min-time / repetitions msec.
+Results are written as JSON to stdout or to the file specified by -o option.
+*/
+class Runner
+{
+public:
+	using Function = std::function<void (size_t iterations)>;
+
+	struct Result
+	{
+		std::string name;
+		size_t iterations = 0;
+		size_t repetitions = 0;
+		size_t bytesPerOp = 0;
+		double nsPerOpMin = 0;
+		double nsPerOpMedian = 0;
+		double nsPerOpMax = 0;
+	};
+
+	/// extra_help describes benchmark specific options, use option() to get their values
+	Runner(int argc, char *argv[], const std::string &extra_help = std::string())
+		: m_extraHelp(extra_help)
+	{
+		m_executable = argv[0];
+		std::vector<std::string> args = NecroLog::setCLIOptions(argc, argv);
+		m_args = args;
+		for (size_t i = 1; i < args.size(); ++i) {
+			const std::string &arg = args[i];
+			if(arg == "--filter" && i < args.size() - 1)
+				m_filter = args[++i];
+			else if(arg == "--min-time" && i < args.size() - 1)
+				m_minTimeMsec = std::max(1, std::stoi(args[++i]));
+			else if(arg == "--repetitions" && i < args.size() - 1)
+				m_repetitions = static_cast<size_t>(std::max(1, std::stoi(args[++i])));
+			else if(arg == "-o" && i < args.size() - 1)
+				m_outFile = args[++i];
+			else if(arg == "--list")
+				m_listOnly = true;
+			else if(arg == "-h" || arg == "--help")
+				help();
+		}
+	}
+
+	const std::vector<Result>& results() const {return m_results;}
+
+	/// value of command line option followed by value, default_value if option is not present
+	std::string option(const std::string &name, const std::string &default_value) const
+	{
+		for (size_t i = 1; i + 1 < m_args.size(); ++i) {
+			if(m_args[i] == name)
+				return m_args[i + 1];
+		}
+		return default_value;
+	}
+	/// add benchmark environment description to JSON output, like storage type or data set size
+	void addContext(const std::string &key, const std::string &value)
+	{
+		m_context.push_back(std::make_pair(key, value));
+	}
+
+	/// bytes_per_op is used to compute throughput, pass 0 if not applicable
+	void run(const std::string &name, const Function &fn, size_t bytes_per_op = 0)
+	{
+		if(!m_filter.empty() && name.find(m_filter) == std::string::npos)
+			return;
+		if(m_listOnly) {
+			std::cout << name << std::endl;
+			return;
+		}
+		const double rep_ns = static_cast<double>(m_minTimeMsec) * 1e6 / static_cast<double>(m_repetitions);
+		size_t n = 1;
+		while(true) {
+			double ns = measure(fn, n);
+			if(ns >= rep_ns)
+				break;
+			double factor = (ns > 0)? (rep_ns * 1.2 / ns): 10;
+			factor = std::max(1.5, std::min(10., factor));
+			n = static_cast<size_t>(static_cast<double>(n) * factor) + 1;
+		}
+		std::vector<double> ns_per_op;
+		for (size_t i = 0; i < m_repetitions; ++i)
+			ns_per_op.push_back(measure(fn, n) / static_cast<double>(n));
+		std::sort(ns_per_op.begin(), ns_per_op.end());
+		Result res;
+		res.name = name;
+		res.iterations = n;
+		res.repetitions = m_repetitions;
+		res.bytesPerOp = bytes_per_op;
+		res.nsPerOpMin = ns_per_op.front();
+		res.nsPerOpMedian = ns_per_op[ns_per_op.size() / 2];
+		res.nsPerOpMax = ns_per_op.back();
+		std::fprintf(stderr, "%-48s %12.1f ns/op %12zu iterations\n", name.c_str(), res.nsPerOpMedian, n);
+		m_results.push_back(res);
+	}
+
+	/// write results and return process exit code
+	int finish() const
+	{
+		if(m_listOnly)
+			return 0;
+		if(m_outFile.empty()) {
+			writeJson(std::cout);
+			return 0;
+		}
+		std::ofstream out(m_outFile, std::ios::out | std::ios::binary | std::ios::trunc);
+		if(!out) {
+			nError() << "Cannot open" << m_outFile << "for writing";
+			return 1;
+		}
+		writeJson(out);
+		return out? 0: 1;
+	}
+
+	void writeJson(std::ostream &out) const
+	{
+		char date[32];
+		std::time_t now = std::time(nullptr);
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+		out << "{\n";
+		out << "\t\"context\": {\n";
+		out << "\t\t\"executable\": " << quoted(m_executable) << ",\n";
+		out << "\t\t\"date\": " << quoted(date) << ",\n";
+#ifdef __VERSION__
+		out << "\t\t\"compiler\": " << quoted(__VERSION__) << ",\n";
+#endif
+#ifdef NDEBUG
+		out << "\t\t\"buildType\": \"release\",\n";
+#else
+		out << "\t\t\"buildType\": \"debug\",\n";
+#endif
+		for(const auto &kv : m_context)
+			out << "\t\t" << quoted(kv.first) << ": " << quoted(kv.second) << ",\n";
+		out << "\t\t\"minTimeMsec\": " << m_minTimeMsec << ",\n";
+		out << "\t\t\"repetitions\": " << m_repetitions << "\n";
+		out << "\t},\n";
+		out << "\t\"benchmarks\": [";
+		for (size_t i = 0; i < m_results.size(); ++i) {
+			const Result &r = m_results[i];
+			double ops_per_sec = (r.nsPerOpMedian > 0)? 1e9 / r.nsPerOpMedian: 0;
+			out << (i? ",\n": "\n");
+			out << "\t\t{";
+			out << "\"name\": " << quoted(r.name);
+			out << ", \"iterations\": " << r.iterations;
+			out << ", \"repetitions\": " << r.repetitions;
+			out << ", \"nsPerOpMin\": " << number(r.nsPerOpMin);
+			out << ", \"nsPerOpMedian\": " << number(r.nsPerOpMedian);
+			out << ", \"nsPerOpMax\": " << number(r.nsPerOpMax);
+			out << ", \"opsPerSec\": " << number(ops_per_sec);
+			if(r.bytesPerOp > 0) {
+				out << ", \"bytesPerOp\": " << r.bytesPerOp;
+				out << ", \"bytesPerSec\": " << number(ops_per_sec * static_cast<double>(r.bytesPerOp));
+			}
+			out << "}";
+		}
+		out << "\n\t]\n";
+		out << "}\n";
+	}
+private:
+	static double measure(const Function &fn, size_t n)
+	{
+		auto start = std::chrono::steady_clock::now();
+		fn(n);
+		auto end = std::chrono::steady_clock::now();
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+	static std::string quoted(const std::string &s)
+	{
+		std::string ret = "\"";
+		for(char c : s) {
+			switch (c) {
+			case '"': ret += "\\\""; break;
+			case '\\': ret += "\\\\"; break;
+			case '\n': ret += "\\n"; break;
+			case '\t': ret += "\\t"; break;
+			default:
+				if(static_cast<unsigned char>(c) < 0x20) {
+					char buff[8];
+					std::snprintf(buff, sizeof(buff), "\\u%04x", c);
+					ret += buff;
+				}
+				else {
+					ret += c;
+				}
+			}
+		}
+		ret += '"';
+		return ret;
+	}
+	static std::string number(double d)
+	{
+		char buff[32];
+		std::snprintf(buff, sizeof(buff), "%.3f", d);
+		return buff;
+	}
+	void help() const
+	{
+		std::cout << m_executable << R"( microbenchmarks
+
+USAGE:
+--filter substring
+	run only benchmarks containing substring in their name
+--min-time msec
+	minimal time spent in each benchmark, default is 1000 msec
+--repetitions n
+	number of measurements of each benchmark, median is reported, default is 5
+-o file
+	write JSON results to file instead of stdout
+--list
+	list benchmark names
+)";
+		std::cout << m_extraHelp;
+		std::cout << NecroLog::cliHelp();
+		exit(0);
+	}
+private:
+	std::string m_executable;
+	std::string m_extraHelp;
+	std::vector<std::string> m_args;
+	std::vector<std::pair<std::string, std::string>> m_context;
+	std::string m_filter;
+	std::string m_outFile;
+	int m_minTimeMsec = 1000;
+	size_t m_repetitions = 5;
+	bool m_listOnly = false;
+	std::vector<Result> m_results;
+};
+
+} // namespace benchmark
+} // namespace shv
@@ -0,0 +1,29 @@
+include( ../subproject_integration.pri )
+
+TEMPLATE = app
+
+CONFIG += c++11
+CONFIG -= app_bundle
+QT -= core widgets gui
+
+DESTDIR = $$SHV_PROJECT_TOP_BUILDDIR/bin
+unix:LIBDIR = $$SHV_PROJECT_TOP_BUILDDIR/lib
+win32:LIBDIR = $$SHV_PROJECT_TOP_BUILDDIR/bin
+
+LIBS += \
+    -L$$LIBDIR \
+    -lnecrolog \
+    -lshvchainpack \
+
+unix {
+    LIBS += \
+        -Wl,-rpath,\'\$\$ORIGIN/../lib\'
+}
+
+INCLUDEPATH += \
+	$$PWD \
+	$$SHV_PROJECT_TOP_SRCDIR/3rdparty/necrolog/include \
+	$$LIBSHV_SRC_DIR/libshvchainpack/include \
+
+HEADERS += \
+	$$PWD/benchmark.h \
@@ -0,0 +1,7 @@
+message("========== project: $$PWD")
+include( ../benchmark.pri )
+
+TARGET = bench-chainpack
+
+SOURCES += \
+	main.cpp \
@@ -0,0 +1,386 @@
+#include "benchmark.h"
+
+#include <shv/chainpack/chainpackreader.h>
+#include <shv/chainpack/chainpackwriter.h>
+#include <shv/chainpack/cponreader.h>
+#include <shv/chainpack/cponwriter.h>
+#include <shv/chainpack/pullreader.h>
+#include <shv/chainpack/rpc.h>
+#include <shv/chainpack/rpcdriver.h>
+#include <shv/chainpack/rpcmessage.h>
+#include <shv/chainpack/rpcvaluearena.h>
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace cp = shv::chainpack;
+using shv::benchmark::doNotOptimize;
+
+namespace {
+
+/// RpcDriver writing frames to memory buffer and decoding frames passed to receive()
+class LoopbackRpcDriver : public cp::RpcDriver
+{
+	using Super = cp::RpcDriver;
+public:
+	LoopbackRpcDriver(cp::Rpc::ProtocolType protocol_type)
+	{
+		setProtocolType(protocol_type);
+		setMessageReceivedCallback([this](const cp::RpcValue &msg) {
+			doNotOptimize(msg);
+			m_receivedCount++;
+		});
+	}
+
+	void receive(std::string &&bytes) {onBytesRead(std::move(bytes));}
+	std::string& writtenData() {return m_writtenData;}
+	size_t receivedCount() const {return m_receivedCount;}
+protected:
+	bool isOpen() override {return true;}
+	void writeMessageBegin() override {}
+	void writeMessageEnd() override {}
+	int64_t writeBytes(const char *bytes, size_t length) override
+	{
+		m_writtenData.append(bytes, length);
+		return static_cast<int64_t>(length);
+	}
+	void onProcessReadDataException(std::exception &e) override
+	{
+		throw std::runtime_error(e.what());
+	}
+private:
+	std::string m_writtenData;
+	size_t m_receivedCount = 0;
+};
+
+cp::RpcValue make_signal(int n)
+{
+	cp::RpcSignal sig;
+	sig.setMethod(cp::Rpc::SIG_VAL_CHANGED);
+	sig.setShvPath("shv/eu/prague/odpojovace/tc/TC" + std::to_string(n % 100) + "/status");
+	sig.setParams(cp::RpcValue::Map{
+					  {"state", n % 4},
+					  {"errors", cp::RpcValue::List{n % 2 == 0, "ok"}},
+					  {"voltage", 600.5 + n},
+				  });
+	return sig.value();
+}
+
+cp::RpcValue make_getlog_response(int row_count)
+{
+	cp::RpcValue::List log;
+	int64_t msec = 1546300800000;
+	for (int i = 0; i < row_count; ++i) {
+		msec += 137;
+		cp::RpcValue value;
+		switch (i % 4) {
+		case 0: value = i % 3 == 0; break;
+		case 1: value = i; break;
+		case 2: value = i * 0.25; break;
+		default: value = cp::RpcValue::Map{{"state", i % 5}, {"code", "E" + std::to_string(i % 17)}}; break;
+		}
+		log.push_back(cp::RpcValue::List{
+						  cp::RpcValue::DateTime::fromMSecsSinceEpoch(msec),
+						  "node" + std::to_string(i % 50) + "/status/value",
+						  value,
+						  cp::RpcValue(),
+						  "chng",
+						  0,
+						  cp::RpcValue(),
+					  });
+	}
+	cp::RpcValue result = log;
+	result.setMetaValue("fields", cp::RpcValue::List{"timestamp", "path", "value", "shortTime", "domain", "valueFlags", "userId"});
+	result.setMetaValue("since", cp::RpcValue::DateTime::fromMSecsSinceEpoch(1546300800000));
+	result.setMetaValue("until", cp::RpcValue::DateTime::fromMSecsSinceEpoch(msec));
+	result.setMetaValue("recordCount", row_count);
+	cp::RpcResponse resp;
+	resp.setRequestId(123);
+	resp.setResult(result);
+	return resp.value();
+}
+
+cp::RpcValue make_ls_response(int child_count)
+{
+	cp::RpcValue::List lst;
+	for (int i = 0; i < child_count; ++i)
+		lst.push_back(cp::RpcValue::List{"child" + std::to_string(i), i % 3 != 0});
+	cp::RpcResponse resp;
+	resp.setRequestId(456);
+	resp.setResult(lst);
+	return resp.value();
+}
+
+/// config like tree of string keyed maps, integer keyed maps and lists, typical for dir/ls dumps and settings
+cp::RpcValue make_nested(int depth, int fanout)
+{
+	if(depth == 0) {
+		cp::RpcValue leaf = cp::RpcValue::Map{
+				{"description", "leaf node with moderately long description text"},
+				{"value", fanout * 1.5},
+				{"unit", "V"},
+		};
+		leaf.setMetaValue("typeName", "Voltage");
+		return leaf;
+	}
+	cp::RpcValue::Map map;
+	cp::RpcValue::IMap imap;
+	cp::RpcValue::List lst;
+	for (int i = 0; i < fanout; ++i) {
+		map["child" + std::to_string(i)] = make_nested(depth - 1, fanout);
+		imap[i] = "item" + std::to_string(i);
+		lst.push_back(cp::RpcValue::List{i, "name" + std::to_string(i), i % 2 == 0});
+	}
+	map["index"] = imap;
+	map["items"] = lst;
+	return map;
+}
+
+std::string chainpack_pack(const cp::RpcValue &val)
+{
+	std::ostringstream out;
+	{
+		cp::ChainPackWriter wr(out);
+		wr << val;
+	}
+	return out.str();
+}
+
+std::string cpon_pack(const cp::RpcValue &val)
+{
+	std::ostringstream out;
+	{
+		cp::CponWriter wr(out);
+		wr << val;
+	}
+	return out.str();
+}
+
+void add_codec_benchmarks(shv::benchmark::Runner &runner, const std::string &payload_name, const cp::RpcValue &val)
+{
+	const std::string chainpack_data = chainpack_pack(val);
+	const std::string cpon_data = cpon_pack(val);
+	runner.run("chainpack/write/" + payload_name, [&val](size_t n) {
+		for (size_t i = 0; i < n; ++i)
+			doNotOptimize(chainpack_pack(val));
+	}, chainpack_data.size());
+	runner.run("chainpack/read/" + payload_name, [&chainpack_data](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			std::istringstream in(chainpack_data);
+			cp::ChainPackReader rd(in);
+			cp::RpcValue v;
+			rd.read(v);
+			doNotOptimize(v);
+		}
+	}, chainpack_data.size());
+	runner.run("chainpack/readArena/" + payload_name, [&chainpack_data](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			cp::RpcValueArena arena(chainpack_data.size() * 4);
+			cp::RpcValue v;
+			{
+				cp::RpcValueArena::Scope scope(arena);
+				std::istringstream in(chainpack_data);
+				cp::ChainPackReader rd(in);
+				rd.read(v);
+			}
+			doNotOptimize(v);
+		}
+	}, chainpack_data.size());
+	runner.run("cpon/write/" + payload_name, [&val](size_t n) {
+		for (size_t i = 0; i < n; ++i)
+			doNotOptimize(cpon_pack(val));
+	}, cpon_data.size());
+	runner.run("cpon/read/" + payload_name, [&cpon_data](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			std::istringstream in(cpon_data);
+			cp::CponReader rd(in);
+			cp::RpcValue v;
+			rd.read(v);
+			doNotOptimize(v);
+		}
+	}, cpon_data.size());
+}
+
+/// walks getLog response rows without building the RpcValue tree
+void add_pullreader_benchmarks(shv::benchmark::Runner &runner, const cp::RpcValue &getlog)
+{
+	const std::string data = chainpack_pack(getlog);
+	runner.run("pullreader/walk/getLog", [&data](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			std::istringstream in(data);
+			cp::PullReader rd(in);
+			rd.next();
+			cp::PullReader::Cursor msg(rd);
+			size_t row_count = 0;
+			while(msg.next()) {
+				if(msg.intKey() != cp::RpcMessage::MetaType::Key::Result || rd.event() != cp::PullReader::Event::ListBegin)
+					continue;
+				cp::PullReader::Cursor rows(rd);
+				while(rows.next()) {
+					if(rd.event() != cp::PullReader::Event::ListBegin)
+						continue;
+					cp::PullReader::Cursor cols(rd);
+					while(cols.next()) {
+						switch (cols.index()) {
+						case 0: doNotOptimize(rd.toDateTime()); break;
+						case 1: doNotOptimize(rd.toString()); break;
+						case 2: doNotOptimize(rd.readValue()); break;
+						default: break;
+						}
+					}
+					row_count++;
+				}
+			}
+			if(row_count == 0)
+				throw std::runtime_error("No rows walked");
+		}
+	}, data.size());
+}
+
+/// string keyed map of given type built in key order like decoded data and looked up by all its keys
+template<typename M>
+void add_map_benchmarks(shv::benchmark::Runner &runner, const std::string &map_name, size_t size)
+{
+	std::vector<std::string> keys;
+	for (size_t i = 0; i < size; ++i)
+		keys.push_back("key" + std::to_string(100 + i));
+	const std::string suffix = '/' + map_name + '/' + std::to_string(size);
+	runner.run("map/build" + suffix, [&keys](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			M map;
+			for(const std::string &key : keys)
+				map[key] = static_cast<int>(i);
+			doNotOptimize(map);
+		}
+	});
+	M map;
+	for(const std::string &key : keys)
+		map[key] = 1;
+	runner.run("map/lookup" + suffix, [&keys, &map](size_t n) {
+		int sum = 0;
+		for (size_t i = 0; i < n; ++i) {
+			for(const std::string &key : keys) {
+				auto it = map.find(key);
+				if(it != map.end())
+					sum += it->second.toInt();
+			}
+		}
+		doNotOptimize(sum);
+	});
+	runner.run("map/iterate" + suffix, [&map](size_t n) {
+		int sum = 0;
+		for (size_t i = 0; i < n; ++i) {
+			for(const auto &kv : map)
+				sum += kv.second.toInt();
+		}
+		doNotOptimize(sum);
+	});
+}
+
+void add_rpcdriver_benchmarks(shv::benchmark::Runner &runner, const std::string &payload_name, const cp::RpcValue &val)
+{
+	std::string frame;
+	{
+		LoopbackRpcDriver driver(cp::Rpc::ProtocolType::ChainPack);
+		driver.sendRpcValue(val);
+		frame = driver.writtenData();
+	}
+	runner.run("rpcdriver/send/" + payload_name, [&val](size_t n) {
+		LoopbackRpcDriver driver(cp::Rpc::ProtocolType::ChainPack);
+		for (size_t i = 0; i < n; ++i) {
+			driver.sendRpcValue(val);
+			driver.writtenData().clear();
+		}
+	}, frame.size());
+	for(bool arena : {false, true}) {
+		runner.run((arena? "rpcdriver/receiveArena/": "rpcdriver/receive/") + payload_name, [&frame, arena](size_t n) {
+			LoopbackRpcDriver driver(cp::Rpc::ProtocolType::ChainPack);
+			driver.setMessageArenaEnabled(arena);
+			for (size_t i = 0; i < n; ++i)
+				driver.receive(std::string(frame));
+			if(driver.receivedCount() != n)
+				throw std::runtime_error("Frame decoding error");
+		}, frame.size());
+	}
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	shv::benchmark::Runner runner(argc, argv);
+
+	const cp::RpcValue signal = make_signal(1);
+	const cp::RpcValue getlog = make_getlog_response(1000);
+	const cp::RpcValue ls = make_ls_response(100);
+	const cp::RpcValue nested = make_nested(4, 6);
+
+	runner.run("rpcvalue/construct/signal", [](size_t n) {
+		for (size_t i = 0; i < n; ++i)
+			doNotOptimize(make_signal(static_cast<int>(i)));
+	});
+	runner.run("rpcvalue/construct/getLog", [](size_t n) {
+		for (size_t i = 0; i < n; ++i)
+			doNotOptimize(make_getlog_response(1000));
+	});
+	runner.run("rpcvalue/copy/getLog", [&getlog](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			cp::RpcValue v = getlog;
+			doNotOptimize(v);
+		}
+	});
+	runner.run("rpcvalue/copyResult/getLog", [&getlog](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			cp::RpcValue::List lst = cp::RpcResponse(getlog).result().asList();
+			doNotOptimize(lst);
+		}
+	});
+	runner.run("metadata/access/signal", [&signal](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			const cp::RpcValue::MetaData &md = signal.metaData();
+			bool is_signal = cp::RpcMessage::isSignal(md);
+			cp::RpcValue method = cp::RpcMessage::method(md);
+			cp::RpcValue path = cp::RpcMessage::shvPath(md);
+			doNotOptimize(is_signal);
+			doNotOptimize(method);
+			doNotOptimize(path);
+		}
+	});
+	runner.run("metadata/access/response", [&ls](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			const cp::RpcValue::MetaData &md = ls.metaData();
+			bool is_response = cp::RpcMessage::isResponse(md);
+			cp::RpcValue rq_id = cp::RpcMessage::requestId(md);
+			cp::RpcValue caller_ids = cp::RpcMessage::callerIds(md);
+			doNotOptimize(is_response);
+			doNotOptimize(rq_id);
+			doNotOptimize(caller_ids);
+		}
+	});
+	runner.run("metadata/modify/signal", [&signal](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			cp::RpcValue::MetaData md = signal.metaData();
+			cp::RpcMessage::setShvPath(md, "broker/mount/point");
+			cp::RpcMessage::pushCallerId(md, static_cast<int>(i));
+			doNotOptimize(md);
+		}
+	});
+
+	add_codec_benchmarks(runner, "signal", signal);
+	add_codec_benchmarks(runner, "getLog", getlog);
+	add_codec_benchmarks(runner, "ls", ls);
+	add_codec_benchmarks(runner, "nested", nested);
+	add_pullreader_benchmarks(runner, getlog);
+
+	for(size_t size : {4, 8, 32}) {
+		add_map_benchmarks<std::map<std::string, cp::RpcValue>>(runner, "std", size);
+		add_map_benchmarks<cp::RpcValue::Map>(runner, "flat", size);
+	}
+
+	add_rpcdriver_benchmarks(runner, "signal", signal);
+	add_rpcdriver_benchmarks(runner, "getLog", getlog);
+	add_rpcdriver_benchmarks(runner, "ls", ls);
+
+	return runner.finish();
+}
@@ -0,0 +1,13 @@
+message("========== project: $$PWD")
+include( ../benchmark.pri )
+
+TARGET = bench-journal
+
+LIBS += \
+    -lshvcore \
+
+INCLUDEPATH += \
+	$$LIBSHV_SRC_DIR/libshvcore/include \
+
+SOURCES += \
+	main.cpp \
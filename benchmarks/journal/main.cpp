@@ -0,0 +1,268 @@
+#include "benchmark.h"
+
+#include <shv/core/utils/shvfilejournal.h>
+#include <shv/core/utils/shvgetlogparams.h>
+#include <shv/core/utils/shvjournalentry.h>
+#include <shv/core/utils/shvlogfilereader.h>
+#include <shv/core/utils/shvmemoryjournal.h>
+
+#include <shv/chainpack/chainpackwriter.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace cp = shv::chainpack;
+using namespace shv::core::utils;
+using shv::benchmark::doNotOptimize;
+
+namespace {
+
+const char *journal_help =
+R"(
+JOURNAL OPTIONS:
+--dir path
+	directory where journals are created, use it to compare storage back-ends, default is /tmp/shv-bench-journal
+--entries n
+	number of entries in generated journal, default is 200000
+--paths n
+	number of distinct paths in generated journal, default is 2000
+)";
+
+void remove_dir(const std::string &path)
+{
+	DIR *dir = ::opendir(path.c_str());
+	if(!dir)
+		return;
+	while(dirent *ent = ::readdir(dir)) {
+		std::string name = ent->d_name;
+		if(name == "." || name == "..")
+			continue;
+		std::string fn = path + '/' + name;
+		struct stat st;
+		if(::stat(fn.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+			remove_dir(fn);
+		else
+			::unlink(fn.c_str());
+	}
+	::closedir(dir);
+	::rmdir(path.c_str());
+}
+
+/// generates reproducible device trace with skewed path popularity and mixed value types
+class TraceGenerator
+{
+public:
+	TraceGenerator(size_t path_count, int64_t start_msec)
+		: m_msec(start_msec)
+	{
+		static const char *leaves[] = {"status", "voltage", "current", "errors", "doorOpen", "temperature"};
+		for (size_t i = 0; i < path_count; ++i) {
+			m_paths.push_back("zone" + std::to_string(i % 10)
+							  + "/tc" + std::to_string(i / 10 % 100)
+							  + "/dev" + std::to_string(i / 1000)
+							  + "/" + leaves[i % (sizeof(leaves) / sizeof(leaves[0]))]);
+		}
+	}
+
+	ShvJournalEntry next()
+	{
+		m_msec += m_random() % 20;
+		// skewed distribution, low path indexes are changed more often
+		size_t ix = m_random() % (m_random() % m_paths.size() + 1);
+		unsigned r = m_random();
+		cp::RpcValue value;
+		switch (ix % 4) {
+		case 0: value = (r % 2) == 0; break;
+		case 1: value = static_cast<int>(r % 1000); break;
+		case 2: value = static_cast<double>(r % 100000) / 100; break;
+		default: value = cp::RpcValue::Map{{"state", static_cast<int>(r % 5)}, {"errors", static_cast<int>(r % 3)}}; break;
+		}
+		ShvJournalEntry e(m_paths[ix], value);
+		e.epochMsec = m_msec;
+		return e;
+	}
+	int64_t msec() const {return m_msec;}
+	const std::vector<std::string>& paths() const {return m_paths;}
+private:
+	std::mt19937 m_random{1};
+	std::vector<std::string> m_paths;
+	int64_t m_msec;
+};
+
+void init_journal(ShvFileJournal &journal, const std::string &dir)
+{
+	journal.setJournalDir(dir);
+	journal.setFileSizeLimit(1024 * 1024);
+	journal.setJournalSizeLimit(256 * 1024 * 1024);
+}
+
+void add_append_benchmarks(shv::benchmark::Runner &runner, const std::string &dir, size_t path_count)
+{
+	struct Variant
+	{
+		const char *name;
+		ShvJournalFileWriter::FlushPolicy policy;
+		bool async;
+	};
+	ShvJournalFileWriter::FlushPolicy no_buffer;
+	ShvJournalFileWriter::FlushPolicy buffered;
+	buffered.maxPendingBytes = 64 * 1024;
+	const Variant variants[] = {
+		{"journal/append/unbuffered", no_buffer, false},
+		{"journal/append/buffered64k", buffered, false},
+		{"journal/append/async", buffered, true},
+	};
+	TraceGenerator gen(path_count, 0);
+	std::vector<ShvJournalEntry> entries;
+	for (size_t i = 0; i < 100000; ++i)
+		entries.push_back(gen.next());
+	for(const Variant &v : variants) {
+		runner.run(v.name, [&dir, &v, &entries](size_t n) {
+			const std::string journal_dir = dir + "/append";
+			remove_dir(journal_dir);
+			ShvFileJournal journal("bench");
+			init_journal(journal, journal_dir);
+			journal.setFlushPolicy(v.policy);
+			if(v.async)
+				journal.startAsyncWriter();
+			int64_t msec = cp::RpcValue::DateTime::now().msecsSinceEpoch();
+			for (size_t i = 0; i < n; ++i) {
+				ShvJournalEntry e = entries[i % entries.size()];
+				e.epochMsec = msec += 5;
+				journal.append(e);
+			}
+			if(v.async)
+				journal.stopAsyncWriter();
+			journal.flush();
+		});
+	}
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	shv::benchmark::Runner runner(argc, argv, journal_help);
+
+	const std::string dir = runner.option("--dir", "/tmp/shv-bench-journal");
+	const size_t entry_count = static_cast<size_t>(std::stoul(runner.option("--entries", "200000")));
+	const size_t path_count = std::max<size_t>(1, std::stoul(runner.option("--paths", "2000")));
+	runner.addContext("journalDir", dir);
+	runner.addContext("entries", std::to_string(entry_count));
+	runner.addContext("paths", std::to_string(path_count));
+
+	remove_dir(dir);
+
+	add_append_benchmarks(runner, dir, path_count);
+
+	// data set for read benchmarks
+	const std::string data_dir = dir + "/data";
+	ShvFileJournal journal("bench");
+	init_journal(journal, data_dir);
+	{
+		ShvJournalFileWriter::FlushPolicy policy;
+		policy.maxPendingBytes = 64 * 1024;
+		journal.setFlushPolicy(policy);
+	}
+	const int64_t start_msec = cp::RpcValue::DateTime::now().msecsSinceEpoch() - 24 * 60 * 60 * 1000;
+	TraceGenerator gen(path_count, start_msec);
+	for (size_t i = 0; i < entry_count; ++i)
+		journal.append(gen.next());
+	journal.flush();
+	const int64_t end_msec = gen.msec();
+	const int64_t mid_msec = start_msec + (end_msec - start_msec) / 2;
+
+	struct Query
+	{
+		const char *name;
+		ShvGetLogParams params;
+	};
+	std::vector<Query> queries;
+	{
+		ShvGetLogParams params;
+		params.since = cp::RpcValue::DateTime::fromMSecsSinceEpoch(end_msec - 10 * 1000);
+		queries.push_back(Query{"recent10s", params});
+	}
+	{
+		ShvGetLogParams params;
+		params.since = cp::RpcValue::DateTime::fromMSecsSinceEpoch(mid_msec);
+		params.until = cp::RpcValue::DateTime::fromMSecsSinceEpoch(mid_msec + 60 * 1000);
+		queries.push_back(Query{"middle1min", params});
+	}
+	{
+		ShvGetLogParams params;
+		params.since = cp::RpcValue::DateTime::fromMSecsSinceEpoch(mid_msec);
+		params.until = cp::RpcValue::DateTime::fromMSecsSinceEpoch(mid_msec + 60 * 1000);
+		params.withSnapshot = true;
+		queries.push_back(Query{"middle1minSnapshot", params});
+	}
+	{
+		ShvGetLogParams params;
+		params.since = cp::RpcValue::DateTime::fromMSecsSinceEpoch(mid_msec);
+		params.pathPattern = "zone1/**";
+		params.recordCountLimit = 10000;
+		queries.push_back(Query{"middlePathPattern", params});
+	}
+	ShvGetLogParams full_params;
+	full_params.since = cp::RpcValue::DateTime::fromMSecsSinceEpoch(start_msec);
+	full_params.recordCountLimit = static_cast<int>(std::min<size_t>(entry_count, 100000));
+	queries.push_back(Query{"full", full_params});
+	{
+		ShvGetLogParams params;
+		params.since = ShvGetLogParams::SINCE_LAST;
+		params.withSnapshot = true;
+		queries.push_back(Query{"sinceLast", params});
+	}
+	for(const Query &q : queries) {
+		runner.run(std::string("journal/getLog/") + q.name, [&journal, &q](size_t n) {
+			for (size_t i = 0; i < n; ++i)
+				doNotOptimize(journal.getLog(q.params));
+		});
+	}
+
+	cp::RpcValue full_log = journal.getLog(full_params);
+	runner.run("memory/loadLog", [&full_log](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			ShvMemoryJournal memory_journal;
+			memory_journal.loadLog(full_log);
+			doNotOptimize(memory_journal);
+		}
+	});
+	ShvMemoryJournal memory_journal;
+	memory_journal.loadLog(full_log);
+	for(const Query &q : queries) {
+		if(q.params.isSinceLast())
+			continue;
+		runner.run(std::string("memory/getLog/") + q.name, [&memory_journal, &q](size_t n) {
+			for (size_t i = 0; i < n; ++i)
+				doNotOptimize(memory_journal.getLog(q.params));
+		});
+	}
+
+	const std::string log_file = dir + "/full.chpk";
+	std::string log_data = full_log.toChainPack();
+	{
+		std::ofstream out(log_file, std::ios::binary | std::ios::out | std::ios::trunc);
+		out << log_data;
+	}
+	runner.run("logfilereader/decode", [&log_file](size_t n) {
+		for (size_t i = 0; i < n; ++i) {
+			ShvLogFileReader rd(log_file);
+			size_t cnt = 0;
+			while(rd.next()) {
+				doNotOptimize(rd.entry());
+				cnt++;
+			}
+			if(cnt == 0)
+				throw std::runtime_error("Empty log file");
+		}
+	}, log_data.size());
+
+	remove_dir(dir);
+	return runner.finish();
+}
@@ -22,3 +22,8 @@ CONFIG(debug, debug|release) {
 SUBDIRS += \
     tests \
 }
+
+CONFIG(release, debug|release) {
+SUBDIRS += \
+    benchmarks \
+}
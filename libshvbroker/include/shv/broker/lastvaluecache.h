@@ -0,0 +1 @@
+#include "../../../src/lastvaluecache.h"
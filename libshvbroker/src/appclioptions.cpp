@@ -41,6 +41,16 @@ AppCliOptions::AppCliOptions()
 	addOption("masters.connections").setType(cp::RpcValue::Type::Map).setComment("Can be used from config file only.");
 	addOption("masters.enabled").setType(cp::RpcValue::Type::Bool).setNames("--mce", "--master-connections-enabled").setComment("Enable slave connections to master broker.");
 
+	addOption("lastValueCache.enabled").setType(cp::RpcValue::Type::Bool).setNames("--lvc", "--last-value-cache")
+			.setComment("Retain last chng signal of every path, values can be read in bulk by .broker/app:lastValues")
+			.setDefaultValue(false);
+	addOption("lastValueCache.replayOnSubscribe").setType(cp::RpcValue::Type::Bool).setNames("--lvc-replay", "--last-value-cache-replay")
+			.setComment("Send retained chng signals to client, when it subscribes them")
+			.setDefaultValue(false);
+	addOption("lastValueCache.maxSize").setType(cp::RpcValue::Type::Int).setNames("--lvc-max-size", "--last-value-cache-max-size")
+			.setComment("Maximum number of paths in last value cache")
+			.setDefaultValue(100000);
+
 	//addOption("master.broker.device.id").setType(shv::chainpack::RpcValue::Type::String).setNames("--master-broker-device-id").setComment("Master broker device ID");
 }
 
@@ -43,6 +43,10 @@ public:
 	CLIOPTION_GETTER_SETTER2(shv::chainpack::RpcValue, "masters.connections", m, setM, asterBrokersConnections)
 	CLIOPTION_GETTER_SETTER2(bool, "masters.enabled", is, set, MasterBrokersEnabled)
 
+	CLIOPTION_GETTER_SETTER2(bool, "lastValueCache.enabled", is, set, LastValueCacheEnabled)
+	CLIOPTION_GETTER_SETTER2(bool, "lastValueCache.replayOnSubscribe", is, set, LastValueCacheReplayOnSubscribe)
+	CLIOPTION_GETTER_SETTER2(int, "lastValueCache.maxSize", l, setL, astValueCacheMaxSize)
+
 	//CLIOPTION_GETTER_SETTER2(std::string, "master.broker.device.id", m, setM, asterBrokerDeviceId)
 };
 
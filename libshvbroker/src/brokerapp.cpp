@@ -216,6 +216,11 @@ BrokerApp::BrokerApp(int &argc, char **argv, AppCliOptions *cli_opts)
 {
 	//shvInfo() << "creating SHV BROKER application object ver." << versionString();
 	m_brokerId = m_cliOptions->brokerId();
+	if(m_cliOptions->isLastValueCacheEnabled()) {
+		shvInfo() << "Last value cache enabled, max size:" << m_cliOptions->lastValueCacheMaxSize()
+				  << "replay on subscribe:" << m_cliOptions->isLastValueCacheReplayOnSubscribe();
+		m_lastValueCache.reset(new LastValueCache(static_cast<size_t>(m_cliOptions->lastValueCacheMaxSize())));
+	}
 	std::srand(std::time(nullptr));
 #ifdef Q_OS_UNIX
 	//syslog (LOG_INFO, "Server started");
@@ -859,6 +864,9 @@ void BrokerApp::onClientLogin(int connection_id)
 			conn->setMountPoint(mount_point);
 			connect(cli_nd, &ClientShvNode::destroyed, this, [this, mount_point]() {
 				shvInfo() << "mounted node destroyed:" << mount_point;
+				// values of unmounted device are not valid any more
+				if(m_lastValueCache)
+					m_lastValueCache->removeTree(mount_point);
 				sendNotifyToSubscribers(mount_point, cp::Rpc::SIG_MOUNTED_CHANGED, false);
 			});
 			QTimer::singleShot(0, this, [this, connection_id]() {
@@ -1136,6 +1144,8 @@ void BrokerApp::onRpcDataReceived(int connection_id, shv::chainpack::Rpc::Protoc
 		else {
 			//logSigResolveD() << client_connection->connectionId() << "forwarding signal to client on mount point:" << mp << "as:" << full_shv_path;
 			cp::RpcMessage::setShvPath(meta, full_shv_path);
+			if(m_lastValueCache && client_connection && cp::RpcMessage::method(meta).asString() == cp::Rpc::SIG_VAL_CHANGED)
+				m_lastValueCache->update(full_shv_path, meta, data);
 			bool sig_sent = sendNotifyToSubscribers(meta, data);
 			if(!sig_sent && client_connection && client_connection->isSlaveBrokerConnection()) {
 				logSubscriptionsD() << "Rejecting unsubscribed signal, shv_path:" << full_shv_path << "method:" << cp::RpcMessage::method(meta).asString();
@@ -1279,6 +1289,7 @@ void BrokerApp::addSubscription(int client_id, const std::string &shv_path, cons
 		}
 	}
 	else {
+		replayLastValues(client_id, subs);
 		/// check slave broker connections
 		/// whether this subsciption should be propagated to them
 		/// skip service providers subscriptions, since it does not make ense to send them downstream
@@ -1291,6 +1302,23 @@ void BrokerApp::addSubscription(int client_id, const std::string &shv_path, cons
 	}
 }
 
+void BrokerApp::replayLastValues(int client_id, const rpc::CommonRpcClientHandle::Subscription &subs)
+{
+	if(!m_lastValueCache || !cliOptions()->isLastValueCacheReplayOnSubscribe())
+		return;
+	if(!(subs.method.empty() || subs.method == cp::Rpc::SIG_VAL_CHANGED))
+		return;
+	/// slave broker subscriptions are propagated ones, its clients get replay from their own broker
+	rpc::ClientConnectionOnBroker *conn = clientConnectionById(client_id);
+	if(!conn || conn->isSlaveBrokerConnection())
+		return;
+	m_lastValueCache->forEachInTree(subs.localPath, [conn, &subs](const std::string &shv_path, const LastValueCache::Entry &entry) {
+		cp::RpcValue::MetaData md(entry.metaData);
+		cp::RpcMessage::setShvPath(md, conn->toSubscribedPath(subs, shv_path));
+		conn->sendRawData(md, std::string(entry.data));
+	});
+}
+
 bool BrokerApp::removeSubscription(int client_id, const std::string &shv_path, const std::string &method)
 {
 	rpc::CommonRpcClientHandle *conn = commonClientConnectionById(client_id);
@@ -14,7 +14,9 @@ inline unsigned qHash(const std::string &s) noexcept //Q_DECL_NOEXCEPT_EXPR(noex
 #include "shvbrokerglobal.h"
 #include "appclioptions.h"
 #include "tunnelsecretlist.h"
+#include "lastvaluecache.h"
 #include "aclmanager.h"
+#include "rpc/commonrpcclienthandle.h"
 
 #include <shv/iotqt/node/shvnode.h>
 
@@ -23,6 +25,7 @@ inline unsigned qHash(const std::string &s) noexcept //Q_DECL_NOEXCEPT_EXPR(noex
 #include <QCoreApplication>
 #include <QDateTime>
 
+#include <memory>
 #include <set>
 
 class QSocketNotifier;
@@ -98,6 +101,8 @@ public:
 
 	const std::string& brokerId() const { return m_brokerId; }
 	iotqt::node::ShvNode * nodeForService(const shv::core::utils::ShvUrl &spp);
+	/// nullptr if last value cache is not enabled
+	LastValueCache* lastValueCache() { return m_lastValueCache.get(); }
 protected:
 	virtual void initDbConfigSqlConnection();
 	virtual AclManager* createAclManager();
@@ -135,6 +140,8 @@ private:
 	std::string primaryIPAddress(bool &is_public);
 
 	void propagateSubscriptionsToMasterBroker(rpc::MasterBrokerConnection *mbrconn);
+	/// send retained chng signals matching new subscription to client
+	void replayLastValues(int client_id, const rpc::CommonRpcClientHandle::Subscription &subs);
 protected:
 	AppCliOptions *m_cliOptions;
 	std::string m_brokerId;
@@ -146,6 +153,7 @@ protected:
 #endif
 	shv::iotqt::node::ShvNodeTree *m_nodesTree = nullptr;
 	TunnelSecretList m_tunnelSecretList;
+	std::unique_ptr<LastValueCache> m_lastValueCache;
 #ifdef USE_SHV_PATHS_GRANTS_CACHE
 	using PathGrantCache = QCache<std::string, shv::chainpack::Rpc::AccessGrant>;
 	using UserPathGrantCache = QCache<std::string, PathGrantCache>;
@@ -1,6 +1,7 @@
 #include "brokerappnode.h"
 
 #include "brokerapp.h"
+#include "lastvaluecache.h"
 #include "rpc/clientconnectiononbroker.h"
 #include "rpc/masterbrokerconnection.h"
 
@@ -10,6 +11,7 @@
 #include <shv/core/exception.h>
 #include <shv/core/stringview.h>
 #include <shv/core/log.h>
+#include <shv/core/utils/shvurl.h>
 #include <shv/iotqt/rpc/rpcresponsecallback.h>
 
 #include <QTimer>
@@ -76,6 +78,7 @@ static const char M_APP_VERSION[] = "appVersion";
 static const char M_GIT_COMMIT[] = "gitCommit";
 static const char M_BROKER_ID[] = "brokerId";
 static const char M_MASTER_BROKER_ID[] = "masterBrokerId";
+static const char M_LAST_VALUES[] = "lastValues";
 
 BrokerAppNode::BrokerAppNode(shv::iotqt::node::ShvNode *parent)
 	: Super("", &m_metaMethods, parent)
@@ -91,6 +94,7 @@ BrokerAppNode::BrokerAppNode(shv::iotqt::node::ShvNode *parent)
 		{cp::Rpc::METH_SUBSCRIBE, cp::MetaMethod::Signature::RetParam, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_READ},
 		{cp::Rpc::METH_UNSUBSCRIBE, cp::MetaMethod::Signature::RetParam, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_READ},
 		{cp::Rpc::METH_REJECT_NOT_SUBSCRIBED, cp::MetaMethod::Signature::RetParam, 0, cp::Rpc::ROLE_READ},
+		{M_LAST_VALUES, cp::MetaMethod::Signature::RetParam, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_READ},
 		{M_RELOAD_CONFIG, cp::MetaMethod::Signature::VoidVoid, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_SERVICE},
 		{M_RESTART, cp::MetaMethod::Signature::VoidVoid, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_SERVICE},
 	}
@@ -128,6 +132,22 @@ chainpack::RpcValue BrokerAppNode::callMethodRq(const chainpack::RpcRequest &rq)
 			int client_id = rq.peekCallerId();
 			return BrokerApp::instance()->rejectNotSubscribedSignal(client_id, path, method);
 		}
+		if(method == M_LAST_VALUES) {
+			LastValueCache *cache = BrokerApp::instance()->lastValueCache();
+			if(!cache)
+				SHV_EXCEPTION("Last value cache is not enabled.");
+			rpc::CommonRpcClientHandle *conn = BrokerApp::instance()->commonClientConnectionById(rq.peekCallerId());
+			if(!conn)
+				SHV_EXCEPTION("Invalid client id: " + std::to_string(rq.peekCallerId()));
+			cp::RpcValue::Map ret;
+			for(const auto &kv : cache->values(rq.params().asString())) {
+				// pattern can select paths with different ACL than .broker/app has
+				cp::AccessGrant acg = BrokerApp::instance()->accessGrantForRequest(conn, shv::core::utils::ShvUrl(kv.first), cp::Rpc::METH_GET, cp::RpcValue());
+				if(shv::iotqt::node::ShvNode::basicGrantToAccessLevel(acg.toRpcValue()) >= cp::MetaMethod::AccessLevel::Read)
+					ret[kv.first] = kv.second;
+			}
+			return ret;
+		}
 		if (method == M_MASTER_BROKER_ID) {
 			int client_id = rq.peekCallerId();
 			auto *conn = BrokerApp::instance()->masterBrokerConnectionForClient(client_id);
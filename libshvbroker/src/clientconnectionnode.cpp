@@ -4,6 +4,7 @@
 
 #include <shv/chainpack/metamethod.h>
 #include <shv/chainpack/rpc.h>
+#include <shv/chainpack/rpcdriver.h>
 
 namespace cp = shv::chainpack;
 
@@ -17,6 +18,17 @@ static const char M_USER_ROLES[] = "userRoles";
 static const char M_USER_PROFILE[] = "userProfile";
 static const char M_IDLE_TIME[] = "idleTime";
 static const char M_IDLE_TIME_MAX[] = "idleTimeMax";
+static const char M_COMPRESSION_STATS[] = "compressionStats";
+
+static cp::RpcValue compression_stats_to_rpcvalue(const cp::RpcDriver::CompressionStats &stats)
+{
+	return cp::RpcValue::Map {
+		{"frameCount", stats.frameCount},
+		{"rawBytes", stats.rawBytes},
+		{"compressedBytes", stats.compressedBytes},
+		{"ratio", stats.ratio()},
+	};
+}
 
 //=================================================================================
 // MasterBrokerConnectionNode
@@ -31,6 +43,7 @@ static std::vector<cp::MetaMethod> meta_methods {
 	{M_DROP_CLIENT, cp::MetaMethod::Signature::VoidVoid, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_SERVICE},
 	{M_IDLE_TIME, cp::MetaMethod::Signature::RetVoid, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_SERVICE, "Connection inactivity time in msec."},
 	{M_IDLE_TIME_MAX, cp::MetaMethod::Signature::RetVoid, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_SERVICE, "Maximum connection inactivity time in msec, before it is closed by server."},
+	{M_COMPRESSION_STATS, cp::MetaMethod::Signature::RetVoid, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_SERVICE, "Frame compression negotiated with client and sent/received compressed frames statistics."},
 };
 
 ClientConnectionNode::ClientConnectionNode(int client_id, shv::iotqt::node::ShvNode *parent)
@@ -89,6 +102,17 @@ shv::chainpack::RpcValue ClientConnectionNode::callMethod(const shv::iotqt::node
 				return cli->idleTimeMax();
 			SHV_EXCEPTION("Invalid client id: " + std::to_string(m_clientId));
 		}
+		if(method == M_COMPRESSION_STATS) {
+			rpc::ClientConnectionOnBroker *cli = BrokerApp::instance()->clientById(m_clientId);
+			if(cli) {
+				return cp::RpcValue::Map {
+					{"compression", cp::Rpc::compressionTypeToString(cli->sendCompression())},
+					{"sent", compression_stats_to_rpcvalue(cli->sentCompressionStats())},
+					{"received", compression_stats_to_rpcvalue(cli->receivedCompressionStats())},
+				};
+			}
+			SHV_EXCEPTION("Invalid client id: " + std::to_string(m_clientId));
+		}
 		if(method == M_DROP_CLIENT) {
 			rpc::ClientConnectionOnBroker *cli = BrokerApp::instance()->clientById(m_clientId);
 			if(cli) {
@@ -0,0 +1,86 @@
+#include "lastvaluecache.h"
+
+#include <shv/chainpack/rpcdriver.h>
+#include <shv/chainpack/rpcmessage.h>
+#include <shv/core/log.h>
+#include <shv/core/stringview.h>
+#include <shv/core/utils/shvpath.h>
+
+namespace cp = shv::chainpack;
+
+namespace shv {
+namespace broker {
+
+namespace {
+bool is_in_tree(const std::string &path, const std::string &tree_path)
+{
+	return tree_path.empty()
+			|| (path.size() == tree_path.size())
+			|| (path.size() > tree_path.size() && path[tree_path.size()] == '/');
+}
+}
+
+void LastValueCache::update(const std::string &shv_path, const chainpack::RpcValue::MetaData &meta_data, const std::string &data)
+{
+	auto it = m_entries.find(shv_path);
+	if(it == m_entries.end()) {
+		if(m_entries.size() >= m_maxSize) {
+			if(!m_fullWarningLogged) {
+				shvWarning() << "Last value cache is full, max size:" << m_maxSize << "new paths will not be cached.";
+				m_fullWarningLogged = true;
+			}
+			return;
+		}
+		it = m_entries.emplace(shv_path, Entry()).first;
+	}
+	it->second.metaData = cp::RpcValue::MetaData(meta_data);
+	// assignment reuses string capacity, chng data are mostly of the same size
+	it->second.data = data;
+}
+
+void LastValueCache::removeTree(const std::string &shv_path)
+{
+	// paths of the tree are sorted right after the tree root, mixed with siblings like 'a/b-c' only
+	auto it = m_entries.lower_bound(shv_path);
+	while(it != m_entries.end() && it->first.compare(0, shv_path.size(), shv_path) == 0) {
+		if(is_in_tree(it->first, shv_path))
+			it = m_entries.erase(it);
+		else
+			++it;
+	}
+	if(m_entries.size() < m_maxSize)
+		m_fullWarningLogged = false;
+}
+
+void LastValueCache::forEachInTree(const std::string &shv_path, const EntryCallback &callback) const
+{
+	for(auto it = m_entries.lower_bound(shv_path); it != m_entries.end() && it->first.compare(0, shv_path.size(), shv_path) == 0; ++it) {
+		if(is_in_tree(it->first, shv_path))
+			callback(it->first, it->second);
+	}
+}
+
+chainpack::RpcValue::Map LastValueCache::values(const std::string &path_pattern) const
+{
+	using ShvPath = shv::core::utils::ShvPath;
+	const shv::core::StringViewList pattern_lst = ShvPath::splitPath(path_pattern);
+	// only subtree of pattern part without wildcards has to be searched
+	std::string tree_path;
+	for(const shv::core::StringView &dir : pattern_lst) {
+		if(dir.indexOf('*') >= 0)
+			break;
+		if(!tree_path.empty())
+			tree_path += '/';
+		tree_path += dir.toString();
+	}
+	cp::RpcValue::Map ret;
+	forEachInTree(tree_path, [&](const std::string &shv_path, const Entry &entry) {
+		if(!pattern_lst.empty() && !ShvPath::matchWild(ShvPath::splitPath(shv_path), pattern_lst))
+			return;
+		cp::RpcValue msg = cp::RpcDriver::decodeData(cp::RpcMessage::protocolType(entry.metaData), entry.data, 0);
+		ret[shv_path] = msg.asIMap().value(cp::RpcMessage::MetaType::Key::Params);
+	});
+	return ret;
+}
+
+}}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "shvbrokerglobal.h"
+
+#include <shv/chainpack/rpc.h>
+#include <shv/chainpack/rpcvalue.h>
+
+#include <functional>
+#include <map>
+#include <string>
+
+namespace shv {
+namespace broker {
+
+/// Last chng signal seen for every shv path, signals are retained as they were received (meta data + packed data),
+/// so they can be replayed to new subscribers without re-encoding.
+class SHVBROKER_DECL_EXPORT LastValueCache
+{
+public:
+	struct Entry
+	{
+		shv::chainpack::RpcValue::MetaData metaData;
+		std::string data;
+	};
+	using EntryCallback = std::function<void (const std::string &shv_path, const Entry &entry)>;
+public:
+	explicit LastValueCache(size_t max_size) : m_maxSize(max_size) {}
+
+	/// signal for path not cached yet is ignored if cache is full
+	void update(const std::string &shv_path, const shv::chainpack::RpcValue::MetaData &meta_data, const std::string &data);
+	/// remove shv_path and all its children, when device is unmounted for example
+	void removeTree(const std::string &shv_path);
+	/// call callback for shv_path and all its children
+	void forEachInTree(const std::string &shv_path, const EntryCallback &callback) const;
+	/// @return Map shv_path -> last chng signal params for paths matching ShvPath::matchWild() pattern, empty pattern matches all paths
+	shv::chainpack::RpcValue::Map values(const std::string &path_pattern) const;
+
+	size_t size() const {return m_entries.size();}
+	size_t maxSize() const {return m_maxSize;}
+private:
+	std::map<std::string, Entry> m_entries;
+	size_t m_maxSize;
+	bool m_fullWarningLogged = false;
+};
+
+}}
@@ -44,6 +44,8 @@ void MasterBrokerConnection::setOptions(const shv::chainpack::RpcValue &slave_br
 			device_opts.setHeartBeatInterval(rpc.value("heartbeatInterval", 60).toInt());
 		if(rpc.count("reconnectInterval") == 1)
 			device_opts.setReconnectInterval(rpc.value("reconnectInterval").toInt());
+		if(rpc.count("compression") == 1)
+			device_opts.setCompression(rpc.value("compression").asString());
 
 		const cp::RpcValue::Map &device = m.value(cp::Rpc::KEY_DEVICE).toMap();
 		if(device.count("id") == 1)
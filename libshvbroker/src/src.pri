@@ -12,6 +12,7 @@ HEADERS += \
     $$PWD/clientconnectionnode.h \
     $$PWD/clientshvnode.h \
     $$PWD/tunnelsecretlist.h \
+    $$PWD/lastvaluecache.h \
     $$PWD/brokerrootnode.h
 
 SOURCES += \
@@ -26,6 +27,7 @@ SOURCES += \
     $$PWD/clientconnectionnode.cpp \
     $$PWD/clientshvnode.cpp \
     $$PWD/tunnelsecretlist.cpp \
+    $$PWD/lastvaluecache.cpp \
     $$PWD/brokerrootnode.cpp
 
 include ($$PWD/rpc/rpc.pri)
@@ -162,9 +162,59 @@ static int bytes_needed(int bit_len)
                     n == 15 -> for future (number of bytes will be specified in next byte)
 */
 
+static inline uint64_t load_be64(const uint8_t *p)
+{
+#if defined __GNUC__ && defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	uint64_t n;
+	memcpy(&n, p, sizeof(n));
+	return __builtin_bswap64(n);
+#elif defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	uint64_t n;
+	memcpy(&n, p, sizeof(n));
+	return n;
+#else
+	uint64_t n = 0;
+	int i;
+	for (i = 0; i < 8; ++i)
+		n = (n << 8) | p[i];
+	return n;
+#endif
+}
+
+static inline void store_be64(uint8_t *p, uint64_t n)
+{
+#if defined __GNUC__ && defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	n = __builtin_bswap64(n);
+	memcpy(p, &n, sizeof(n));
+#elif defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	memcpy(p, &n, sizeof(n));
+#else
+	int i;
+	for (i = 7; i >= 0; --i) {
+		p[i] = (uint8_t)n;
+		n >>= 8;
+	}
+#endif
+}
+
 static void pack_uint_data_helper(ccpcp_pack_context* pack_context, uint64_t num, int bit_len)
 {
 	int byte_cnt = bytes_needed(bit_len);
+	if(byte_cnt <= 8 && pack_context->err_no == CCPCP_RC_OK && pack_context->end - pack_context->current >= 8) {
+		// fast path, whole number is written by single 8 bytes store
+		int head_shift = (byte_cnt - 1) * 8;
+		uint8_t head;
+		if(bit_len <= 28)
+			head = (uint8_t)(((num >> head_shift) & (0x7f >> (byte_cnt - 1))) | (0xff00 >> (byte_cnt - 1)));
+		else
+			head = (uint8_t)(0xf0 | (byte_cnt - 5));
+		num &= ~((uint64_t)0xff << head_shift);
+		num |= (uint64_t)head << head_shift;
+		store_be64((uint8_t*)pack_context->current, num << (64 - byte_cnt * 8));
+		pack_context->current += byte_cnt;
+		return;
+	}
+
 	uint8_t bytes[byte_cnt];
 	int i;
 	for (i = byte_cnt-1; i >= 0; --i) {
@@ -479,12 +529,51 @@ void cchainpack_pack_cstring_finish (ccpcp_pack_context* pack_context)
 
 //============================   U N P A C K   =================================
 
+// number of leading 1 bits in byte
+static inline int leading_ones_cnt(uint8_t b)
+{
+#if defined(__GNUC__) && __GNUC__ >= 4
+	return __builtin_clz(((unsigned)(uint8_t)~b << 24) | 0x800000);
+#else
+	int n = 0;
+	for (; n < 8 && (b & 0x80); n++)
+		b <<= 1;
+	return n;
+#endif
+}
+
 /// @pbitlen is used to enable same function usage for signed int unpacking
 static void unpack_uint(ccpcp_unpack_context* unpack_context, uint64_t *pval, int *pbitlen)
 {
 	uint64_t num = 0;
 	int bitlen = 0;
 
+	if(unpack_context->end - unpack_context->current >= 9) {
+		// fast path, whole number is in the buffer, it can be read by single 8 bytes load
+		const uint8_t *s = (const uint8_t*)unpack_context->current;
+		uint8_t head = s[0];
+		int ones_cnt = leading_ones_cnt(head);
+		int bytes_to_read_cnt = (ones_cnt < 4)? ones_cnt: (head & 0xf) + 4;
+		if(bytes_to_read_cnt <= 8) {
+			uint64_t tail = load_be64(s + 1);
+			if(ones_cnt < 4) {
+				num = (uint64_t)(head & (0x7f >> ones_cnt)) << (bytes_to_read_cnt * 8);
+				num |= (tail >> 1) >> (63 - bytes_to_read_cnt * 8);
+				bitlen = 7 + 7 * bytes_to_read_cnt;
+			}
+			else {
+				num = tail >> (64 - bytes_to_read_cnt * 8);
+				bitlen = bytes_to_read_cnt * 8;
+			}
+			unpack_context->current += 1 + bytes_to_read_cnt;
+			if(pval)
+				*pval = num;
+			if(pbitlen)
+				*pbitlen = bitlen;
+			return;
+		}
+	}
+
 	const char *p;
 	UNPACK_TAKE_BYTE();
 	uint8_t head = *p;
@@ -14,6 +14,7 @@
 #include "ccpcp.h"
 
 #include <string.h>
+#include <stdlib.h>
 
 
 #ifdef BR_PLC
@@ -335,6 +336,8 @@ bool ccpcp_item_is_map_val(ccpcp_unpack_context *unpack_context)
 
 double ccpcp_exponentional_to_double(int64_t const mantisa, const int exponent, const int base)
 {
+	if(base == 10)
+		return ccpcp_decimal_to_double(mantisa, exponent);
 	double d = mantisa;
 	int i;
 	for (i = 0; i < exponent; ++i)
@@ -346,7 +349,43 @@ double ccpcp_exponentional_to_double(int64_t const mantisa, const int exponent,
 
 double ccpcp_decimal_to_double(const int64_t mantisa, const int exponent)
 {
-	return ccpcp_exponentional_to_double(mantisa, exponent, 10);
+	// powers of ten exactly representable in double
+	static const double exact_pow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+	static const int max_exact_exp = (int)(sizeof(exact_pow10) / sizeof(exact_pow10[0])) - 1;
+	uint64_t m = (mantisa < 0)? -(uint64_t)mantisa: (uint64_t)mantisa;
+	if(m <= (1ULL << 53) && exponent >= -max_exact_exp && exponent <= max_exact_exp) {
+		// both mantisa and power of ten are exact, single IEEE operation gives correctly rounded result
+		double d = (double)m;
+		if(exponent < 0)
+			d /= exact_pow10[-exponent];
+		else
+			d *= exact_pow10[exponent];
+		return (mantisa < 0)? -d: d;
+	}
+	if(m == 0)
+		return 0;
+	// rare case, let strtod() to do correct rounding, string contains no locale dependent characters
+	char buff[48];
+	char *p = buff + sizeof(buff);
+	unsigned e = (exponent < 0)? -(unsigned)exponent: (unsigned)exponent;
+	*--p = '\0';
+	do {
+		*--p = (char)('0' + e % 10);
+		e /= 10;
+	} while(e);
+	if(exponent < 0)
+		*--p = '-';
+	*--p = 'e';
+	do {
+		*--p = (char)('0' + m % 10);
+		m /= 10;
+	} while(m);
+	if(mantisa < 0)
+		*--p = '-';
+	return strtod(p, NULL);
 }
 
 static int int_to_str(char *buff, size_t buff_len, int64_t val)
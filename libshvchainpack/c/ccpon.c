@@ -4,6 +4,90 @@
 //#include <stdio.h>
 #include <math.h>
 
+#ifndef CCPON_NO_SIMD
+#if defined __AVX2__
+#define CCPON_SIMD_AVX2
+#include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define CCPON_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined __ARM_NEON || defined __ARM_NEON__
+#define CCPON_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+static inline size_t ctz32(uint32_t n)
+{
+#if defined __GNUC__
+	return (size_t)__builtin_ctz(n);
+#else
+	size_t i = 0;
+	while(!(n & 1)) {
+		n >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+/*
+ * Returns number of leading bytes of buff which can be copied verbatim,
+ * the plain byte is not equal to c1 or c2 and lies in <lo, hi> range.
+ * Bytes are checked in 32 (AVX2) or 16 (SSE2, NEON) bytes long blocks, the rest is checked byte by byte.
+ */
+static inline size_t scan_plain_bytes(const char *buff, size_t len, uint8_t c1, uint8_t c2, uint8_t lo, uint8_t hi)
+{
+	const uint8_t *p = (const uint8_t*)buff;
+	size_t i = 0;
+#if defined CCPON_SIMD_AVX2
+	const __m256i v_c1 = _mm256_set1_epi8((char)c1);
+	const __m256i v_c2 = _mm256_set1_epi8((char)c2);
+	const __m256i v_lo = _mm256_set1_epi8((char)lo);
+	const __m256i v_hi = _mm256_set1_epi8((char)hi);
+	for (; i + 32 <= len; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+		__m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(v, v_c1), _mm256_cmpeq_epi8(v, v_c2));
+		__m256i in_range = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(v, v_lo), v), _mm256_cmpeq_epi8(_mm256_min_epu8(v, v_hi), v));
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(special) | ~(uint32_t)_mm256_movemask_epi8(in_range);
+		if(mask)
+			return i + ctz32(mask);
+	}
+#elif defined CCPON_SIMD_SSE2
+	const __m128i v_c1 = _mm_set1_epi8((char)c1);
+	const __m128i v_c2 = _mm_set1_epi8((char)c2);
+	const __m128i v_lo = _mm_set1_epi8((char)lo);
+	const __m128i v_hi = _mm_set1_epi8((char)hi);
+	for (; i + 16 <= len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+		__m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, v_c1), _mm_cmpeq_epi8(v, v_c2));
+		__m128i in_range = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, v_lo), v), _mm_cmpeq_epi8(_mm_min_epu8(v, v_hi), v));
+		uint32_t mask = ((uint32_t)_mm_movemask_epi8(special) | ~(uint32_t)_mm_movemask_epi8(in_range)) & 0xffff;
+		if(mask)
+			return i + ctz32(mask);
+	}
+#elif defined CCPON_SIMD_NEON
+	const uint8x16_t v_c1 = vdupq_n_u8(c1);
+	const uint8x16_t v_c2 = vdupq_n_u8(c2);
+	const uint8x16_t v_lo = vdupq_n_u8(lo);
+	const uint8x16_t v_hi = vdupq_n_u8(hi);
+	for (; i + 16 <= len; i += 16) {
+		uint8x16_t v = vld1q_u8(p + i);
+		uint8x16_t in_range = vandq_u8(vcgeq_u8(v, v_lo), vcleq_u8(v, v_hi));
+		uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(v, v_c1), vceqq_u8(v, v_c2)), vmvnq_u8(in_range));
+		uint64x2_t mask = vreinterpretq_u64_u8(special);
+		if(vgetq_lane_u64(mask, 0) | vgetq_lane_u64(mask, 1))
+			break; // find exact position in scalar loop
+	}
+#endif
+	for (; i < len; ++i) {
+		uint8_t b = p[i];
+		if(b == c1 || b == c2 || b < lo || b > hi)
+			break;
+	}
+	return i;
+}
+
 /*
 static inline int is_octal(uint8_t b)
 {
@@ -82,23 +166,6 @@ static size_t uint_to_str_lpad(char *buff, size_t buff_len, uint64_t n, size_t w
 	return len;
 }
 
-static size_t uint_dot_uint_to_str(char *buff, size_t buff_len, uint64_t n1, uint64_t n2)
-{
-	size_t len = uint_to_str(buff, buff_len, n1);
-	if(len < buff_len)
-		buff[len] = '.';
-	size_t dot_pos = len;
-	len++;
-	if(n2 > 0) {
-		len += uint_to_str(buff+len, (len < buff_len)? buff_len-len: 0, n2);
-		if(len < buff_len) {
-			// remove trailing zeros
-			for(; len>dot_pos && buff[len-1] == '0'; len--);
-		}
-	}
-	return len;
-}
-
 static size_t int_to_str(char *buff, size_t buff_len, int64_t n)
 {
 	size_t len = 0;
@@ -114,14 +181,240 @@ static size_t int_to_str(char *buff, size_t buff_len, int64_t n)
 	return len;
 }
 
-static size_t double_to_str(char *buff, size_t buff_len, double d)
+/*
+ * Round-trip double to decimal digits conversion, Grisu2 algorithm
+ * output is usually the shortest one, but not for about 0.1% of inputs, it always reads back to the same double
+ * see Florian Loitsch: Printing Floating-Point Numbers Quickly and Accurately with Integers
+ */
+typedef struct {
+	uint64_t f;
+	int e;
+} diy_fp;
+
+#define DIY_SIGNIFICAND_SIZE 64
+#define DP_SIGNIFICAND_SIZE 52
+#define DP_EXPONENT_BIAS (0x3FF + DP_SIGNIFICAND_SIZE)
+#define DP_MIN_EXPONENT (-DP_EXPONENT_BIAS)
+#define DP_EXPONENT_MASK 0x7FF0000000000000ULL
+#define DP_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define DP_HIDDEN_BIT 0x0010000000000000ULL
+
+static const uint64_t pow10_u64[] = {
+	1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+	10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+	1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+	10000000000000000000ULL,
+};
+
+static diy_fp diy_fp_from_double(double d)
+{
+	uint64_t u;
+	memcpy(&u, &d, sizeof(u));
+	int biased_e = (int)((u & DP_EXPONENT_MASK) >> DP_SIGNIFICAND_SIZE);
+	uint64_t significand = u & DP_SIGNIFICAND_MASK;
+	diy_fp ret;
+	if (biased_e != 0) {
+		ret.f = significand + DP_HIDDEN_BIT;
+		ret.e = biased_e - DP_EXPONENT_BIAS;
+	}
+	else {
+		ret.f = significand;
+		ret.e = DP_MIN_EXPONENT + 1;
+	}
+	return ret;
+}
+
+static diy_fp diy_fp_mul(diy_fp x, diy_fp y)
+{
+	diy_fp ret;
+#if defined __SIZEOF_INT128__
+	unsigned __int128 p = (unsigned __int128)x.f * y.f;
+	ret.f = (uint64_t)(p >> 64);
+	if((uint64_t)p & (1ULL << 63))
+		ret.f++; // round
+#else
+	const uint64_t M32 = 0xFFFFFFFF;
+	uint64_t a = x.f >> 32, b = x.f & M32;
+	uint64_t c = y.f >> 32, d = y.f & M32;
+	uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+	uint64_t tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+	tmp += 1U << 31; // round
+	ret.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+#endif
+	ret.e = x.e + y.e + 64;
+	return ret;
+}
+
+static diy_fp diy_fp_normalize(diy_fp d)
+{
+#if defined __GNUC__
+	int s = __builtin_clzll(d.f);
+	d.f <<= s;
+	d.e -= s;
+#else
+	while (!(d.f & (1ULL << 63))) {
+		d.f <<= 1;
+		d.e--;
+	}
+#endif
+	return d;
+}
+
+static void diy_fp_normalized_boundaries(diy_fp v, diy_fp *minus, diy_fp *plus)
+{
+	diy_fp pl = {(v.f << 1) + 1, v.e - 1};
+	while (!(pl.f & (DP_HIDDEN_BIT << 1))) {
+		pl.f <<= 1;
+		pl.e--;
+	}
+	pl.f <<= DIY_SIGNIFICAND_SIZE - DP_SIGNIFICAND_SIZE - 2;
+	pl.e -= DIY_SIGNIFICAND_SIZE - DP_SIGNIFICAND_SIZE - 2;
+	diy_fp mi;
+	if(v.f == DP_HIDDEN_BIT) {
+		mi.f = (v.f << 2) - 1;
+		mi.e = v.e - 2;
+	}
+	else {
+		mi.f = (v.f << 1) - 1;
+		mi.e = v.e - 1;
+	}
+	mi.f <<= mi.e - pl.e;
+	mi.e = pl.e;
+	*plus = pl;
+	*minus = mi;
+}
+
+/// 10^k, k = -348, -340, ..., 340
+static diy_fp cached_power(int e, int *K)
+{
+	static const uint64_t cached_powers_f[] = {
+	0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+	0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+	0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+	0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+	0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+	0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+	0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+	0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+	0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+	0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+	0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+	0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+	0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+	0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+	0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+	0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+	0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+	0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+	0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+	0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+	0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+	0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+	};
+	static const int16_t cached_powers_e[] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+	-954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+	-688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+	-422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+	-157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+	109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+	641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+	907, 933, 960, 986, 1013, 1039, 1066
+	};
+	double dk = (-61 - e) * 0.30102999566398114 + 347; // dk must be positive
+	int k = (int)dk;
+	if (dk - k > 0.0)
+		k++;
+	unsigned index = (unsigned)((k >> 3) + 1);
+	*K = -(-348 + (int)(index * 8)); // decimal exponent, no need for lookup table
+	diy_fp ret = {cached_powers_f[index], cached_powers_e[index]};
+	return ret;
+}
+
+static void grisu_round(char *buff, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w)
+{
+	while (rest < wp_w && delta - rest >= ten_kappa
+		   && (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+		buff[len - 1]--;
+		rest += ten_kappa;
+	}
+}
+
+static int count_decimal_digits_32(uint32_t n)
 {
-	const int prec = 6;
-	unsigned prec_num = 1;
 	int i;
-	for (i = 0; i < prec; ++i)
-		prec_num *= 10;
+	for (i = 1; i < 10; ++i) {
+		if(n < pow10_u64[i])
+			return i;
+	}
+	return 10;
+}
+
+static void grisu_digit_gen(diy_fp w, diy_fp mp, uint64_t delta, char *buff, int *len, int *K)
+{
+	const diy_fp one = {1ULL << -mp.e, mp.e};
+	const uint64_t wp_w = mp.f - w.f;
+	uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+	uint64_t p2 = mp.f & (one.f - 1);
+	int kappa = count_decimal_digits_32(p1);
+	*len = 0;
+
+	while (kappa > 0) {
+		uint32_t div = (uint32_t)pow10_u64[kappa - 1];
+		uint32_t d = p1 / div;
+		p1 %= div;
+		if (d || *len)
+			buff[(*len)++] = (char)('0' + d);
+		kappa--;
+		uint64_t tmp = ((uint64_t)p1 << -one.e) + p2;
+		if (tmp <= delta) {
+			*K += kappa;
+			grisu_round(buff, *len, delta, tmp, pow10_u64[kappa] << -one.e, wp_w);
+			return;
+		}
+	}
+	// kappa = 0
+	for (;;) {
+		p2 *= 10;
+		delta *= 10;
+		char d = (char)(p2 >> -one.e);
+		if (d || *len)
+			buff[(*len)++] = (char)('0' + d);
+		p2 &= one.f - 1;
+		kappa--;
+		if (p2 < delta) {
+			*K += kappa;
+			int index = -kappa;
+			grisu_round(buff, *len, delta, p2, one.f, wp_w * (index < 20 ? pow10_u64[index] : 0));
+			return;
+		}
+	}
+}
+
+/*
+ * Writes round-trip (usually shortest) digits sequence of positive d to buff (at least 17 bytes long),
+ * d == digits * 10^K
+ */
+static int grisu2(double d, char *buff, int *K)
+{
+	diy_fp v = diy_fp_from_double(d);
+	diy_fp w_m, w_p;
+	diy_fp_normalized_boundaries(v, &w_m, &w_p);
+
+	const diy_fp c_mk = cached_power(w_p.e, K);
+	const diy_fp W = diy_fp_mul(diy_fp_normalize(v), c_mk);
+	diy_fp Wp = diy_fp_mul(w_p, c_mk);
+	diy_fp Wm = diy_fp_mul(w_m, c_mk);
+	Wm.f++;
+	Wp.f--;
+	int len;
+	grisu_digit_gen(W, Wp, Wp.f - Wm.f, buff, &len, K);
+	return len;
+}
 
+static size_t double_to_str(char *buff, size_t buff_len, double d)
+{
 	size_t len = 0;
 	if(d == 0) {
 		if(len < buff_len)
@@ -130,70 +423,59 @@ static size_t double_to_str(char *buff, size_t buff_len, double d)
 		if(len < buff_len)
 			buff[len] = '.';
 		len++;
+		return len;
 	}
-	else {
-		bool neg = d < 0;
-		if(neg) {
+	if(d < 0) {
+		if(len < buff_len)
+			buff[len] = '-';
+		len++;
+		d = -d;
+	}
+	char digits[24];
+	int K;
+	int n = grisu2(d, digits, &K);
+	// position of decimal point in digits
+	int dot_pos = n + K;
+	int i;
+	if(dot_pos >= 0 && dot_pos <= 7) {
+		/// float point notation, 0.1 <= d < 1e7
+		if(dot_pos == 0) {
 			if(len < buff_len)
-				buff[len] = '-';
+				buff[len] = '0';
 			len++;
-			d = -d;
 		}
-		if(d < 1e7 && d >= 0.1) {
-			/// float point notation
-			if(d < 1) {
-				for ( i = 0; i < prec; ++i)
-					d *= 10;
-				unsigned ud = (unsigned)d;
-				len += uint_dot_uint_to_str(buff + len, (len < buff_len)? buff_len-len: 0, 0, ud);
-			}
-			else {
-				int exp = 0;
-				double myprec = 1;
-				while(d >= 10) {
-					d /= 10;
-					myprec /= 10;
-					exp++;
-				}
-				for ( i = 0; i < prec; ++i) {
-					d *= 10;
-					myprec *= 10;
-				}
-				unsigned ud = (unsigned)d;
-				unsigned myprecnum = (unsigned)myprec;
-				len += uint_dot_uint_to_str(buff + len, (len < buff_len)? buff_len-len: 0, ud/myprecnum, ud%myprecnum);
+		for (i = 0; i < n || i < dot_pos; ++i) {
+			if(i == dot_pos) {
+				if(len < buff_len)
+					buff[len] = '.';
+				len++;
 			}
+			if(len < buff_len)
+				buff[len] = (i < n)? digits[i]: '0';
+			len++;
 		}
-		else {
-			/// exponential notation
-			int exp = 0;
-			if(d < 1) {
-				while(d < 1) {
-					d *= 10;
-					exp--;
-				}
-				for ( i = 0; i < prec; ++i)
-					d *= 10;
-				unsigned ud = (unsigned)d;
-				len += uint_dot_uint_to_str(buff + len, (len < buff_len)? buff_len-len: 0, ud/prec_num, ud%prec_num);
-			}
-			else {
-				while(d >= 10) {
-					d /= 10;
-					exp++;
-				}
-				for ( i = 0; i < prec; ++i)
-					d *= 10;
-				unsigned ud = (unsigned)d;
-				len += uint_dot_uint_to_str(buff + len, (len < buff_len)? buff_len-len: 0, ud/prec_num, ud%prec_num);
+		if(dot_pos >= n) {
+			if(len < buff_len)
+				buff[len] = '.';
+			len++;
+		}
+	}
+	else {
+		/// exponential notation
+		for (i = 0; i < n; ++i) {
+			if(i == 1) {
+				if(len < buff_len)
+					buff[len] = '.';
+				len++;
 			}
-			if(len < buff_len && buff[len-1] == '.') // remove trailing dot
-				len--;
 			if(len < buff_len)
-				buff[len] = 'e';
+				buff[len] = digits[i];
 			len++;
-			len += int_to_str(buff + len, (len < buff_len)? buff_len-len: 0, exp);
 		}
+		if(len < buff_len)
+			buff[len] = 'e';
+		len++;
+		len += int_to_str(buff + len, (len < buff_len)? buff_len-len: 0, dot_pos - 1);
 	}
 	return len;
 }
@@ -646,11 +928,18 @@ void ccpon_pack_meta_end(ccpcp_pack_context *pack_context, bool is_oneliner)
 
 static char* copy_data_escaped(ccpcp_pack_context* pack_context, const void* str, size_t len)
 {
-	size_t i;
-	for (i = 0; i < len; ++i) {
+	size_t i = 0;
+	while (i < len) {
 		if(pack_context->err_no != CCPCP_RC_OK)
 			return NULL;
-		uint8_t ch = ((const uint8_t*)str)[i];
+		// chars '\0', '\b', '\t', '\n', '\r' are all < 14
+		size_t plain_len = scan_plain_bytes((const char*)str + i, len - i, '\\', '"', 14, 255);
+		if(plain_len > 0) {
+			ccpcp_pack_copy_bytes(pack_context, (const char*)str + i, plain_len);
+			i += plain_len;
+			continue;
+		}
+		uint8_t ch = ((const uint8_t*)str)[i++];
 		switch(ch) {
 		case '\0':
 			ccpcp_pack_copy_byte(pack_context, '\\');
@@ -689,11 +978,17 @@ static char* copy_data_escaped(ccpcp_pack_context* pack_context, const void* str
 
 static char* copy_blob_escaped(ccpcp_pack_context* pack_context, const void* str, size_t len)
 {
-	size_t i;
-	for (i = 0; i < len; ++i) {
+	size_t i = 0;
+	while (i < len) {
 		if(pack_context->err_no != CCPCP_RC_OK)
 			return NULL;
-		uint8_t ch = ((const uint8_t*)str)[i];
+		size_t plain_len = scan_plain_bytes((const char*)str + i, len - i, '\\', '"', 32, 126);
+		if(plain_len > 0) {
+			ccpcp_pack_copy_bytes(pack_context, (const char*)str + i, plain_len);
+			i += plain_len;
+			continue;
+		}
+		uint8_t ch = ((const uint8_t*)str)[i++];
 		switch(ch) {
 		case '\\':
 			ccpcp_pack_copy_byte(pack_context, '\\');
@@ -783,6 +1078,12 @@ void ccpon_pack_string_finish (ccpcp_pack_context* pack_context)
 const char* ccpon_unpack_skip_insignificant(ccpcp_unpack_context* unpack_context)
 {
 	while(1) {
+		// skip blanks which are already in unpack buffer
+		while(unpack_context->current < unpack_context->end && *unpack_context->current <= ' ') {
+			if(*unpack_context->current == '\n')
+				unpack_context->parser_line_no++;
+			unpack_context->current++;
+		}
 		const char* p = ccpcp_unpack_take_byte(unpack_context);
 		if(!p)
 			return p;
@@ -883,6 +1184,15 @@ static int unpack_int(ccpcp_unpack_context* unpack_context, int64_t *p_val)
 		case '9':
 			val *= base;
 			val += b - '0';
+			if(base == 10) {
+				// take rest of decimal digits which are already in unpack buffer
+				const char *q = unpack_context->current;
+				while(q < unpack_context->end && *q >= '0' && *q <= '9') {
+					val = val * 10 + (*q++ - '0');
+					n++;
+				}
+				unpack_context->current = q;
+			}
 			break;
 		case 'a':
 		case 'b':
@@ -1107,6 +1417,28 @@ static void ccpon_unpack_blob_hex(ccpcp_unpack_context* unpack_context)
 	it->chunk_cnt++;
 }
 
+/*
+ * Copies run of plain bytes, which are already in unpack buffer, to the string chunk.
+ * Returns number of bytes copied.
+ */
+static size_t copy_plain_bytes(ccpcp_unpack_context* unpack_context, uint8_t c1, uint8_t c2, uint8_t lo, uint8_t hi)
+{
+	ccpcp_string *it = &unpack_context->item.as.String;
+	size_t len = (size_t)(unpack_context->end - unpack_context->current);
+	size_t chunk_rest = it->chunk_buff_len - it->chunk_size;
+	if(len > chunk_rest)
+		len = chunk_rest;
+	if(len == 0)
+		return 0;
+	size_t plain_len = scan_plain_bytes(unpack_context->current, len, c1, c2, lo, hi);
+	if(plain_len > 0) {
+		memcpy(it->chunk_start + it->chunk_size, unpack_context->current, plain_len);
+		it->chunk_size += plain_len;
+		unpack_context->current += plain_len;
+	}
+	return plain_len;
+}
+
 static void ccpon_unpack_blob_esc(ccpcp_unpack_context* unpack_context)
 {
 	if(unpack_context->item.type != CCPCP_ITEM_BLOB)
@@ -1122,6 +1454,9 @@ static void ccpon_unpack_blob_esc(ccpcp_unpack_context* unpack_context)
 		}
 	}
 	for(it->chunk_size = 0; it->chunk_size < it->chunk_buff_len; ) {
+		size_t plain_len = copy_plain_bytes(unpack_context, '"', '\\', 0, 127);
+		if(plain_len > 0)
+			continue;
 		UNPACK_TAKE_BYTE();
 		uint8_t b = *p;
 		if (b == '"') {
@@ -1175,6 +1510,9 @@ static void ccpon_unpack_string(ccpcp_unpack_context* unpack_context)
 		}
 	}
 	for(it->chunk_size = 0; it->chunk_size < it->chunk_buff_len; ) {
+		size_t plain_len = copy_plain_bytes(unpack_context, '"', '\\', 0, 255);
+		if(plain_len > 0)
+			continue;
 		UNPACK_TAKE_BYTE();
 		if(*p == '\\') {
 			UNPACK_TAKE_BYTE();
@@ -20,6 +20,12 @@ DEFINES += SHV_ANDROID_BUILD
 
 DEFINES += SHVCHAINPACK_BUILD_DLL
 
+with-shvzlib {
+	message("$$PWD" with zlib frame compression)
+	DEFINES += WITH_SHV_ZLIB
+	LIBS += -lz
+}
+
 INCLUDEPATH += \
     $$SHV_PROJECT_TOP_SRCDIR/3rdparty/necrolog/include
 
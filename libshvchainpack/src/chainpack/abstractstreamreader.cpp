@@ -1,17 +1,44 @@
 #include "abstractstreamreader.h"
 
+#include <algorithm>
+
 namespace shv {
 namespace chainpack {
 
+namespace {
+class StreamBufAccess : public std::streambuf
+{
+public:
+	static char* getAreaBegin(std::streambuf *sb) { return (sb->*(&StreamBufAccess::gptr))(); }
+	static char* getAreaEnd(std::streambuf *sb) { return (sb->*(&StreamBufAccess::egptr))(); }
+	static void consume(std::streambuf *sb, int n) { (sb->*(&StreamBufAccess::gbump))(n); }
+};
+}
+
 size_t unpack_underflow_handler(ccpcp_unpack_context *ctx)
 {
 	AbstractStreamReader *rd = reinterpret_cast<AbstractStreamReader*>(ctx->custom_context);
-	int c = rd->m_in.get();
-	if(c < 0 || rd->m_in.eof()) {
-		// id directory is open then c == -1 but eof() == false, strange
+	rd->syncInputStream();
+	std::streambuf *sb = rd->m_in.rdbuf();
+	if(!sb || !rd->m_in.good())
 		return 0;
+	if(sb->sgetc() == std::streambuf::traits_type::eof()) {
+		// id directory is open then sgetc() == eof
+		rd->m_in.setstate(std::ios::eofbit | std::ios::failbit);
+		return 0;
+	}
+	char *begin = StreamBufAccess::getAreaBegin(sb);
+	char *end = StreamBufAccess::getAreaEnd(sb);
+	if(begin < end) {
+		// let C parser see all the buffered data, not only single byte
+		rd->m_unpackingStreamBuffer = true;
+		ctx->start = begin;
+		ctx->current = ctx->start;
+		ctx->end = end;
+		return (size_t)(end - begin);
 	}
-	rd->m_unpackBuff[0] = (char)c;
+	// unbuffered stream
+	rd->m_unpackBuff[0] = (char)sb->sbumpc();
 	ctx->start = rd->m_unpackBuff;
 	ctx->current = ctx->start;
 	ctx->end = ctx->start + 1;
@@ -35,6 +62,28 @@ AbstractStreamReader::AbstractStreamReader(std::istream &in)
 
 AbstractStreamReader::~AbstractStreamReader()
 {
+	syncInputStream();
+}
+
+void AbstractStreamReader::syncInputStream()
+{
+	if(!m_unpackingStreamBuffer)
+		return;
+	m_unpackingStreamBuffer = false;
+	if(m_inCtx.current > m_inCtx.start)
+		StreamBufAccess::consume(m_in.rdbuf(), (int)(m_inCtx.current - m_inCtx.start));
+	m_inCtx.start = m_unpackBuff;
+	m_inCtx.current = m_inCtx.start;
+	m_inCtx.end = m_inCtx.start;
+}
+
+size_t AbstractStreamReader::stringReserveSize(const ccpcp_string *it)
+{
+	constexpr size_t MAX_RESERVE = 64 * 1024;
+	if(it->string_size <= 0)
+		return 0;
+	const size_t string_size = static_cast<size_t>(it->string_size);
+	return std::min(string_size, std::max(it->chunk_size, MAX_RESERVE));
 }
 
 RpcValue AbstractStreamReader::read(std::string *error)
@@ -52,6 +101,7 @@ RpcValue AbstractStreamReader::read(std::string *error)
 	else {
 		read(ret);
 	}
+	syncInputStream();
 	return ret;
 }
 
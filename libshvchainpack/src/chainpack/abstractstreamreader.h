@@ -33,9 +33,17 @@ public:
 
 	virtual void read(RpcValue::MetaData &meta_data) = 0;
 	virtual void read(RpcValue &val) = 0;
+protected:
+	/// Unpack context can point directly to the stream buffer get area,
+	/// consumed bytes must be removed from stream before stream position can be used.
+	void syncInputStream();
+	/// string size is read from the wire, do not let it preallocate more than the first chunk or 64 kB,
+	/// appending following chunks grows the buffer when the data really comes
+	static size_t stringReserveSize(const ccpcp_string *it);
 protected:
 	std::istream &m_in;
 	char m_unpackBuff[1];
+	bool m_unpackingStreamBuffer = false;
 	//static constexpr size_t CONTAINER_STATE_CNT = 100;
 	//ccpcp_container_state m_containerStates[CONTAINER_STATE_CNT];
 	//ccpcp_container_stack m_containerStack;
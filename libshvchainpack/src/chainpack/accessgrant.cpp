@@ -90,6 +90,8 @@ RpcValue UserLoginResult::toRpcValue() const
 	if(passwordOk) {
 		if(clientId > 0)
 			m["clientId"] = clientId;
+		if(compression != Rpc::CompressionType::None)
+			m[Rpc::OPT_COMPRESSION] = Rpc::compressionTypeToString(compression);
 	}
 	return RpcValue(std::move(m));
 }
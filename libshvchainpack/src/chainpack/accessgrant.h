@@ -3,6 +3,7 @@
 #include "../shvchainpackglobal.h"
 
 #include "metamethod.h"
+#include "rpc.h"
 #include "rpcmessage.h"
 #include "rpcvalue.h"
 
@@ -28,6 +29,8 @@ struct SHVCHAINPACK_DECL_EXPORT UserLoginResult
 	std::string loginError;
 	int clientId = 0;
 	std::string brokerId;
+	/// frame compression accepted by server, client requests it in login options
+	Rpc::CompressionType compression = Rpc::CompressionType::None;
 
 	UserLoginResult() {}
 	UserLoginResult(bool password_ok) : UserLoginResult(password_ok, std::string()) {}
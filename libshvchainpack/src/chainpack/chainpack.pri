@@ -3,6 +3,7 @@ SOURCES += \
     $$PWD/rpc.cpp \
     $$PWD/rpcmessage.cpp \
     $$PWD/rpcvalue.cpp \
+    $$PWD/rpcvaluearena.cpp \
     $$PWD/rpcdriver.cpp \
     $$PWD/metatypes.cpp \
     $$PWD/exception.cpp \
@@ -16,6 +17,7 @@ SOURCES += \
     $$PWD/chainpack.cpp \
     $$PWD/chainpackreader.cpp \
     $$PWD/chainpackreader1.cpp \
+    $$PWD/pullreader.cpp \
     $$PWD/metamethod.cpp \
     $$PWD/tunnelctl.cpp \
     $$PWD/irpcconnection.cpp \
@@ -27,6 +29,8 @@ HEADERS += \
     $$PWD/rpc.h \
     $$PWD/rpcmessage.h \
     $$PWD/rpcvalue.h \
+    $$PWD/flatmap.h \
+    $$PWD/rpcvaluearena.h \
     $$PWD/rpcdriver.h \
     $$PWD/metatypes.h \
     $$PWD/exception.h \
@@ -40,6 +44,7 @@ HEADERS += \
     $$PWD/chainpack.h \
     $$PWD/chainpackreader1.h \
     $$PWD/chainpackreader.h \
+    $$PWD/pullreader.h \
     $$PWD/metamethod.h \
     $$PWD/tunnelctl.h \
     $$PWD/irpcconnection.h \
@@ -9,6 +9,7 @@ namespace shv {
 namespace chainpack {
 
 #define PARSE_EXCEPTION(msg) {\
+	syncInputStream(); \
 	char buff[40]; \
 	int l = m_in.readsome(buff, sizeof(buff) - 1); \
 	buff[l] = 0; \
@@ -112,7 +113,18 @@ void ChainPackReader::read(RpcValue &val)
 	read(md);
 
 	unpackNext();
+	readItem(val);
 
+	if(!md.isEmpty()) {
+		if(!val.isValid())
+			PARSE_EXCEPTION("Attempt to set metadata to invalid RPC value.");
+		val.setMetaData(std::move(md));
+	}
+	syncInputStream();
+}
+
+void ChainPackReader::readItem(RpcValue &val)
+{
 	switch(m_inCtx.item.type) {
 	case CCPCP_ITEM_INVALID: {
 		// end of input
@@ -138,22 +150,16 @@ void ChainPackReader::read(RpcValue &val)
 		break;
 	}
 	case CCPCP_ITEM_STRING: {
-		ccpcp_string *it = &(m_inCtx.item.as.String);
 		std::string str;
-		while(m_inCtx.item.type == CCPCP_ITEM_STRING) {
-			str += std::string(it->chunk_start, it->chunk_size);
-			if(it->last_chunk)
-				break;
-			unpackNext();
-			if(m_inCtx.item.type != CCPCP_ITEM_STRING)
-				PARSE_EXCEPTION("Unfinished string");
-		}
-		val = str;
+		readString(str);
+		val = RpcValue(std::move(str));
 		break;
 	}
 	case CCPCP_ITEM_BLOB: {
 		ccpcp_string *it = &(m_inCtx.item.as.String);
 		RpcValue::Blob blob;
+		if(it->string_size > 0)
+			blob.reserve(stringReserveSize(it));
 		while(m_inCtx.item.type == CCPCP_ITEM_BLOB) {
 			blob.insert(blob.end(), it->chunk_start, it->chunk_start + it->chunk_size);
 			if(it->last_chunk)
@@ -162,7 +168,7 @@ void ChainPackReader::read(RpcValue &val)
 			if(m_inCtx.item.type != CCPCP_ITEM_BLOB)
 				PARSE_EXCEPTION("Unfinished blob");
 		}
-		val = blob;
+		val = RpcValue(std::move(blob));
 		break;
 	}
 	case CCPCP_ITEM_BOOLEAN: {
@@ -194,13 +200,38 @@ void ChainPackReader::read(RpcValue &val)
 	default:
 		PARSE_EXCEPTION("Invalid type.");
 	}
-	if(!md.isEmpty()) {
-		if(!val.isValid())
-			PARSE_EXCEPTION("Attempt to set metadata to invalid RPC value.");
-		val.setMetaData(std::move(md));
+}
+
+void ChainPackReader::readString(std::string &str)
+{
+	ccpcp_string *it = &(m_inCtx.item.as.String);
+	str.clear();
+	// string_size is known for CP_String, it is -1 for CP_CString
+	if(it->string_size > 0)
+		str.reserve(stringReserveSize(it));
+	while(m_inCtx.item.type == CCPCP_ITEM_STRING) {
+		str.append(it->chunk_start, it->chunk_size);
+		if(it->last_chunk)
+			break;
+		unpackNext();
+		if(m_inCtx.item.type != CCPCP_ITEM_STRING)
+			PARSE_EXCEPTION("Unfinished string");
 	}
 }
 
+bool ChainPackReader::unpackKey()
+{
+	// key meta data are not supported by RpcValue maps, skip them
+	RpcValue::MetaData md;
+	read(md);
+	unpackNext();
+	if(m_inCtx.item.type == CCPCP_ITEM_CONTAINER_END) {
+		m_inCtx.item.type = CCPCP_ITEM_INVALID;
+		return false;
+	}
+	return true;
+}
+
 void ChainPackReader::parseList(RpcValue &val)
 {
 	RpcValue::List lst;
@@ -211,71 +242,91 @@ void ChainPackReader::parseList(RpcValue &val)
 			m_inCtx.item.type = CCPCP_ITEM_INVALID;
 			break;
 		}
-		lst.push_back(v);
+		lst.push_back(std::move(v));
 	}
-	val = lst;
+	val = RpcValue(std::move(lst));
 }
 
 void ChainPackReader::parseMetaData(RpcValue::MetaData &meta_data)
 {
+	std::string skey;
 	while (true) {
-		RpcValue key;
-		read(key);
-		if(m_inCtx.item.type == CCPCP_ITEM_CONTAINER_END) {
-			m_inCtx.item.type = CCPCP_ITEM_INVALID;
+		if(!unpackKey())
 			break;
+		if(m_inCtx.item.type == CCPCP_ITEM_STRING) {
+			readString(skey);
+			RpcValue val;
+			read(val);
+			meta_data.setValue(skey, val);
+		}
+		else {
+			RpcValue::Int ikey = readIntKey();
+			RpcValue val;
+			read(val);
+			meta_data.setValue(ikey, val);
 		}
-		RpcValue val;
-		read(val);
-		if(key.isString())
-			meta_data.setValue(key.asString(), val);
-		else
-			meta_data.setValue(key.toInt(), val);
+	}
+}
+
+RpcValue::Int ChainPackReader::readIntKey()
+{
+	switch(m_inCtx.item.type) {
+	case CCPCP_ITEM_INT:
+		return static_cast<RpcValue::Int>(m_inCtx.item.as.Int);
+	case CCPCP_ITEM_UINT:
+		return static_cast<RpcValue::Int>(m_inCtx.item.as.UInt);
+	default: {
+		RpcValue key;
+		readItem(key);
+		return key.toInt();
+	}
 	}
 }
 
 void ChainPackReader::parseMap(RpcValue &val)
 {
 	RpcValue::Map map;
+	std::string key;
 	while (true) {
-		RpcValue key;
-		read(key);
-		if(m_inCtx.item.type == CCPCP_ITEM_CONTAINER_END) {
-			m_inCtx.item.type = CCPCP_ITEM_INVALID;
+		if(!unpackKey())
 			break;
+		if(m_inCtx.item.type == CCPCP_ITEM_STRING) {
+			readString(key);
 		}
-		RpcValue val;
-		read(val);
-		map[key.asString()] = val;
+		else {
+			RpcValue k;
+			readItem(k);
+			key = k.asString();
+		}
+		RpcValue v;
+		read(v);
+		map[std::move(key)] = std::move(v);
 	}
-	val = map;
+	val = RpcValue(std::move(map));
 }
 
 void ChainPackReader::parseIMap(RpcValue &val)
 {
 	RpcValue::IMap map;
 	while (true) {
-		RpcValue key;
-		read(key);
-		if(m_inCtx.item.type == CCPCP_ITEM_CONTAINER_END) {
-			m_inCtx.item.type = CCPCP_ITEM_INVALID;
+		if(!unpackKey())
 			break;
-		}
-		RpcValue val;
-		read(val);
-		map[key.toInt()] = val;
+		RpcValue::Int key = readIntKey();
+		RpcValue v;
+		read(v);
+		map[key] = std::move(v);
 	}
-	val = map;
+	val = RpcValue(std::move(map));
 }
 
 void ChainPackReader::read(RpcValue::MetaData &meta_data)
 {
-	const uint8_t *b = (const uint8_t*)ccpcp_unpack_take_byte(&m_inCtx);
-	m_inCtx.current--;
+	const uint8_t *b = (const uint8_t*)ccpcp_unpack_peek_byte(&m_inCtx);
 	if(b && *b == CP_MetaMap) {
 		cchainpack_unpack_next(&m_inCtx);
 		parseMetaData(meta_data);
 	}
+	syncInputStream();
 }
 
 } // namespace chainpack
@@ -29,6 +29,12 @@ public:
 	ItemType unpackNext();
 	static const char* itemTypeToString(ItemType it);
 private:
+	/// decodes item already unpacked in m_inCtx
+	void readItem(RpcValue &val);
+	void readString(std::string &str);
+	/// unpacks next map key, returns false on container end
+	bool unpackKey();
+	RpcValue::Int readIntKey();
 	void parseList(RpcValue &val);
 	void parseMetaData(RpcValue::MetaData &meta_data);
 	void parseMap(RpcValue &val);
@@ -10,6 +10,7 @@ namespace shv {
 namespace chainpack {
 
 #define PARSE_EXCEPTION(msg) {\
+	syncInputStream(); \
 	char buff[40]; \
 	int l = m_in.readsome(buff, sizeof(buff) - 1); \
 	buff[l] = 0; \
@@ -189,6 +190,7 @@ void CponReader::read(RpcValue &val)
 			PARSE_EXCEPTION(std::string("Attempt to set metadata to invalid RPC value. error - ") + m_inCtx.err_msg);
 		val.setMetaData(std::move(md));
 	}
+	syncInputStream();
 }
 
 RpcValue CponReader::readFile(const std::string &file_name, std::string *error)
@@ -303,11 +305,13 @@ void CponReader::parseIMap(RpcValue &val)
 void CponReader::read(RpcValue::MetaData &meta_data)
 {
 	const char *c = ccpon_unpack_skip_insignificant(&m_inCtx);
-	m_inCtx.current--;
+	if(c)
+		m_inCtx.current--;
 	if(c && *c == '<') {
 		ccpon_unpack_next(&m_inCtx);
 		parseMetaData(meta_data);
 	}
+	syncInputStream();
 }
 
 } // namespace chainpack
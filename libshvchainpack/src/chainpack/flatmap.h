@@ -0,0 +1,166 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace shv {
+namespace chainpack {
+
+/// Associative container with std::map like API keeping its items in a vector sorted by key.
+/// Most of maps in RPC messages have just a few items, sorted vector stores them in single allocation
+/// and looks them up without pointer chasing. Iteration order is the same as std::map one.
+/// Unlike std::map, insertion and erasure invalidate iterators and references to the items.
+template<typename Key, typename T, typename Compare = std::less<Key>>
+class FlatMap
+{
+public:
+	using key_type = Key;
+	using mapped_type = T;
+	using value_type = std::pair<Key, T>;
+	using key_compare = Compare;
+	using size_type = size_t;
+	using difference_type = ptrdiff_t;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using iterator = typename std::vector<value_type>::iterator;
+	using const_iterator = typename std::vector<value_type>::const_iterator;
+	using reverse_iterator = typename std::vector<value_type>::reverse_iterator;
+	using const_reverse_iterator = typename std::vector<value_type>::const_reverse_iterator;
+public:
+	FlatMap() = default;
+	FlatMap(std::initializer_list<value_type> items) { insert(items.begin(), items.end()); }
+	template<typename InputIt>
+	FlatMap(InputIt first, InputIt last) { insert(first, last); }
+
+	iterator begin() {return m_items.begin();}
+	iterator end() {return m_items.end();}
+	const_iterator begin() const {return m_items.begin();}
+	const_iterator end() const {return m_items.end();}
+	const_iterator cbegin() const {return m_items.cbegin();}
+	const_iterator cend() const {return m_items.cend();}
+	reverse_iterator rbegin() {return m_items.rbegin();}
+	reverse_iterator rend() {return m_items.rend();}
+	const_reverse_iterator rbegin() const {return m_items.rbegin();}
+	const_reverse_iterator rend() const {return m_items.rend();}
+
+	bool empty() const {return m_items.empty();}
+	size_type size() const {return m_items.size();}
+	size_type max_size() const {return m_items.max_size();}
+	size_type capacity() const {return m_items.capacity();}
+	void reserve(size_type n) {m_items.reserve(n);}
+	void shrink_to_fit() {m_items.shrink_to_fit();}
+	void clear() {m_items.clear();}
+	void swap(FlatMap &o) {m_items.swap(o.m_items);}
+
+	iterator lower_bound(const Key &key) {return lowerBound(m_items.begin(), m_items.end(), key);}
+	const_iterator lower_bound(const Key &key) const {return lowerBound(m_items.begin(), m_items.end(), key);}
+	iterator upper_bound(const Key &key) {return std::upper_bound(m_items.begin(), m_items.end(), key, ItemLess());}
+	const_iterator upper_bound(const Key &key) const {return std::upper_bound(m_items.begin(), m_items.end(), key, ItemLess());}
+	iterator find(const Key &key)
+	{
+		auto it = lower_bound(key);
+		return (it == end() || Compare()(key, it->first))? end(): it;
+	}
+	const_iterator find(const Key &key) const
+	{
+		auto it = lower_bound(key);
+		return (it == end() || Compare()(key, it->first))? end(): it;
+	}
+	size_type count(const Key &key) const {return find(key) == end()? 0: 1;}
+
+	T& at(const Key &key)
+	{
+		auto it = find(key);
+		if(it == end())
+			throw std::out_of_range("FlatMap::at");
+		return it->second;
+	}
+	const T& at(const Key &key) const
+	{
+		auto it = find(key);
+		if(it == end())
+			throw std::out_of_range("FlatMap::at");
+		return it->second;
+	}
+	T& operator[](const Key &key) {return tryEmplace(key).first->second;}
+	T& operator[](Key &&key) {return tryEmplace(std::move(key)).first->second;}
+
+	std::pair<iterator, bool> insert(const value_type &item) {return tryEmplace(item.first, item.second);}
+	std::pair<iterator, bool> insert(value_type &&item) {return tryEmplace(std::move(item.first), std::move(item.second));}
+	iterator insert(const_iterator, const value_type &item) {return insert(item).first;}
+	iterator insert(const_iterator, value_type &&item) {return insert(std::move(item)).first;}
+	template<typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for(; first != last; ++first)
+			insert(value_type(*first));
+	}
+	void insert(std::initializer_list<value_type> items) { insert(items.begin(), items.end()); }
+	template<typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {return insert(value_type(std::forward<Args>(args)...));}
+	template<typename... Args>
+	iterator emplace_hint(const_iterator, Args&&... args) {return emplace(std::forward<Args>(args)...).first;}
+
+	iterator erase(const_iterator pos) {return m_items.erase(pos);}
+	iterator erase(const_iterator first, const_iterator last) {return m_items.erase(first, last);}
+	size_type erase(const Key &key)
+	{
+		auto it = find(key);
+		if(it == end())
+			return 0;
+		m_items.erase(it);
+		return 1;
+	}
+
+	friend bool operator==(const FlatMap &a, const FlatMap &b) {return a.m_items == b.m_items;}
+	friend bool operator!=(const FlatMap &a, const FlatMap &b) {return !(a == b);}
+private:
+	struct ItemLess
+	{
+		bool operator()(const value_type &item, const Key &key) const {return Compare()(item.first, key);}
+		bool operator()(const Key &key, const value_type &item) const {return Compare()(key, item.first);}
+	};
+
+	template<typename It>
+	static It lowerBound(It first, It last, const Key &key)
+	{
+		// linear scan of few integer keys is faster than bisection, string keys are compared as few times as possible
+		if(!std::is_arithmetic<Key>::value || last - first > LINEAR_SEARCH_MAX_SIZE)
+			return std::lower_bound(first, last, key, ItemLess());
+		while(first != last && Compare()(first->first, key))
+			++first;
+		return first;
+	}
+	template<typename K, typename... Args>
+	std::pair<iterator, bool> tryEmplace(K &&key, Args&&... args)
+	{
+		// maps are mostly built from data serialized in key order, try append first
+		iterator it = (m_items.empty() || Compare()(m_items.back().first, key))? m_items.end(): lower_bound(key);
+		if(it != m_items.end() && !Compare()(key, it->first))
+			return std::make_pair(it, false);
+		if(m_items.capacity() == 0) {
+			m_items.reserve(INITIAL_CAPACITY);
+			it = m_items.end();
+		}
+		it = m_items.emplace(it, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return std::make_pair(it, true);
+	}
+private:
+	static constexpr size_type INITIAL_CAPACITY = 4;
+	static constexpr difference_type LINEAR_SEARCH_MAX_SIZE = 8;
+	std::vector<value_type> m_items;
+};
+
+template<typename Key, typename T, typename Compare>
+constexpr typename FlatMap<Key, T, Compare>::size_type FlatMap<Key, T, Compare>::INITIAL_CAPACITY;
+template<typename Key, typename T, typename Compare>
+constexpr typename FlatMap<Key, T, Compare>::difference_type FlatMap<Key, T, Compare>::LINEAR_SEARCH_MAX_SIZE;
+
+} // namespace chainpack
+} // namespace shv
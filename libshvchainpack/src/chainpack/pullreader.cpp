@@ -0,0 +1,389 @@
+#include "pullreader.h"
+#include "../../c/cchainpack.h"
+#include "../../c/ccpon.h"
+
+namespace shv {
+namespace chainpack {
+
+//===========================================================
+// PullReader::Cursor
+//===========================================================
+PullReader::Cursor::Cursor(PullReader &reader)
+	: m_reader(reader)
+{
+	if(m_reader.event() == Event::MetaBegin) {
+		m_reader.skipContainer();
+		m_reader.next();
+	}
+	m_containerEvent = m_reader.event();
+	if(m_containerEvent != Event::ListBegin && m_containerEvent != Event::MapBegin && m_containerEvent != Event::IMapBegin)
+		m_reader.throwParseException("Cursor can be created on container begin only");
+	m_depth = m_reader.depth();
+}
+
+bool PullReader::Cursor::next()
+{
+	if(m_atEnd)
+		return false;
+	// skip rest of previous item if it was not read completely
+	while(m_reader.depth() > m_depth)
+		m_reader.next();
+	Event e = m_reader.next();
+	if(m_containerEvent != Event::ListBegin && e != Event::ContainerEnd) {
+		m_reader.skipKeyMetaData();
+		if(m_reader.event() != Event::Key)
+			m_reader.throwParseException("Map key expected");
+		if(m_containerEvent == Event::MapBegin)
+			m_key = m_reader.type() == RpcValue::Type::String? m_reader.toString(): std::string();
+		else
+			m_intKey = static_cast<RpcValue::Int>(m_reader.toInt64());
+		e = m_reader.next();
+	}
+	if(e == Event::MetaBegin) {
+		m_reader.skipContainer();
+		e = m_reader.next();
+	}
+	if(e == Event::ContainerEnd) {
+		m_atEnd = true;
+		return false;
+	}
+	m_index++;
+	return true;
+}
+
+//===========================================================
+// PullReader
+//===========================================================
+PullReader::PullReader(std::istream &in, Format format)
+	: Super(in)
+	, m_format(format)
+{
+	m_item.type = CCPCP_ITEM_INVALID;
+}
+
+void PullReader::throwParseException(const std::string &msg)
+{
+	syncInputStream();
+	throw ParseException(std::string(m_format == Format::ChainPack? "ChainPack ": "Cpon ") + msg + " at pos: " + std::to_string(m_in.tellg()), m_in.tellg());
+}
+
+void PullReader::unpackNext()
+{
+	if(m_format == Format::ChainPack)
+		cchainpack_unpack_next(&m_inCtx);
+	else
+		ccpon_unpack_next(&m_inCtx);
+	if(m_inCtx.err_no != CCPCP_RC_OK)
+		throwParseException("Parse error: " + std::to_string(m_inCtx.err_no) + " " + ccpcp_error_string(m_inCtx.err_no) + " - " + std::string(m_inCtx.err_msg));
+}
+
+void PullReader::readString(ccpcp_item_types type)
+{
+	ccpcp_string *it = &(m_inCtx.item.as.String);
+	m_string.clear();
+	if(it->string_size > 0)
+		m_string.reserve(stringReserveSize(it));
+	while(true) {
+		m_string.append(it->chunk_start, it->chunk_size);
+		if(it->last_chunk)
+			break;
+		unpackNext();
+		if(m_inCtx.item.type != type)
+			throwParseException("Unfinished string");
+	}
+}
+
+void PullReader::completeItem()
+{
+	if(m_containers.empty()) {
+		m_topLevelRead = true;
+		return;
+	}
+	Container &c = m_containers.back();
+	if(c.type != CCPCP_ITEM_LIST)
+		c.keyExpected = !c.keyExpected;
+}
+
+PullReader::Event PullReader::next()
+{
+	if(m_eventPending) {
+		m_eventPending = false;
+		return m_event;
+	}
+	if(m_topLevelRead) {
+		// End is reported once after each top level value, following call starts next value
+		m_topLevelRead = false;
+		m_event = Event::End;
+		return m_event;
+	}
+	unpackNext();
+	const bool is_key = !m_containers.empty() && m_containers.back().keyExpected;
+	const ccpcp_item_types type = m_inCtx.item.type;
+	switch(type) {
+	case CCPCP_ITEM_INVALID:
+		if(!m_containers.empty())
+			throwParseException("Unexpected end of input");
+		m_event = Event::End;
+		break;
+	case CCPCP_ITEM_META:
+		m_containers.push_back(Container{type, true});
+		m_event = Event::MetaBegin;
+		break;
+	case CCPCP_ITEM_LIST:
+	case CCPCP_ITEM_MAP:
+	case CCPCP_ITEM_IMAP:
+		if(is_key)
+			throwParseException("Container cannot be a map key");
+		m_containers.push_back(Container{type, type != CCPCP_ITEM_LIST});
+		m_event = type == CCPCP_ITEM_LIST? Event::ListBegin: type == CCPCP_ITEM_MAP? Event::MapBegin: Event::IMapBegin;
+		break;
+	case CCPCP_ITEM_CONTAINER_END: {
+		if(m_containers.empty())
+			throwParseException("Unexpected container end");
+		const ccpcp_item_types container_type = m_containers.back().type;
+		m_containers.pop_back();
+		// meta-data precede value, value position in parent container is not changed
+		if(container_type != CCPCP_ITEM_META)
+			completeItem();
+		m_event = Event::ContainerEnd;
+		break;
+	}
+	case CCPCP_ITEM_STRING:
+	case CCPCP_ITEM_BLOB:
+		readString(type);
+		m_item.type = type;
+		m_event = is_key? Event::Key: Event::Value;
+		completeItem();
+		break;
+	case CCPCP_ITEM_NULL:
+	case CCPCP_ITEM_BOOLEAN:
+	case CCPCP_ITEM_INT:
+	case CCPCP_ITEM_UINT:
+	case CCPCP_ITEM_DOUBLE:
+	case CCPCP_ITEM_DECIMAL:
+	case CCPCP_ITEM_DATE_TIME:
+		m_item = m_inCtx.item;
+		m_event = is_key? Event::Key: Event::Value;
+		completeItem();
+		break;
+	default:
+		throwParseException("Invalid type.");
+	}
+	if(m_event == Event::End)
+		syncInputStream();
+	return m_event;
+}
+
+RpcValue::Type PullReader::type() const
+{
+	if(m_event != Event::Key && m_event != Event::Value)
+		return RpcValue::Type::Invalid;
+	switch(m_item.type) {
+	case CCPCP_ITEM_NULL: return RpcValue::Type::Null;
+	case CCPCP_ITEM_BOOLEAN: return RpcValue::Type::Bool;
+	case CCPCP_ITEM_INT: return RpcValue::Type::Int;
+	case CCPCP_ITEM_UINT: return RpcValue::Type::UInt;
+	case CCPCP_ITEM_DOUBLE: return RpcValue::Type::Double;
+	case CCPCP_ITEM_DECIMAL: return RpcValue::Type::Decimal;
+	case CCPCP_ITEM_DATE_TIME: return RpcValue::Type::DateTime;
+	case CCPCP_ITEM_STRING: return RpcValue::Type::String;
+	case CCPCP_ITEM_BLOB: return RpcValue::Type::Blob;
+	default: return RpcValue::Type::Invalid;
+	}
+}
+
+bool PullReader::toBool() const
+{
+	switch(m_item.type) {
+	case CCPCP_ITEM_BOOLEAN: return m_item.as.Bool;
+	case CCPCP_ITEM_INT: return m_item.as.Int != 0;
+	case CCPCP_ITEM_UINT: return m_item.as.UInt != 0;
+	default: return false;
+	}
+}
+
+int64_t PullReader::toInt64() const
+{
+	switch(m_item.type) {
+	case CCPCP_ITEM_BOOLEAN: return m_item.as.Bool;
+	case CCPCP_ITEM_INT: return m_item.as.Int;
+	case CCPCP_ITEM_UINT: return static_cast<int64_t>(m_item.as.UInt);
+	case CCPCP_ITEM_DOUBLE: return static_cast<int64_t>(m_item.as.Double);
+	case CCPCP_ITEM_DECIMAL: return static_cast<int64_t>(toDecimal().toDouble());
+	default: return 0;
+	}
+}
+
+uint64_t PullReader::toUInt64() const
+{
+	return static_cast<uint64_t>(toInt64());
+}
+
+double PullReader::toDouble() const
+{
+	switch(m_item.type) {
+	case CCPCP_ITEM_INT: return static_cast<double>(m_item.as.Int);
+	case CCPCP_ITEM_UINT: return static_cast<double>(m_item.as.UInt);
+	case CCPCP_ITEM_DOUBLE: return m_item.as.Double;
+	case CCPCP_ITEM_DECIMAL: return toDecimal().toDouble();
+	default: return 0;
+	}
+}
+
+RpcValue::Blob PullReader::toBlob() const
+{
+	return RpcValue::Blob(m_string.begin(), m_string.end());
+}
+
+RpcValue::DateTime PullReader::toDateTime() const
+{
+	if(m_item.type != CCPCP_ITEM_DATE_TIME)
+		return RpcValue::DateTime();
+	return RpcValue::DateTime::fromMSecsSinceEpoch(m_item.as.DateTime.msecs_since_epoch, m_item.as.DateTime.minutes_from_utc);
+}
+
+RpcValue::Decimal PullReader::toDecimal() const
+{
+	if(m_item.type != CCPCP_ITEM_DECIMAL)
+		return RpcValue::Decimal();
+	return RpcValue::Decimal(m_item.as.Decimal.mantisa, m_item.as.Decimal.exponent);
+}
+
+RpcValue PullReader::scalarValue() const
+{
+	switch(type()) {
+	case RpcValue::Type::Null: return RpcValue(nullptr);
+	case RpcValue::Type::Bool: return RpcValue(m_item.as.Bool);
+	case RpcValue::Type::Int: return RpcValue(m_item.as.Int);
+	case RpcValue::Type::UInt: return RpcValue(m_item.as.UInt);
+	case RpcValue::Type::Double: return RpcValue(m_item.as.Double);
+	case RpcValue::Type::Decimal: return RpcValue(toDecimal());
+	case RpcValue::Type::DateTime: return RpcValue(toDateTime());
+	case RpcValue::Type::String: return RpcValue(m_string);
+	case RpcValue::Type::Blob: return RpcValue(toBlob());
+	default: return RpcValue();
+	}
+}
+
+RpcValue PullReader::readValue()
+{
+	switch(m_event) {
+	case Event::Key:
+	case Event::Value:
+		return scalarValue();
+	case Event::MetaBegin: {
+		RpcValue::MetaData md = readMetaData();
+		next();
+		RpcValue val = readValue();
+		if(!val.isValid())
+			throwParseException("Attempt to set metadata to invalid RPC value.");
+		val.setMetaData(std::move(md));
+		return val;
+	}
+	case Event::ListBegin: {
+		RpcValue::List lst;
+		while(next() != Event::ContainerEnd)
+			lst.push_back(readValue());
+		return RpcValue(std::move(lst));
+	}
+	case Event::MapBegin: {
+		RpcValue::Map map;
+		while(next() != Event::ContainerEnd) {
+			skipKeyMetaData();
+			std::string key = type() == RpcValue::Type::String? m_string: std::string();
+			next();
+			map[std::move(key)] = readValue();
+		}
+		return RpcValue(std::move(map));
+	}
+	case Event::IMapBegin: {
+		RpcValue::IMap map;
+		while(next() != Event::ContainerEnd) {
+			skipKeyMetaData();
+			RpcValue::Int key = static_cast<RpcValue::Int>(toInt64());
+			next();
+			map[key] = readValue();
+		}
+		return RpcValue(std::move(map));
+	}
+	default:
+		return RpcValue();
+	}
+}
+
+RpcValue::MetaData PullReader::readMetaData()
+{
+	RpcValue::MetaData md;
+	if(m_event != Event::MetaBegin)
+		return md;
+	while(next() != Event::ContainerEnd) {
+		skipKeyMetaData();
+		if(type() == RpcValue::Type::String) {
+			std::string key = m_string;
+			next();
+			md.setValue(key, readValue());
+		}
+		else {
+			RpcValue::Int key = static_cast<RpcValue::Int>(toInt64());
+			next();
+			md.setValue(key, readValue());
+		}
+	}
+	return md;
+}
+
+void PullReader::skipContainer()
+{
+	const size_t depth = m_containers.size();
+	while(m_containers.size() >= depth) {
+		if(next() == Event::End)
+			break;
+	}
+}
+
+void PullReader::skipKeyMetaData()
+{
+	if(m_event == Event::MetaBegin) {
+		skipContainer();
+		next();
+	}
+}
+
+void PullReader::skip()
+{
+	switch(m_event) {
+	case Event::MetaBegin:
+		skipContainer();
+		next();
+		skip();
+		break;
+	case Event::ListBegin:
+	case Event::MapBegin:
+	case Event::IMapBegin:
+		skipContainer();
+		break;
+	default:
+		break;
+	}
+}
+
+void PullReader::read(RpcValue::MetaData &meta_data)
+{
+	// every read() starts new top level value, like ChainPackReader does
+	m_topLevelRead = false;
+	if(next() == Event::MetaBegin)
+		meta_data = readMetaData();
+	else
+		m_eventPending = true;
+}
+
+void PullReader::read(RpcValue &val)
+{
+	if(!m_eventPending)
+		m_topLevelRead = false;
+	next();
+	val = readValue();
+}
+
+} // namespace chainpack
+} // namespace shv
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "abstractstreamreader.h"
+
+#include <vector>
+
+namespace shv {
+namespace chainpack {
+
+/// Event based reader of ChainPack or Cpon stream.
+/// Values are not assembled into RpcValue tree unless readValue() is called,
+/// so arbitrary large data, like getLog result, can be walked in constant memory.
+class SHVCHAINPACK_DECL_EXPORT PullReader : public AbstractStreamReader
+{
+	using Super = AbstractStreamReader;
+public:
+	enum class Format {ChainPack, Cpon};
+	enum class Event {
+		None,
+		MetaBegin,
+		ListBegin,
+		MapBegin,
+		IMapBegin,
+		ContainerEnd,
+		/// map, imap or meta-map key
+		Key,
+		/// scalar value
+		Value,
+		/// top level value was read completely
+		End,
+	};
+
+	/// Typed iteration over items of container the reader is positioned at.
+	/// Nested containers which are not read by user are skipped, item meta-data are skipped too.
+	class SHVCHAINPACK_DECL_EXPORT Cursor
+	{
+	public:
+		explicit Cursor(PullReader &reader);
+
+		/// moves reader to next item value, returns false on container end
+		bool next();
+		int index() const {return m_index;}
+		/// key of current Map item
+		const std::string& key() const {return m_key;}
+		/// key of current IMap item
+		RpcValue::Int intKey() const {return m_intKey;}
+		PullReader& reader() {return m_reader;}
+	private:
+		PullReader &m_reader;
+		size_t m_depth;
+		Event m_containerEvent;
+		int m_index = -1;
+		bool m_atEnd = false;
+		std::string m_key;
+		RpcValue::Int m_intKey = 0;
+	};
+public:
+	PullReader(std::istream &in, Format format = Format::ChainPack);
+
+	Event next();
+	Event event() const {return m_event;}
+	/// number of containers opened at current position
+	size_t depth() const {return m_containers.size();}
+
+	/// type of current Key or Value
+	RpcValue::Type type() const;
+	bool toBool() const;
+	int64_t toInt64() const;
+	uint64_t toUInt64() const;
+	double toDouble() const;
+	/// String or Blob data
+	const std::string& toString() const {return m_string;}
+	RpcValue::Blob toBlob() const;
+	RpcValue::DateTime toDateTime() const;
+	RpcValue::Decimal toDecimal() const;
+	RpcValue scalarValue() const;
+
+	/// reads value starting at current event into RpcValue tree
+	RpcValue readValue();
+	/// reads meta-data when positioned at MetaBegin, next() returns the value meta-data belong to
+	RpcValue::MetaData readMetaData();
+	/// skips value starting at current event including its meta-data
+	void skip();
+
+	using Super::read;
+	void read(RpcValue::MetaData &meta_data) override;
+	void read(RpcValue &val) override;
+private:
+	void unpackNext();
+	void readString(ccpcp_item_types type);
+	void completeItem();
+	void skipContainer();
+	void skipKeyMetaData();
+	[[noreturn]] void throwParseException(const std::string &msg);
+private:
+	struct Container
+	{
+		ccpcp_item_types type;
+		bool keyExpected;
+	};
+	Format m_format;
+	Event m_event = Event::None;
+	bool m_eventPending = false;
+	bool m_topLevelRead = false;
+	std::vector<Container> m_containers;
+	ccpcp_item m_item;
+	std::string m_string;
+};
+
+} // namespace chainpack
+} // namespace shv
@@ -4,6 +4,7 @@ namespace shv {
 namespace chainpack {
 
 const char* Rpc::OPT_IDLE_WD_TIMEOUT = "idleWatchDogTimeOut";
+const char* Rpc::OPT_COMPRESSION = "compression";
 
 const char* Rpc::KEY_OPTIONS = "options";
 const char* Rpc::KEY_CLIENT_ID = "clientId";
@@ -93,5 +94,21 @@ const char *Rpc::protocolTypeToString(Rpc::ProtocolType pv)
 	return "???";
 }
 
+const char *Rpc::compressionTypeToString(Rpc::CompressionType ct)
+{
+	switch(ct) {
+	case CompressionType::None: return "none";
+	case CompressionType::Deflate: return "deflate";
+	}
+	return "???";
+}
+
+Rpc::CompressionType Rpc::compressionTypeFromString(const std::string &s)
+{
+	if(s == "deflate")
+		return CompressionType::Deflate;
+	return CompressionType::None;
+}
+
 } // namespace chainpack
 } // namespace shv
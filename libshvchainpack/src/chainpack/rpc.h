@@ -12,8 +12,13 @@ class SHVCHAINPACK_DECL_EXPORT Rpc
 public:
 	enum class ProtocolType {Invalid = 0, ChainPack, Cpon, JsonRpc};
 	static const char* protocolTypeToString(ProtocolType pv);
+	/// frame compression negotiated in login phase
+	enum class CompressionType {None = 0, Deflate};
+	static const char* compressionTypeToString(CompressionType ct);
+	static CompressionType compressionTypeFromString(const std::string &s);
 
 	static const char* OPT_IDLE_WD_TIMEOUT;
+	static const char* OPT_COMPRESSION;
 
 	static const char* KEY_OPTIONS;
 	static const char* KEY_MOUT_POINT;
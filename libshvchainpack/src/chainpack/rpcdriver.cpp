@@ -6,12 +6,20 @@
 #include "cponreader.h"
 #include "chainpackwriter.h"
 #include "chainpackreader.h"
+#include "rpcvaluearena.h"
+
+#include "../../c/cchainpack.h"
 
 #include <necrolog.h>
 
+#include <algorithm>
 #include <sstream>
 #include <iostream>
 
+#ifdef WITH_SHV_ZLIB
+#include <zlib.h>
+#endif
+
 #define logRpcRawMsg() nCMessage("RpcRawMsg")
 #define logRpcData() nCMessage("RpcData")
 #define logWriteQueue() nCMessage("WriteQueue")
@@ -20,6 +28,72 @@
 namespace shv {
 namespace chainpack {
 
+namespace {
+/// read-only stream buffer over existing data, std::istringstream would copy them
+class ConstDataStreamBuf : public std::streambuf
+{
+public:
+	ConstDataStreamBuf(const char *data, size_t length)
+	{
+		char *p = const_cast<char*>(data);
+		setg(p, p, p + length);
+	}
+protected:
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+	{
+		if(!(which & std::ios_base::in))
+			return pos_type(off_type(-1));
+		char *p = (dir == std::ios_base::beg)? eback(): (dir == std::ios_base::cur)? gptr(): egptr();
+		p += off;
+		if(p < eback() || p > egptr())
+			return pos_type(off_type(-1));
+		setg(eback(), p, egptr());
+		return pos_type(off_type(p - eback()));
+	}
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+	{
+		return seekoff(off_type(pos), std::ios_base::beg, which);
+	}
+};
+
+#ifdef WITH_SHV_ZLIB
+/// preset deflate dictionary, strings frequent in SHV messages, it must be the same on both sides
+const char DEFLATE_DICTIONARY[] = "chngvalueshvPathmethodparamsresultgetsetlsdirsubscribeunsubscribeloginhello"
+								  ".broker/app.broker/currentClient.app/shvjournalgetLogsincesnapshot";
+#endif
+}
+
+/// zlib stream shared by all the frames sent (or received) over the connection
+struct RpcDriver::CompressionContext
+{
+#ifdef WITH_SHV_ZLIB
+	explicit CompressionContext(bool is_deflate)
+		: isDeflate(is_deflate)
+	{
+		stream.zalloc = Z_NULL;
+		stream.zfree = Z_NULL;
+		stream.opaque = Z_NULL;
+		stream.next_in = Z_NULL;
+		stream.avail_in = 0;
+		int rc = isDeflate? deflateInit(&stream, Z_DEFAULT_COMPRESSION): inflateInit(&stream);
+		if(rc != Z_OK)
+			SHVCHP_EXCEPTION("Cannot initialize zlib stream, error: " + Utils::toString(rc));
+		if(isDeflate)
+			deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(DEFLATE_DICTIONARY), sizeof(DEFLATE_DICTIONARY) - 1);
+	}
+	~CompressionContext()
+	{
+		if(isDeflate)
+			deflateEnd(&stream);
+		else
+			inflateEnd(&stream);
+	}
+
+	z_stream stream;
+	bool isDeflate;
+#endif
+};
+
 const char * RpcDriver::SND_LOG_ARROW = "<==S";
 const char * RpcDriver::RCV_LOG_ARROW = "R==>";
 
@@ -120,6 +194,7 @@ void RpcDriver::enqueueDataToSend(RpcDriver::MessageData &&chunk_to_enqueue)
 	/// LOCK_FOR_SEND lock mutex here in the multithreaded environment
 	lockSendQueueGuard();
 	if(!chunk_to_enqueue.empty()) {
+		chunk_to_enqueue.compressible = m_sendCompression != Rpc::CompressionType::None;
 		m_sendQueue.push_back(std::move(chunk_to_enqueue));
 		logWriteQueue() << "===========> write chunk added, new queue len:" << m_sendQueue.size();
 	}
@@ -138,54 +213,51 @@ void RpcDriver::writeQueue()
 		nError() << "write data error, socket is not open!";
 		return;
 	}
-	//static int hi_cnt = 0;
-	const MessageData &chunk = m_sendQueue[0];
-	//nInfo() << "M:" << chunk.metaData;
-	//nInfo() << "D:" << chunk.data;
-	if(!m_topMessageDataHeaderWritten) {
-		writeMessageBegin();
-		std::string protocol_type_data;
-		{
-			std::ostringstream os;
-			{ ChainPackWriter wr(os); wr.writeUIntData((unsigned)protocolType());}
-			protocol_type_data = os.str();
+	// write as many queued messages as the underlying device accepts,
+	// each message is passed to writeBuffers() as a single header + meta + data gather list
+	while(!m_sendQueue.empty()) {
+		MessageData &chunk = m_sendQueue.front();
+		char header[MAX_FRAME_HEADER_LENGTH];
+		size_t header_len = 0;
+		WriteBuffer buffers[3];
+		size_t buffer_cnt = 0;
+		if(!m_topMessageDataHeaderWritten) {
+			// compress just before the frame is written, frames must enter compression stream in send order
+			if(m_sendCompression != Rpc::CompressionType::None && chunk.compressible && !chunk.compressed && chunk.size() >= m_compressionThreshold)
+				compressMessageData(chunk);
+			writeMessageBegin();
+			header_len = packFrameHeader(header, sizeof(header), protocolType(), chunk.size(), chunk.compressed);
+			if(header_len == 0)
+				SHVCHP_EXCEPTION("Design error! Frame header buffer is too small");
+			buffers[buffer_cnt++] = WriteBuffer{header, header_len};
 		}
-		{
-			std::ostringstream os;
-			{ ChainPackWriter wr(os); wr.writeUIntData(chunk.size() + protocol_type_data.length()); }
-			std::string packet_len_data = os.str();
-			auto len = writeBytes(packet_len_data.data(), packet_len_data.length());
-			if(len < 0)
-				SHVCHP_EXCEPTION("Write socket error!");
-			if(len < (int)packet_len_data.length())
-				SHVCHP_EXCEPTION("Design error! Chunk length shall be always written at once to the socket");
+		size_t pos = m_topMessageDataBytesWrittenSoFar;
+		if(pos < chunk.metaData.size()) {
+			buffers[buffer_cnt++] = WriteBuffer{chunk.metaData.data() + pos, chunk.metaData.size() - pos};
+			pos = chunk.metaData.size();
 		}
-		{
-			auto len = writeBytes(protocol_type_data.data(), protocol_type_data.length());
-			logWriteQueue() << "\twrite header len:" << len;
-			if(len < 0)
-				SHVCHP_EXCEPTION("Write socket error!");
-			if(len != 1)
-				SHVCHP_EXCEPTION("Design error! Protocol version shall be always written at once to the socket");
+		pos -= chunk.metaData.size();
+		if(pos < chunk.data.size())
+			buffers[buffer_cnt++] = WriteBuffer{chunk.data.data() + pos, chunk.data.size() - pos};
+		auto len = writeBuffers(buffers, buffer_cnt);
+		logWriteQueue() << "\twrite len:" << len << "header len:" << header_len;
+		if(len < 0)
+			SHVCHP_EXCEPTION("Write socket error!");
+		if(len == 0) {
+			// device cannot accept more data now, try it again on next writeQueue() call
+			break;
 		}
+		if(len < (int64_t)header_len)
+			SHVCHP_EXCEPTION("Design error! Frame header shall be always written at once to the socket");
 		m_topMessageDataHeaderWritten = true;
-	}
-	if(m_topMessageDataBytesWrittenSoFar < chunk.metaData.size()) {
-		auto len = writeBytes_helper(chunk.metaData, m_topMessageDataBytesWrittenSoFar, chunk.metaData.size() - m_topMessageDataBytesWrittenSoFar);
-		logWriteQueue() << "\twrite metadata len:" << len;
-		m_topMessageDataBytesWrittenSoFar += len;
-	}
-	if(m_topMessageDataBytesWrittenSoFar >= chunk.metaData.size()) {
-		auto len = writeBytes_helper(chunk.data
-									 , m_topMessageDataBytesWrittenSoFar - chunk.metaData.size()
-									 , chunk.data.size() - (m_topMessageDataBytesWrittenSoFar - chunk.metaData.size()));
-		logWriteQueue() << "\twrite data len:" << len;
-		m_topMessageDataBytesWrittenSoFar += len;
-	}
-	logWriteQueue() << "----- bytes written so far:" << m_topMessageDataBytesWrittenSoFar
-					<< "remaining:" << (chunk.size() - m_topMessageDataBytesWrittenSoFar)
-					<< "queue len:" << m_sendQueue.size();
-	if(m_topMessageDataBytesWrittenSoFar == chunk.size()) {
+		m_topMessageDataBytesWrittenSoFar += static_cast<size_t>(len) - header_len;
+		logWriteQueue() << "----- bytes written so far:" << m_topMessageDataBytesWrittenSoFar
+						<< "remaining:" << (chunk.size() - m_topMessageDataBytesWrittenSoFar)
+						<< "queue len:" << m_sendQueue.size();
+		if(m_topMessageDataBytesWrittenSoFar < chunk.size()) {
+			// device buffer is full, rest of data will be written on next writeQueue() call
+			break;
+		}
 		m_topMessageDataHeaderWritten = false;
 		m_topMessageDataBytesWrittenSoFar = 0;
 		m_sendQueue.pop_front();
@@ -194,22 +266,56 @@ void RpcDriver::writeQueue()
 	}
 }
 
-int64_t RpcDriver::writeBytes_helper(const std::string &str, size_t from, size_t length)
+int64_t RpcDriver::writeBuffers(const WriteBuffer *buffers, size_t count)
 {
-	if(length == 0)
-		SHVCHP_EXCEPTION("Design error! Atempt to write empty buffer to the socket");
-	auto len = writeBytes(str.data() + from, length);
-	if(len < 0)
-		SHVCHP_EXCEPTION("Write socket error!");
-	if(len == 0)
-		SHVCHP_EXCEPTION("Design error! At least 1 byte of data shall be always written to the socket");
-	return len;
+	int64_t ret = 0;
+	for (size_t i = 0; i < count; ++i) {
+		const WriteBuffer &buff = buffers[i];
+		auto len = writeBytes(buff.data, buff.length);
+		if(len < 0)
+			return (ret > 0)? ret: len;
+		ret += len;
+		if(static_cast<size_t>(len) < buff.length)
+			break;
+	}
+	return ret;
+}
+
+size_t RpcDriver::packFrameHeader(char *buff, size_t buff_len, Rpc::ProtocolType protocol_type, size_t message_data_len, bool compressed)
+{
+	char protocol_type_data[9];
+	ccpcp_pack_context ctx;
+	ccpcp_pack_context_init(&ctx, protocol_type_data, sizeof(protocol_type_data), nullptr);
+	cchainpack_pack_uint_data(&ctx, static_cast<unsigned>(protocol_type) | (compressed? COMPRESSED_FRAME_FLAG: 0));
+	size_t protocol_type_len = static_cast<size_t>(ctx.current - ctx.start);
+
+	ccpcp_pack_context_init(&ctx, buff, buff_len, nullptr);
+	cchainpack_pack_uint_data(&ctx, message_data_len + protocol_type_len);
+	ccpcp_pack_copy_bytes(&ctx, protocol_type_data, protocol_type_len);
+	if(ctx.err_no != CCPCP_RC_OK)
+		return 0;
+	return static_cast<size_t>(ctx.current - ctx.start);
 }
 
 void RpcDriver::onBytesRead(std::string &&bytes)
 {
 	logRpcData().nospace() << __FUNCTION__ << " " << bytes.length() << " bytes of data read:\n" << shv::chainpack::Utils::hexDump(bytes);
-	m_readData += std::string(std::move(bytes));
+	if(m_readData.empty())
+		m_readData = std::move(bytes);
+	else
+		m_readData += bytes;
+	processReadBuffer();
+}
+
+void RpcDriver::onBytesRead(const char *bytes, size_t length)
+{
+	logRpcData().nospace() << __FUNCTION__ << " " << length << " bytes of data read:\n" << shv::chainpack::Utils::hexDump(std::string(bytes, length));
+	m_readData.append(bytes, length);
+	processReadBuffer();
+}
+
+void RpcDriver::processReadBuffer()
+{
 	while(true) {
 		auto old_len = m_readData.size();
 		processReadData();
@@ -224,8 +330,132 @@ void RpcDriver::clearBuffers()
 	m_topMessageDataHeaderWritten = false;
 	m_topMessageDataBytesWrittenSoFar = 0;
 	m_readData.clear();
+	// new connection starts new compression streams, compression is negotiated again
+	m_sendCompression = Rpc::CompressionType::None;
+	m_receiveCompression = Rpc::CompressionType::None;
+	m_deflateContext.reset();
+	m_inflateContext.reset();
+	m_sentCompressionStats = CompressionStats();
+	m_receivedCompressionStats = CompressionStats();
+}
+
+bool RpcDriver::isCompressionSupported(Rpc::CompressionType ct)
+{
+	switch (ct) {
+	case Rpc::CompressionType::None:
+		return true;
+	case Rpc::CompressionType::Deflate:
+#ifdef WITH_SHV_ZLIB
+		return true;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
+void RpcDriver::setSendCompression(Rpc::CompressionType ct)
+{
+	if(!isCompressionSupported(ct))
+		SHVCHP_EXCEPTION(std::string("Compression ") + Rpc::compressionTypeToString(ct) + " is not supported by this build.");
+	m_sendCompression = ct;
 }
 
+void RpcDriver::setReceiveCompression(Rpc::CompressionType ct)
+{
+	if(!isCompressionSupported(ct))
+		SHVCHP_EXCEPTION(std::string("Compression ") + Rpc::compressionTypeToString(ct) + " is not supported by this build.");
+	m_receiveCompression = ct;
+}
+
+#ifdef WITH_SHV_ZLIB
+void RpcDriver::compressMessageData(MessageData &chunk)
+{
+	if(!m_deflateContext)
+		m_deflateContext.reset(new CompressionContext(true));
+	z_stream &strm = m_deflateContext->stream;
+	std::string out(deflateBound(&strm, static_cast<uLong>(chunk.size())), '\0');
+	size_t out_pos = 0;
+	auto deflate_data = [&](const std::string &data, int flush) {
+		strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+		strm.avail_in = static_cast<uInt>(data.size());
+		do {
+			if(out_pos == out.size())
+				out.resize(2 * out.size());
+			strm.next_out = reinterpret_cast<Bytef*>(&out[out_pos]);
+			strm.avail_out = static_cast<uInt>(out.size() - out_pos);
+			int rc = ::deflate(&strm, flush);
+			if(rc != Z_OK && rc != Z_BUF_ERROR)
+				SHVCHP_EXCEPTION("Frame compression error: " + Utils::toString(rc));
+			out_pos = out.size() - strm.avail_out;
+		} while(strm.avail_out == 0);
+	};
+	deflate_data(chunk.metaData, Z_NO_FLUSH);
+	// sync flush makes frame decompressable on its own, compression history is kept for next frames
+	deflate_data(chunk.data, Z_SYNC_FLUSH);
+	out.resize(out_pos);
+
+	m_sentCompressionStats.frameCount++;
+	m_sentCompressionStats.rawBytes += chunk.size();
+	m_sentCompressionStats.compressedBytes += out.size();
+	logWriteQueue() << "frame compressed" << chunk.size() << "->" << out.size() << "bytes";
+	chunk.metaData.clear();
+	chunk.data = std::move(out);
+	chunk.compressed = true;
+}
+
+std::string RpcDriver::decompressFrameData(const char *data, size_t length)
+{
+	if(!m_inflateContext)
+		m_inflateContext.reset(new CompressionContext(false));
+	z_stream &strm = m_inflateContext->stream;
+	// one byte over limit is enough to detect too big frame
+	const size_t max_out_size = m_maxDecompressedFrameLength + 1;
+	std::string out(std::min(std::max<size_t>(4 * length, 1024), max_out_size), '\0');
+	size_t out_pos = 0;
+	strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	strm.avail_in = static_cast<uInt>(length);
+	while(true) {
+		if(out_pos == out.size()) {
+			if(out.size() >= max_out_size)
+				SHVCHP_EXCEPTION("Frame decompression error: decompressed frame is longer than " + Utils::toString(m_maxDecompressedFrameLength) + " bytes");
+			out.resize(std::min(2 * out.size(), max_out_size));
+		}
+		strm.next_out = reinterpret_cast<Bytef*>(&out[out_pos]);
+		strm.avail_out = static_cast<uInt>(out.size() - out_pos);
+		int rc = ::inflate(&strm, Z_SYNC_FLUSH);
+		out_pos = out.size() - strm.avail_out;
+		if(rc == Z_NEED_DICT) {
+			if(inflateSetDictionary(&strm, reinterpret_cast<const Bytef*>(DEFLATE_DICTIONARY), sizeof(DEFLATE_DICTIONARY) - 1) != Z_OK)
+				SHVCHP_EXCEPTION("Frame decompression error: dictionary mismatch");
+			continue;
+		}
+		if(rc != Z_OK && rc != Z_BUF_ERROR)
+			SHVCHP_EXCEPTION("Frame decompression error: " + Utils::toString(rc));
+		if(strm.avail_out > 0)
+			break;
+	}
+	if(strm.avail_in > 0)
+		SHVCHP_EXCEPTION("Frame decompression error: compressed data corrupted");
+	out.resize(out_pos);
+
+	m_receivedCompressionStats.frameCount++;
+	m_receivedCompressionStats.rawBytes += out.size();
+	m_receivedCompressionStats.compressedBytes += length;
+	return out;
+}
+#else
+void RpcDriver::compressMessageData(MessageData &)
+{
+	SHVCHP_EXCEPTION("Frame compression is not supported by this build.");
+}
+
+std::string RpcDriver::decompressFrameData(const char *, size_t)
+{
+	SHVCHP_EXCEPTION("Compressed frame received, but frame compression is not supported by this build.");
+}
+#endif
+
 void RpcDriver::processReadData()
 {
 	const std::string &read_data = m_readData;
@@ -233,7 +463,8 @@ void RpcDriver::processReadData()
 
 	using namespace shv::chainpack;
 
-	std::istringstream in(read_data);
+	ConstDataStreamBuf in_buf(read_data.data(), read_data.size());
+	std::istream in(&in_buf);
 
 	bool ok;
 	uint64_t chunk_len = ChainPackReader::readUIntData(in, &ok);
@@ -242,9 +473,11 @@ void RpcDriver::processReadData()
 
 	size_t read_len = (size_t)in.tellg() + chunk_len;
 
-	Rpc::ProtocolType protocol_type = (Rpc::ProtocolType)ChainPackReader::readUIntData(in, &ok);
+	auto protocol_type_data = ChainPackReader::readUIntData(in, &ok);
 	if(!ok)
 		return;
+	const bool compressed = (protocol_type_data & COMPRESSED_FRAME_FLAG) != 0;
+	Rpc::ProtocolType protocol_type = (Rpc::ProtocolType)(protocol_type_data & ~static_cast<uint64_t>(COMPRESSED_FRAME_FLAG));
 
 	logRpcData() << "\t expected message data length:" << read_len << "length available:" << read_data.size();
 	if(read_len > read_data.length())
@@ -260,13 +493,45 @@ void RpcDriver::processReadData()
 	}
 
 	try {
+		if(compressed) {
+			auto data_pos = static_cast<size_t>(in.tellg());
+			std::string frame_data;
+			try {
+				if(m_receiveCompression == Rpc::CompressionType::None)
+					SHVCHP_EXCEPTION("Compressed frame received, but compression is not negotiated.");
+				frame_data = decompressFrameData(read_data.data() + data_pos, read_len - data_pos);
+			}
+			catch (std::exception &) {
+				// rejected frame is dropped, decompression stream cannot be used for next frames
+				m_readData.erase(0, read_len);
+				m_inflateContext.reset();
+				throw;
+			}
+			// frame is consumed by decompression stream already, it cannot be processed again
+			m_readData.erase(0, read_len);
+			RpcValue::MetaData meta_data;
+			size_t meta_data_end_pos = decodeMetaData(meta_data, protocol_type, frame_data, 0);
+			frame_data.erase(0, meta_data_end_pos);
+			onRpcDataReceived(protocol_type, std::move(meta_data), std::move(frame_data));
+			return;
+		}
 		RpcValue::MetaData meta_data;
 		size_t meta_data_end_pos = decodeMetaData(meta_data, protocol_type, read_data, in.tellg());
 		if(meta_data_end_pos > read_len)
 			throw std::runtime_error("Data header corrupted");
-		std::string msg_data = read_data.substr(meta_data_end_pos, read_len - meta_data_end_pos);
 		logRpcData() << read_len << "bytes of" << m_readData.size() << "processed";
-		m_readData = m_readData.substr(read_len);
+		std::string msg_data;
+		if(read_len == m_readData.size()) {
+			// read buffer contains exactly one frame (websocket message for example),
+			// reuse its memory for message data instead of copying them
+			m_readData.erase(0, meta_data_end_pos);
+			msg_data = std::move(m_readData);
+			m_readData.clear();
+		}
+		else {
+			msg_data = m_readData.substr(meta_data_end_pos, read_len - meta_data_end_pos);
+			m_readData.erase(0, read_len);
+		}
 		onRpcDataReceived(protocol_type, std::move(meta_data), std::move(msg_data));
 	}
 	catch (std::exception &e) {
@@ -278,7 +543,8 @@ void RpcDriver::processReadData()
 size_t RpcDriver::decodeMetaData(RpcValue::MetaData &meta_data, Rpc::ProtocolType protocol_type, const std::string &data, size_t start_pos)
 {
 	size_t meta_data_end_pos = start_pos;
-	std::istringstream in(data);
+	ConstDataStreamBuf in_buf(data.data(), data.size());
+	std::istream in(&in_buf);
 	in.seekg(start_pos);
 
 	switch (protocol_type) {
@@ -331,7 +597,8 @@ size_t RpcDriver::decodeMetaData(RpcValue::MetaData &meta_data, Rpc::ProtocolTyp
 RpcValue RpcDriver::decodeData(Rpc::ProtocolType protocol_type, const std::string &data, size_t start_pos)
 {
 	RpcValue ret;
-	std::istringstream in(data);
+	ConstDataStreamBuf in_buf(data.data(), data.size());
+	std::istream in(&in_buf);
 	in.seekg(start_pos);
 	try {
 		switch (protocol_type) {
@@ -441,7 +708,16 @@ std::string RpcDriver::codeRpcValue(Rpc::ProtocolType protocol_type, const RpcVa
 void RpcDriver::onRpcDataReceived(Rpc::ProtocolType protocol_type, RpcValue::MetaData &&md, std::string &&data)
 {
 	//nInfo() << __FILE__ << RCV_LOG_ARROW << md.toStdString() << shv::chainpack::Utils::toHexElided(data, start_pos, 100);
-	RpcValue msg = decodeData(protocol_type, data, 0);
+	RpcValue msg;
+	if(m_messageArenaEnabled) {
+		// decoded message is several times bigger than its ChainPack data
+		RpcValueArena arena(data.size() * 4);
+		RpcValueArena::Scope arena_scope(arena);
+		msg = decodeData(protocol_type, data, 0);
+	}
+	else {
+		msg = decodeData(protocol_type, data, 0);
+	}
 	if(msg.isValid()) {
 		msg.setMetaData(std::move(md));
 		logRpcRawMsg() << RCV_LOG_ARROW << msg.toPrettyString();
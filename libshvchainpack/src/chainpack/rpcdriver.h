@@ -8,6 +8,7 @@
 #include <string>
 #include <deque>
 #include <map>
+#include <memory>
 
 namespace shv {
 namespace chainpack {
@@ -30,6 +31,37 @@ public:
 	using MessageReceivedCallback = std::function< void (const RpcValue &msg)>;
 	void setMessageReceivedCallback(const MessageReceivedCallback &callback) {m_messageReceivedCallback = callback;}
 
+	/// received messages are decoded into per message RpcValueArena,
+	/// enable it for short lived messages only, any retained value keeps whole message memory allocated
+	bool isMessageArenaEnabled() const {return m_messageArenaEnabled;}
+	void setMessageArenaEnabled(bool b) {m_messageArenaEnabled = b;}
+
+	/// frames bigger than threshold are compressed with streaming compression context shared by all the frames,
+	/// so repeated paths and method names are compressed across messages
+	static bool isCompressionSupported(Rpc::CompressionType ct);
+	Rpc::CompressionType sendCompression() const {return m_sendCompression;}
+	/// set it after compression is negotiated in login phase, throws if compression is not supported by this build
+	void setSendCompression(Rpc::CompressionType ct);
+	/// compressed frames are rejected until compression is negotiated in login phase
+	Rpc::CompressionType receiveCompression() const {return m_receiveCompression;}
+	void setReceiveCompression(Rpc::CompressionType ct);
+	/// compressed frame inflating to more bytes is rejected
+	size_t maxDecompressedFrameLength() const {return m_maxDecompressedFrameLength;}
+	void setMaxDecompressedFrameLength(size_t n) {m_maxDecompressedFrameLength = n;}
+	size_t compressionThreshold() const {return m_compressionThreshold;}
+	void setCompressionThreshold(size_t n) {m_compressionThreshold = n;}
+
+	struct CompressionStats
+	{
+		uint64_t frameCount = 0;
+		uint64_t rawBytes = 0;
+		uint64_t compressedBytes = 0;
+
+		double ratio() const {return compressedBytes == 0? 1.: static_cast<double>(rawBytes) / static_cast<double>(compressedBytes);}
+	};
+	const CompressionStats& sentCompressionStats() const {return m_sentCompressionStats;}
+	const CompressionStats& receivedCompressionStats() const {return m_receivedCompressionStats;}
+
 	static int defaultRpcTimeoutMsec() {return s_defaultRpcTimeoutMsec;}
 	static void setDefaultRpcTimeoutMsec(int msec) {s_defaultRpcTimeoutMsec = msec;}
 
@@ -40,11 +72,24 @@ public:
 	static std::string codeRpcValue(Rpc::ProtocolType protocol_type, const RpcValue &val);
 
 	static std::string dataToPrettyCpon(shv::chainpack::Rpc::ProtocolType protocol_type, const shv::chainpack::RpcValue::MetaData &md, const std::string &data, size_t start_pos = 0, size_t data_len = 0);
+
+	/// ChainPack UInt data are 9 bytes long at most, frame header consists of frame length and protocol type
+	static constexpr size_t MAX_FRAME_HEADER_LENGTH = 2 * 9;
+	/// pack frame header to the caller supplied buffer, no heap allocation is done
+	/// compressed frames have protocol type ORed with COMPRESSED_FRAME_FLAG
+	/// @return frame header length or 0 if buffer is too small
+	static size_t packFrameHeader(char *buff, size_t buff_len, Rpc::ProtocolType protocol_type, size_t message_data_len, bool compressed = false);
+	static constexpr unsigned COMPRESSED_FRAME_FLAG = 0x40;
 protected:
 	struct MessageData
 	{
 		std::string metaData;
 		std::string data;
+		/// data contains compressed meta data + data, metaData is empty
+		bool compressed = false;
+		/// set for frames enqueued after send compression was enabled,
+		/// frames queued before, like login response, must reach the peer uncompressed
+		bool compressible = false;
 
 		MessageData() {}
 		MessageData(std::string &&meta_data, std::string &&data) : metaData(std::move(meta_data)), data(std::move(data)) {}
@@ -54,6 +99,11 @@ protected:
 		bool empty() const {return metaData.empty() && data.empty();}
 		size_t size() const {return metaData.size() + data.size();}
 	};
+	struct WriteBuffer
+	{
+		const char *data;
+		size_t length;
+	};
 protected:
 	virtual bool isOpen() = 0;
 
@@ -65,8 +115,14 @@ protected:
 	/// write bytes to write buffer (and possibly to socket)
 	/// @return number of writen bytes
 	virtual int64_t writeBytes(const char *bytes, size_t length) = 0;
+	/// scatter-gather variant of writeBytes(), write buffers in one go if the underlying device supports it
+	/// default implementation calls writeBytes() for each buffer until it is not written completely
+	/// @return number of writen bytes
+	virtual int64_t writeBuffers(const WriteBuffer *buffers, size_t count);
 	/// call it when new data arrived
 	virtual void onBytesRead(std::string &&bytes);
+	/// append bytes to read buffer directly, without intermediate std::string
+	void onBytesRead(const char *bytes, size_t length);
 	/// flush write buffer to socket
 	/// @return true if write buffer length has changed (some data was written to the socket)
 	//virtual bool flush() = 0;
@@ -84,15 +140,28 @@ protected:
 	void unlockSendQueueGuard();
 private:
 	void processReadData();
+	void processReadBuffer();
 	void writeQueue();
-	int64_t writeBytes_helper(const std::string &str, size_t from, size_t length);
+	void compressMessageData(MessageData &chunk);
+	std::string decompressFrameData(const char *data, size_t length);
 private:
+	struct CompressionContext;
+
 	MessageReceivedCallback m_messageReceivedCallback = nullptr;
 	std::deque<MessageData> m_sendQueue;
 	bool m_topMessageDataHeaderWritten = false;
 	size_t m_topMessageDataBytesWrittenSoFar = 0;
 	std::string m_readData;
 	Rpc::ProtocolType m_protocolType = Rpc::ProtocolType::Invalid;
+	bool m_messageArenaEnabled = false;
+	Rpc::CompressionType m_sendCompression = Rpc::CompressionType::None;
+	Rpc::CompressionType m_receiveCompression = Rpc::CompressionType::None;
+	size_t m_maxDecompressedFrameLength = 16 * 1024 * 1024;
+	size_t m_compressionThreshold = 256;
+	std::unique_ptr<CompressionContext> m_deflateContext;
+	std::unique_ptr<CompressionContext> m_inflateContext;
+	CompressionStats m_sentCompressionStats;
+	CompressionStats m_receivedCompressionStats;
 	static int s_defaultRpcTimeoutMsec;
 };
 
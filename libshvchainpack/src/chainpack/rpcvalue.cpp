@@ -4,6 +4,7 @@
 #include "cponreader.h"
 #include "chainpackwriter.h"
 #include "chainpackreader.h"
+#include "rpcvaluearena.h"
 #include "exception.h"
 #include "utils.h"
 
@@ -388,7 +389,7 @@ class ChainPackMap final : public ValueData<RpcValue::Type::Map, RpcValue::Map>
 	bool equals(const RpcValue::AbstractValueData * other) const override { return m_value == other->asMap(); }
 public:
 	explicit ChainPackMap(const RpcValue::Map &value) : ValueData(value) {}
-	explicit ChainPackMap(RpcValue::Map &&value) : ValueData(move(value)) {}
+	explicit ChainPackMap(RpcValue::Map &&value) : ValueData(std::move(value)) {}
 
 	const RpcValue::Map &asMap() const override { return m_value; }
 };
@@ -427,6 +428,17 @@ static const RpcValue::List & static_empty_list() { static const RpcValue::List
 static const RpcValue::Map & static_empty_map() { static const RpcValue::Map s{}; return s; }
 static const RpcValue::IMap & static_empty_imap() { static const RpcValue::IMap s{}; return s; }
 
+namespace {
+/// value data are allocated from current thread arena if there is some
+template<typename T, typename... Args>
+std::shared_ptr<T> make_value(Args&&... args)
+{
+	if(RpcValueArena *arena = RpcValueArena::current())
+		return arena->makeShared<T>(std::forward<Args>(args)...);
+	return std::make_shared<T>(std::forward<Args>(args)...);
+}
+}
+
 /* * * * * * * * * * * * * * * * * * * *
  * Constructors
  */
@@ -452,32 +464,32 @@ RpcValue RpcValue::fromType(RpcValue::Type t) noexcept
 	}
 	return RpcValue();
 }
-RpcValue::RpcValue(std::nullptr_t) noexcept : m_ptr(std::make_shared<ChainPackNull>()) {}
-RpcValue::RpcValue(double value) : m_ptr(std::make_shared<ChainPackDouble>(value)) {}
-RpcValue::RpcValue(RpcValue::Decimal value) : m_ptr(std::make_shared<ChainPackDecimal>(std::move(value))) {}
-RpcValue::RpcValue(int32_t value) : m_ptr(std::make_shared<ChainPackInt>(value)) {}
-RpcValue::RpcValue(uint32_t value) : m_ptr(std::make_shared<ChainPackUInt>(value)) {}
-RpcValue::RpcValue(int64_t value) : m_ptr(std::make_shared<ChainPackInt>(value)) {}
-RpcValue::RpcValue(uint64_t value) : m_ptr(std::make_shared<ChainPackUInt>(value)) {}
-RpcValue::RpcValue(bool value) : m_ptr(std::make_shared<ChainPackBoolean>(value)) {}
-RpcValue::RpcValue(const DateTime &value) : m_ptr(std::make_shared<ChainPackDateTime>(value)) {}
+RpcValue::RpcValue(std::nullptr_t) noexcept : m_ptr(make_value<ChainPackNull>()) {}
+RpcValue::RpcValue(double value) : m_ptr(make_value<ChainPackDouble>(value)) {}
+RpcValue::RpcValue(RpcValue::Decimal value) : m_ptr(make_value<ChainPackDecimal>(std::move(value))) {}
+RpcValue::RpcValue(int32_t value) : m_ptr(make_value<ChainPackInt>(value)) {}
+RpcValue::RpcValue(uint32_t value) : m_ptr(make_value<ChainPackUInt>(value)) {}
+RpcValue::RpcValue(int64_t value) : m_ptr(make_value<ChainPackInt>(value)) {}
+RpcValue::RpcValue(uint64_t value) : m_ptr(make_value<ChainPackUInt>(value)) {}
+RpcValue::RpcValue(bool value) : m_ptr(make_value<ChainPackBoolean>(value)) {}
+RpcValue::RpcValue(const DateTime &value) : m_ptr(make_value<ChainPackDateTime>(value)) {}
 
-RpcValue::RpcValue(const RpcValue::Blob &value) : m_ptr(std::make_shared<ChainPackBlob>(value)) {}
-RpcValue::RpcValue(RpcValue::Blob &&value) : m_ptr(std::make_shared<ChainPackBlob>(std::move(value))) {}
-RpcValue::RpcValue(const uint8_t * value, size_t size) : m_ptr(std::make_shared<ChainPackBlob>(value, size)) {}
+RpcValue::RpcValue(const RpcValue::Blob &value) : m_ptr(make_value<ChainPackBlob>(value)) {}
+RpcValue::RpcValue(RpcValue::Blob &&value) : m_ptr(make_value<ChainPackBlob>(std::move(value))) {}
+RpcValue::RpcValue(const uint8_t * value, size_t size) : m_ptr(make_value<ChainPackBlob>(value, size)) {}
 
-RpcValue::RpcValue(const std::string &value) : m_ptr(std::make_shared<ChainPackString>(value)) {}
-RpcValue::RpcValue(std::string &&value) : m_ptr(std::make_shared<ChainPackString>(std::move(value))) {}
-RpcValue::RpcValue(const char * value) : m_ptr(std::make_shared<ChainPackString>(value)) {}
+RpcValue::RpcValue(const std::string &value) : m_ptr(make_value<ChainPackString>(value)) {}
+RpcValue::RpcValue(std::string &&value) : m_ptr(make_value<ChainPackString>(std::move(value))) {}
+RpcValue::RpcValue(const char * value) : m_ptr(make_value<ChainPackString>(value)) {}
 
-RpcValue::RpcValue(const RpcValue::List &values) : m_ptr(std::make_shared<ChainPackList>(values)) {}
-RpcValue::RpcValue(RpcValue::List &&values) : m_ptr(std::make_shared<ChainPackList>(std::move(values))) {}
+RpcValue::RpcValue(const RpcValue::List &values) : m_ptr(make_value<ChainPackList>(values)) {}
+RpcValue::RpcValue(RpcValue::List &&values) : m_ptr(make_value<ChainPackList>(std::move(values))) {}
 
-RpcValue::RpcValue(const RpcValue::Map &values) : m_ptr(std::make_shared<ChainPackMap>(values)) {}
-RpcValue::RpcValue(RpcValue::Map &&values) : m_ptr(std::make_shared<ChainPackMap>(std::move(values))) {}
+RpcValue::RpcValue(const RpcValue::Map &values) : m_ptr(make_value<ChainPackMap>(values)) {}
+RpcValue::RpcValue(RpcValue::Map &&values) : m_ptr(make_value<ChainPackMap>(std::move(values))) {}
 
-RpcValue::RpcValue(const RpcValue::IMap &values) : m_ptr(std::make_shared<ChainPackIMap>(values)) {}
-RpcValue::RpcValue(RpcValue::IMap &&values) : m_ptr(std::make_shared<ChainPackIMap>(std::move(values))) {}
+RpcValue::RpcValue(const RpcValue::IMap &values) : m_ptr(make_value<ChainPackIMap>(values)) {}
+RpcValue::RpcValue(RpcValue::IMap &&values) : m_ptr(make_value<ChainPackIMap>(std::move(values))) {}
 
 #ifdef RPCVALUE_COPY_AND_SWAP
 void RpcValue::swap(RpcValue& other) noexcept
@@ -1284,6 +1296,11 @@ void RpcValue::MetaData::swap(RpcValue::MetaData &o)
 	std::swap(m_smap, o.m_smap);
 }
 
+double RpcValue::Decimal::toDouble() const
+{
+	return ccpcp_decimal_to_double(mantisa(), exponent());
+}
+
 std::string RpcValue::Decimal::toString() const
 {
 	std::string ret = RpcValue(*this).toCpon();
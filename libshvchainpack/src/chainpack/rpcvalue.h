@@ -3,6 +3,7 @@
 #include "../shvchainpackglobal.h"
 #include "exception.h"
 #include "metatypes.h"
+#include "flatmap.h"
 
 #include <string>
 #include <vector>
@@ -137,16 +138,7 @@ public:
 			Decimal dc = fromDouble(d, -m_num.exponent);
 			m_num.mantisa = dc.mantisa();
 		}
-		double toDouble() const
-		{
-			double ret = mantisa();
-			int exp = exponent();
-			if(exp > 0)
-				for(; exp > 0; exp--) ret *= Base;
-			else
-				for(; exp < 0; exp++) ret /= Base;
-			return ret;
-		}
+		double toDouble() const;
 		//bool isValid() const {return !(mantisa() == 0 && exponent() != 0);}
 		std::string toString() const;
 	};
@@ -216,9 +208,9 @@ public:
 			return ret;
 		}
 	};
-	class Map : public std::map<String, RpcValue>
+	class Map : public FlatMap<String, RpcValue>
 	{
-		using Super = std::map<String, RpcValue>;
+		using Super = FlatMap<String, RpcValue>;
 		using Super::Super; // expose base class constructors
 	public:
 		RpcValue value(const String &key, const RpcValue &default_val = RpcValue()) const
@@ -248,9 +240,9 @@ public:
 			return ret;
 		}
 	};
-	class IMap : public std::map<Int, RpcValue>
+	class IMap : public FlatMap<Int, RpcValue>
 	{
-		using Super = std::map<Int, RpcValue>;
+		using Super = FlatMap<Int, RpcValue>;
 		using Super::Super; // expose base class constructors
 	public:
 		RpcValue value(Int key, const RpcValue &default_val = RpcValue()) const
@@ -0,0 +1,79 @@
+#include "rpcvaluearena.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace shv {
+namespace chainpack {
+
+//===========================================================
+// RpcValueArena::Data
+//===========================================================
+constexpr int64_t RpcValueArena::Data::OWNER_BIAS;
+
+RpcValueArena::Data::Data(size_t chunk_size)
+	: m_liveCount(OWNER_BIAS)
+	, m_chunkSize(chunk_size < 256? 256: chunk_size)
+{
+}
+
+RpcValueArena::Data::~Data()
+{
+	for(char *chunk : m_chunks)
+		std::free(chunk);
+}
+
+char *RpcValueArena::Data::allocateChunk(size_t size, size_t align)
+{
+	// every next chunk is twice as big to keep chunk count low for unexpectedly big messages
+	size_t chunk_size = m_chunkSize << (m_chunks.size() < 8? m_chunks.size(): 8);
+	if(chunk_size < size + align)
+		chunk_size = size + align;
+	char *chunk = static_cast<char*>(std::malloc(chunk_size));
+	if(!chunk)
+		throw std::bad_alloc();
+	m_chunks.push_back(chunk);
+	m_current = chunk;
+	m_end = chunk + chunk_size;
+	return m_current + ((align - reinterpret_cast<uintptr_t>(m_current) % align) % align);
+}
+
+//===========================================================
+// RpcValueArena
+//===========================================================
+namespace {
+thread_local RpcValueArena *s_currentArena = nullptr;
+}
+
+RpcValueArena::Scope::Scope(RpcValueArena &arena)
+	: m_previous(s_currentArena)
+{
+	s_currentArena = &arena;
+}
+
+RpcValueArena::Scope::~Scope()
+{
+	s_currentArena = m_previous;
+}
+
+RpcValueArena::RpcValueArena(size_t chunk_size)
+	: m_data(new Data(chunk_size))
+{
+}
+
+RpcValueArena::~RpcValueArena()
+{
+	// publish allocations done by this thread and drop owner reference,
+	// data are deleted here or by the last deallocation
+	const int64_t pending = m_data->m_pendingAllocationCount;
+	m_data->m_pendingAllocationCount = 0;
+	m_data->release(Data::OWNER_BIAS - pending);
+}
+
+RpcValueArena *RpcValueArena::current()
+{
+	return s_currentArena;
+}
+
+} // namespace chainpack
+} // namespace shv
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "../shvchainpackglobal.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace shv {
+namespace chainpack {
+
+/// Monotonic memory arena for RpcValue data created while RpcValueArena::Scope is active on the current thread.
+/// Memory is released at once when the arena and all the values allocated from it are destroyed,
+/// so the values can safely outlive the arena object and can be released from other threads.
+/// Keeping single value of a message alive keeps whole message memory allocated,
+/// use it for short lived data like RPC message being forwarded or handled.
+/// Values can be allocated from the arena on the thread which created it only.
+class SHVCHAINPACK_DECL_EXPORT RpcValueArena
+{
+public:
+	class SHVCHAINPACK_DECL_EXPORT Data
+	{
+		friend class RpcValueArena;
+	public:
+		explicit Data(size_t chunk_size);
+		Data(const Data &) = delete;
+		Data& operator=(const Data &) = delete;
+
+		/// called from thread owning the arena only
+		void* allocate(size_t size, size_t align)
+		{
+			char *p = m_current + ((align - reinterpret_cast<uintptr_t>(m_current) % align) % align);
+			if(m_current == nullptr || p + size > m_end)
+				p = allocateChunk(size, align);
+			m_allocatedBytes += static_cast<size_t>(p + size - m_current);
+			m_current = p + size;
+			m_pendingAllocationCount++;
+			return p;
+		}
+		/// can be called from any thread
+		void deallocate() { release(1); }
+
+		size_t allocatedBytes() const {return m_allocatedBytes;}
+		size_t chunkCount() const {return m_chunks.size();}
+	private:
+		~Data();
+		char* allocateChunk(size_t size, size_t align);
+		void release(int64_t n)
+		{
+			if(m_liveCount.fetch_sub(n, std::memory_order_acq_rel) == n)
+				delete this;
+		}
+	private:
+		/// owning arena holds OWNER_BIAS reference, allocations are added to live count when arena is destroyed,
+		/// so only deallocation needs atomic operation
+		static constexpr int64_t OWNER_BIAS = int64_t{1} << 62;
+		std::atomic<int64_t> m_liveCount;
+		int64_t m_pendingAllocationCount = 0;
+		size_t m_chunkSize;
+		std::vector<char*> m_chunks;
+		char *m_current = nullptr;
+		char *m_end = nullptr;
+		size_t m_allocatedBytes = 0;
+	};
+
+	/// std allocator allocating from arena, deallocation only releases reference to arena data
+	template<typename T>
+	class Allocator
+	{
+	public:
+		using value_type = T;
+
+		explicit Allocator(Data *data) : m_data(data) {}
+		template<typename U>
+		Allocator(const Allocator<U> &o) : m_data(o.data()) {}
+
+		T* allocate(size_t n) {return static_cast<T*>(m_data->allocate(n * sizeof(T), alignof(T)));}
+		void deallocate(T*, size_t) {m_data->deallocate();}
+
+		Data* data() const {return m_data;}
+
+		template<typename U>
+		bool operator==(const Allocator<U> &o) const {return m_data == o.data();}
+		template<typename U>
+		bool operator!=(const Allocator<U> &o) const {return m_data != o.data();}
+	private:
+		Data *m_data;
+	};
+
+	class SHVCHAINPACK_DECL_EXPORT Scope
+	{
+	public:
+		explicit Scope(RpcValueArena &arena);
+		~Scope();
+		Scope(const Scope &) = delete;
+		Scope& operator=(const Scope &) = delete;
+	private:
+		RpcValueArena *m_previous;
+	};
+public:
+	explicit RpcValueArena(size_t chunk_size = 4096);
+	~RpcValueArena();
+	RpcValueArena(const RpcValueArena &) = delete;
+	RpcValueArena& operator=(const RpcValueArena &) = delete;
+
+	/// arena active on the current thread or nullptr
+	static RpcValueArena* current();
+
+	/// bytes allocated from the arena including alignment padding
+	size_t allocatedBytes() const {return m_data->allocatedBytes();}
+	size_t chunkCount() const {return m_data->chunkCount();}
+
+	template<typename T, typename... Args>
+	std::shared_ptr<T> makeShared(Args&&... args)
+	{
+		return std::allocate_shared<T>(Allocator<T>(m_data), std::forward<Args>(args)...);
+	}
+private:
+	Data *m_data;
+};
+
+} // namespace chainpack
+} // namespace shv
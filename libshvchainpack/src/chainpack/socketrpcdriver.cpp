@@ -15,7 +15,9 @@
 #include <arpa/inet.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netdb.h>
+#include <errno.h>
 #endif
 
 namespace cp = shv::chainpack;
@@ -58,6 +60,55 @@ int64_t SocketRpcDriver::writeBytes(const char *bytes, size_t length)
 	return bytes_to_write_len;
 }
 
+int64_t SocketRpcDriver::writeBuffers(const WriteBuffer *buffers, size_t count)
+{
+#ifdef FREE_RTOS
+	return Super::writeBuffers(buffers, count);
+#else
+	if(!isOpen()) {
+		nInfo() << "Write to closed socket";
+		return 0;
+	}
+	flush();
+	if(!m_writeBuffer.empty()) {
+		// keep bytes order, buffer data behind not yet flushed ones
+		return Super::writeBuffers(buffers, count);
+	}
+	static constexpr size_t MAX_IOV_CNT = 8;
+	struct iovec iov[MAX_IOV_CNT];
+	size_t iov_cnt = 0;
+	for (; iov_cnt < count && iov_cnt < MAX_IOV_CNT; ++iov_cnt) {
+		iov[iov_cnt].iov_base = const_cast<char*>(buffers[iov_cnt].data);
+		iov[iov_cnt].iov_len = buffers[iov_cnt].length;
+	}
+	int64_t n = ::writev(m_socket, iov, static_cast<int>(iov_cnt));
+	nDebug() << "\t" << n << "bytes written by writev(), buffer cnt:" << iov_cnt;
+	if(n < 0) {
+		if(errno != EAGAIN && errno != EWOULDBLOCK)
+			return n;
+		n = 0;
+	}
+	// copy rest of data to the write buffer, it will be flushed when socket gets writable
+	size_t skip = static_cast<size_t>(n);
+	for (size_t i = 0; i < iov_cnt; ++i) {
+		const WriteBuffer &buff = buffers[i];
+		if(skip >= buff.length) {
+			skip -= buff.length;
+			continue;
+		}
+		size_t len = buff.length - skip;
+		if(m_writeBuffer.size() + len > m_maxWriteBufferLength)
+			len = m_maxWriteBufferLength - m_writeBuffer.size();
+		m_writeBuffer.append(buff.data + skip, len);
+		n += static_cast<int64_t>(len);
+		skip = 0;
+		if(m_writeBuffer.size() >= m_maxWriteBufferLength)
+			break;
+	}
+	return n;
+#endif
+}
+
 bool SocketRpcDriver::flush()
 {
 	if(m_writeBuffer.empty()) {
@@ -173,7 +224,7 @@ void SocketRpcDriver::exec()
 				closeConnection();
 				return;
 			}
-			onBytesRead(std::string(in, n));
+			onBytesRead(in, static_cast<size_t>(n));
 		}
 
 		//socket ready for writing
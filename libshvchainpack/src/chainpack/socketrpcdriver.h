@@ -24,6 +24,7 @@ protected:
 	void writeMessageBegin() override {}
 	void writeMessageEnd() override {flush();}
 	int64_t writeBytes(const char *bytes, size_t length) override;
+	int64_t writeBuffers(const WriteBuffer *buffers, size_t count) override;
 	//void onProcessReadDataException(std::exception &e) override;
 
 	virtual void idleTaskOnSelectTimeout() {}
@@ -3,18 +3,22 @@
 
 #include "log.h"
 
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
 namespace shv {
 namespace core {
 
-static std::string empty_string;
-
 StringView::StringView()
-	: StringView(empty_string)
+	: StringView("", 0)
 {
 }
 
 StringView::StringView(const StringView &strv)
 	: m_str(strv.m_str)
+	, m_strLength(strv.m_strLength)
 	, m_start(strv.start())
 	, m_length(strv.length())
 {
@@ -26,9 +30,25 @@ StringView::StringView(const std::string &str, size_t start)
 }
 
 StringView::StringView(const std::string &str, size_t start, size_t len)
-	: m_str(&str)
+	: StringView(str.data(), str.size(), start, len)
+{
+}
+
+StringView::StringView(const char *str)
+	: StringView(str, std::strlen(str))
+{
+}
+
+StringView::StringView(const char *str, size_t len)
+	: StringView(str, len, 0, len)
+{
+}
+
+StringView::StringView(const char *str, size_t len, size_t start, size_t view_len)
+	: m_str(str)
+	, m_strLength(len)
 	, m_start(start)
-	, m_length(len)
+	, m_length(view_len)
 {
 	normalize();
 }
@@ -36,6 +56,7 @@ StringView::StringView(const std::string &str, size_t start, size_t len)
 StringView &StringView::operator=(const StringView &o)
 {
 	m_str = o.m_str;
+	m_strLength = o.m_strLength;
 	m_start = o.m_start;
 	m_length = o.m_length;
 	return *this;
@@ -43,18 +64,12 @@ StringView &StringView::operator=(const StringView &o)
 
 bool StringView::operator==(const std::string &o) const
 {
-	return this->operator ==(StringView(o));
+	return length() == o.size() && std::memcmp(data(), o.data(), length()) == 0;
 }
 
 bool StringView::operator==(const StringView &o) const
 {
-	if(length() != o.length())
-		return false;
-	for (size_t i = 0; i < length() && i < o.length(); ++i) {
-		if((*this)[i] != o[i])
-			return false;
-	}
-	return true;
+	return length() == o.length() && std::memcmp(data(), o.data(), length()) == 0;
 }
 
 bool StringView::operator==(const char *o) const
@@ -72,12 +87,14 @@ bool StringView::operator==(const char *o) const
 
 char StringView::operator[](size_t ix) const
 {
-	return str()[m_start + ix];
+	return m_str[m_start + ix];
 }
 
 char StringView::at(size_t ix) const
 {
-	return m_str->at(m_start + ix);
+	if(m_start + ix >= m_strLength)
+		throw std::out_of_range("StringView::at");
+	return m_str[m_start + ix];
 }
 
 char StringView::value(int ix) const
@@ -88,32 +105,32 @@ char StringView::value(int ix) const
 		return 0;
 	if((unsigned)ix >= m_length)
 		return 0;
-	return str()[m_start + ix];
+	return m_str[m_start + ix];
 }
 /*
 size_t StringView::space() const
 {
-	if(m_start + m_length >= m_str->length())
+	if(m_start + m_length >= m_strLength)
 		return 0;
-	return m_str->length() - (m_start + m_length);
+	return m_strLength - (m_start + m_length);
 }
 */
 bool StringView::valid() const
 {
 	if(m_length == 0)
 		return true;
-	return m_start < m_str->length() && (m_start + m_length) <= m_str->length();
+	return m_start < m_strLength && (m_start + m_length) <= m_strLength;
 }
 
 void StringView::normalize()
 {
-	if(m_start >= m_str->length()) {
-		m_start = m_str->length();
+	if(m_start >= m_strLength) {
+		m_start = m_strLength;
 		m_length = 0;
 	}
 	else {
-		if(m_start + m_length > m_str->length()) {
-			m_length = m_str->length() - m_start;
+		if(m_length > m_strLength - m_start) {
+			m_length = m_strLength - m_start;
 		}
 	}
 }
@@ -127,17 +144,12 @@ StringView StringView::normalized() const
 
 std::string StringView::toString() const
 {
-	return m_str->substr(m_start, m_length);
+	return std::string(data(), length());
 }
 
 bool StringView::startsWith(const StringView &str) const
 {
-	size_t i;
-	for (i = 0; i < length() && i < str.length(); ++i) {
-		if((*this)[i] != str[i])
-			return false;
-	}
-	return i == str.length();
+	return length() >= str.length() && std::memcmp(data(), str.data(), str.length()) == 0;
 }
 
 bool StringView::startsWith(char c) const
@@ -147,14 +159,7 @@ bool StringView::startsWith(char c) const
 
 bool StringView::endsWith(const StringView &str) const
 {
-	size_t i;
-	size_t len1 = length();
-	size_t len2 = str.length();
-	for (i = 0; i < len1 && i < len2; ++i) {
-		if((*this)[len1 - 1 - i] != str[len2 - 1 - i])
-			return false;
-	}
-	return i == len2;
+	return length() >= str.length() && std::memcmp(data() + length() - str.length(), str.data(), str.length()) == 0;
 }
 
 bool StringView::endsWith(char c) const
@@ -164,16 +169,16 @@ bool StringView::endsWith(char c) const
 
 ssize_t StringView::indexOf(char c) const
 {
-	for (size_t i = 0; i < length(); i++)
-		if(at(i) == c)
-			return static_cast<ssize_t>(i);
-	return -1;
+	if(empty())
+		return -1;
+	auto *p = static_cast<const char*>(std::memchr(data(), c, length()));
+	return p? p - data(): -1;
 }
 
 ssize_t StringView::lastIndexOf(char c) const
 {
 	for (ssize_t i = static_cast<ssize_t>(length()) - 1; i >= 0; i--)
-		if(at(static_cast<size_t>(i)) == c)
+		if((*this)[static_cast<size_t>(i)] == c)
 			return i;
 	return -1;
 }
@@ -181,7 +186,7 @@ ssize_t StringView::lastIndexOf(char c) const
 StringView StringView::mid(size_t start, size_t len) const
 {
 	//shvWarning() << toString() << start << len;
-	return StringView(str(), this->start() + start, len);
+	return StringView(m_str, m_strLength, this->start() + start, len);
 }
 
 StringView StringView::slice(int start, int end) const
@@ -189,16 +194,16 @@ StringView StringView::slice(int start, int end) const
 	int s = static_cast<int>(this->start()) + start;
 	if(s < 0)
 		s = 0;
-	if(s > (int)m_str->length())
-		s = (int)m_str->length();
+	if(s > (int)m_strLength)
+		s = (int)m_strLength;
 	int e = static_cast<int>(this->start() + length()) + end;
 	if(e < 0)
 		e = 0;
-	if(e > (int)m_str->length())
-		e = (int)m_str->length();
+	if(e > (int)m_strLength)
+		e = (int)m_strLength;
 	if(e < s)
 		e = s;
-	return StringView(str(), (size_t)s, (size_t)(e - s));
+	return StringView(m_str, m_strLength, (size_t)s, (size_t)(e - s));
 }
 
 StringView StringView::getToken(char delim, char quote) const
@@ -207,7 +212,7 @@ StringView StringView::getToken(char delim, char quote) const
 		return *this;
 	bool in_quotes = false;
 	for (size_t i = 0; i < length(); ++i) {
-		char c = at(i);
+		char c = (*this)[i];
 		if(quote) {
 			if(c == quote) {
 				in_quotes = !in_quotes;
@@ -246,7 +251,29 @@ std::vector<StringView> StringView::split(char delim, char quote, StringView::Sp
 
 int StringView::toInt(bool *ok) const
 {
-	return shv::core::String::toInt(toString(), ok);
+	// same result as String::toInt(toString(), ok) without copy and exception on invalid input
+	size_t i = 0;
+	while(i < length() && std::isspace(static_cast<unsigned char>((*this)[i])))
+		i++;
+	bool neg = false;
+	if(i < length() && ((*this)[i] == '-' || (*this)[i] == '+'))
+		neg = (*this)[i++] == '-';
+	const size_t digits_start = i;
+	int64_t n = 0;
+	for (; i < length(); ++i) {
+		char c = (*this)[i];
+		if(c < '0' || c > '9')
+			break;
+		n = n * 10 + (c - '0');
+		if(n > static_cast<int64_t>(std::numeric_limits<int>::max()) + 1)
+			break;
+	}
+	if(neg)
+		n = -n;
+	bool is_ok = i > digits_start && i == length() && n >= std::numeric_limits<int>::min() && n <= std::numeric_limits<int>::max();
+	if(ok)
+		*ok = is_ok;
+	return is_ok? static_cast<int>(n): 0;
 }
 
 std::string StringView::join(std::vector<StringView>::const_iterator first, std::vector<StringView>::const_iterator last, const char delim)
@@ -256,7 +283,7 @@ std::string StringView::join(std::vector<StringView>::const_iterator first, std:
 	while(first != last) {
 		if(i++ > 0)
 			ret += delim;
-		ret += first->toString();
+		ret.append(first->data(), first->length());
 		first++;
 	}
 	return ret;
@@ -269,7 +296,7 @@ std::string StringView::join(std::vector<StringView>::const_iterator first, std:
 	while(first != last) {
 		if(i++ > 0)
 			ret += delim;
-		ret += first->toString();
+		ret.append(first->data(), first->length());
 		first++;
 	}
 	return ret;
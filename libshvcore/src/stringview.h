@@ -5,10 +5,15 @@
 #include <limits>
 #include <string>
 #include <vector>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 namespace shv {
 namespace core {
 
+/// Non-owning view of part of a character buffer, the buffer can be std::string, network frame or memory mapped file.
+/// start() and end() are offsets in the underlying buffer, the view can be widened up to the buffer end by mid() and slice().
 class SHVCORE_DECL_EXPORT StringView
 {
 public:
@@ -19,6 +24,13 @@ public:
 	StringView(const StringView &strv);
 	StringView(const std::string &str, size_t start = 0);
 	StringView(const std::string &str, size_t start, size_t len);
+	StringView(const char *str);
+	StringView(const char *str, size_t len);
+	StringView(const char *str, size_t len, size_t start, size_t view_len);
+#if __cplusplus >= 201703L
+	StringView(std::string_view str) : StringView(str.data(), str.size()) {}
+	operator std::string_view() const {return std::string_view(data(), length());}
+#endif
 
 	StringView& operator=(const StringView &o);
 	bool operator==(const std::string &o) const;
@@ -28,7 +40,10 @@ public:
 	char at(size_t ix) const;
 	char value(int ix) const;
 
-	const std::string &str() const {return *m_str;}
+	/// pointer to the first character of the view, not null terminated
+	const char *data() const {return m_str + m_start;}
+	const char *buffer() const {return m_str;}
+	size_t bufferSize() const {return m_strLength;}
 	size_t start() const {return m_start;}
 	size_t end() const {return m_start + m_length;}
 	void setStart(size_t ix) {m_start = ix;}
@@ -62,7 +77,8 @@ public:
 	static std::string join(std::vector<StringView>::const_iterator first, std::vector<StringView>::const_iterator last, const char delim);
 	static std::string join(std::vector<StringView>::const_iterator first, std::vector<StringView>::const_iterator last, const std::string &delim);
 private:
-	const std::string *m_str;
+	const char *m_str;
+	size_t m_strLength;
 	size_t m_start;
 	size_t m_length;
 };
@@ -0,0 +1,95 @@
+#include "mappedfile.h"
+#include "../exception.h"
+
+#ifdef _WIN32
+#include <fstream>
+#include <sstream>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace shv {
+namespace core {
+namespace utils {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &file_name, Access access)
+{
+	(void)access;
+	std::ifstream in(file_name, std::ios::binary);
+	if(!in)
+		SHV_EXCEPTION("Cannot open file " + file_name + " for reading.");
+	std::ostringstream os;
+	os << in.rdbuf();
+	m_buffer = os.str();
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+}
+
+void MappedFile::prefetch(const std::string &file_name)
+{
+	(void)file_name;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &file_name, Access access)
+{
+	int fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		SHV_EXCEPTION("Cannot open file " + file_name + " for reading, error: " + std::strerror(errno));
+	struct stat st;
+	if(::fstat(fd, &st) < 0) {
+		int err = errno;
+		::close(fd);
+		SHV_EXCEPTION("Cannot stat file " + file_name + ", error: " + std::strerror(err));
+	}
+	m_size = static_cast<size_t>(st.st_size);
+	if(m_size > 0) {
+		void *p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(p == MAP_FAILED) {
+			int err = errno;
+			::close(fd);
+			SHV_EXCEPTION("Cannot map file " + file_name + " to memory, error: " + std::strerror(err));
+		}
+		::madvise(p, m_size, access == Access::Sequential? MADV_SEQUENTIAL: MADV_RANDOM);
+		m_data = static_cast<const char*>(p);
+	}
+	// mapping keeps the file referenced
+	::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if(m_data)
+		::munmap(const_cast<char*>(m_data), m_size);
+}
+
+void MappedFile::prefetch(const std::string &file_name)
+{
+#ifdef POSIX_FADV_WILLNEED
+	int fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		return;
+	::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+	::close(fd);
+#else
+	(void)file_name;
+#endif
+}
+
+#endif
+
+} // namespace utils
+} // namespace core
+} // namespace shv
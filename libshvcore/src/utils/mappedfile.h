@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../shvcoreglobal.h"
+
+#include <string>
+
+namespace shv {
+namespace core {
+namespace utils {
+
+/// Read only view of whole file content mapped to memory.
+/// File content is a snapshot of the file size on open, data appended later is not visible.
+/// Mapped file must not be truncated, access to pages behind new file end kills the process with SIGBUS,
+/// so map files owned by application only, like ShvFileJournal files, which are appended or deleted, never truncated.
+/// Where mmap is not available, file is read to memory instead.
+class SHVCORE_DECL_EXPORT MappedFile
+{
+public:
+	enum class Access {Sequential, Random};
+public:
+	/// throws shv::core::Exception if file cannot be opened
+	explicit MappedFile(const std::string &file_name, Access access = Access::Sequential);
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile& operator=(const MappedFile &) = delete;
+
+	const char* data() const {return m_data;}
+	size_t size() const {return m_size;}
+
+	/// hints OS to start reading file to page cache in background, for file which is going to be read soon
+	static void prefetch(const std::string &file_name);
+private:
+	const char *m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WIN32
+	std::string m_buffer;
+#endif
+};
+
+} // namespace utils
+} // namespace core
+} // namespace shv
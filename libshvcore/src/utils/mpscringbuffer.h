@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace shv {
+namespace core {
+namespace utils {
+
+/// Bounded lock-free queue for many producers and single consumer.
+/// Each cell carries a sequence number telling whether it is free for producer
+/// or ready for consumer (Dmitry Vyukov's bounded queue algorithm).
+template<typename T>
+class MpscRingBuffer
+{
+public:
+	/// capacity is rounded up to power of 2
+	explicit MpscRingBuffer(size_t capacity)
+	{
+		size_t n = 2;
+		while(n < capacity)
+			n <<= 1;
+		m_mask = n - 1;
+		m_cells.reset(new Cell[n]);
+		for(size_t i = 0; i < n; i++)
+			m_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	MpscRingBuffer(const MpscRingBuffer &) = delete;
+	MpscRingBuffer& operator=(const MpscRingBuffer &) = delete;
+
+	size_t capacity() const { return m_mask + 1; }
+
+	/// can be called from any thread, returns false if queue is full, val is not moved then
+	bool tryPush(T &&val)
+	{
+		Cell *cell;
+		size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+		while(true) {
+			cell = &m_cells[pos & m_mask];
+			size_t seq = cell->sequence.load(std::memory_order_acquire);
+			intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if(dif == 0) {
+				if(m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if(dif < 0) {
+				return false;
+			}
+			else {
+				pos = m_enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->data = std::move(val);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+	/// consumer thread only
+	bool tryPop(T &val)
+	{
+		Cell *cell = &m_cells[m_dequeuePos & m_mask];
+		size_t seq = cell->sequence.load(std::memory_order_acquire);
+		if(seq != m_dequeuePos + 1)
+			return false;
+		val = std::move(cell->data);
+		cell->data = T();
+		cell->sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+		m_dequeuePos++;
+		return true;
+	}
+	/// consumer thread only
+	bool isEmpty() const
+	{
+		const Cell *cell = &m_cells[m_dequeuePos & m_mask];
+		return cell->sequence.load(std::memory_order_acquire) != m_dequeuePos + 1;
+	}
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+	std::unique_ptr<Cell[]> m_cells;
+	size_t m_mask = 0;
+	std::atomic<size_t> m_enqueuePos{0};
+	size_t m_dequeuePos = 0;
+};
+
+} // namespace utils
+} // namespace core
+} // namespace shv
@@ -1,8 +1,11 @@
 #include "shvfilejournal.h"
 
+#include "mappedfile.h"
+#include "mpscringbuffer.h"
 #include "patternmatcher.h"
 #include "shvjournalfilewriter.h"
 #include "shvjournalfilereader.h"
+#include "shvlogcolumns.h"
 #include "shvlogheader.h"
 #include "shvpath.h"
 
@@ -17,6 +20,13 @@
 #include <sstream>
 #include <algorithm>
 #include <regex>
+#include <cstdlib>
+#include <thread>
+#include <limits>
+#include <list>
+#include <unordered_map>
+#include <condition_variable>
+#include <atomic>
 #include <dirent.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -99,6 +109,26 @@ static bool file_exists(const std::string &file_name)
 	return (SHV_STAT(file_name.data(), &st) == 0);
 }
 */
+static int64_t file_size_if_exists(const std::string &file_name)
+{
+	SHV_STATBUF st;
+	if(SHV_STAT(file_name.data(), &st) == 0)
+		return st.st_size;
+	return -1;
+}
+
+static int64_t dir_mtime_nsec(const std::string &dir_name)
+{
+	SHV_STATBUF st;
+	if(SHV_STAT(dir_name.data(), &st) != 0)
+		return -1;
+#ifdef __linux__
+	return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000 * 1000 * 1000 + st.st_mtim.tv_nsec;
+#else
+	return static_cast<int64_t>(st.st_mtime) * 1000 * 1000 * 1000;
+#endif
+}
+
 static int64_t rm_file(const std::string &file_name)
 {
 	int64_t sz = file_size(file_name);
@@ -125,6 +155,317 @@ static int64_t str_to_size(const std::string &str)
 }
 
 const std::string ShvFileJournal::FILE_EXT = ".log2";
+const std::string ShvFileJournal::CHECKPOINT_INDEX_EXT = ".idx";
+const std::string ShvFileJournal::MANIFEST_DIR_NAME = ".manifest";
+const std::string ShvFileJournal::MANIFEST_FILE_NAME = "journal.manifest";
+
+namespace {
+/**
+Snapshot checkpoint index file contains one line per checkpoint
+<journal file pos>\t<msec of last entry before file pos>\t<CPON list of snapshot entries>
+Index is appended after journal data are flushed, so checkpoint cannot point behind journal data on disk
+*/
+struct SnapshotCheckpoint
+{
+	int64_t filePos = -1;
+	int64_t msec = 0;
+	std::string snapshotCpon;
+};
+
+std::string checkpoint_index_file_name(const std::string &journal_file_name)
+{
+	return journal_file_name + ShvFileJournal::CHECKPOINT_INDEX_EXT;
+}
+
+bool find_snapshot_checkpoint(const std::string &journal_file_name, int64_t since_msec, SnapshotCheckpoint &checkpoint)
+{
+	std::ifstream in(checkpoint_index_file_name(journal_file_name), std::ios::in | std::ios::binary);
+	if(!in)
+		return false;
+	bool found = false;
+	std::string line;
+	while(std::getline(in, line)) {
+		if(in.eof()) {
+			// truncated last line
+			break;
+		}
+		auto tab1 = line.find(ShvFileJournal::FIELD_SEPARATOR);
+		auto tab2 = tab1 == std::string::npos? tab1: line.find(ShvFileJournal::FIELD_SEPARATOR, tab1 + 1);
+		if(tab2 == std::string::npos) {
+			logWShvJournal() << "Malformed snapshot checkpoint in index of:" << journal_file_name;
+			continue;
+		}
+		int64_t msec = std::strtoll(line.c_str() + tab1 + 1, nullptr, 10);
+		// checkpoints are sorted, entries on since_msec must be replayed from file
+		if(msec >= since_msec)
+			break;
+		checkpoint.filePos = std::strtoll(line.c_str(), nullptr, 10);
+		checkpoint.msec = msec;
+		checkpoint.snapshotCpon = line.substr(tab2 + 1);
+		found = true;
+	}
+	return found;
+}
+}
+
+/**
+LRU cache of getLog() results
+Result of query is valid until an entry is appended into the query time range
+*/
+class ShvFileJournal::GetLogCache
+{
+public:
+	explicit GetLogCache(size_t budget) : m_budget(budget) {}
+
+	size_t budget() const { return m_budget; }
+	void setBudget(size_t budget)
+	{
+		m_budget = budget;
+		evict();
+	}
+	static std::string makeKey(const ShvGetLogParams &params)
+	{
+		// map keys are sorted, so CPON is the same for the same params
+		return params.toRpcValue().toCpon();
+	}
+	bool find(const std::string &key, RpcValue &result)
+	{
+		auto it = m_index.find(key);
+		if(it == m_index.end()) {
+			m_misses++;
+			return false;
+		}
+		std::string err;
+		result = RpcValue::fromChainPack(it->second->data, &err);
+		if(!err.empty()) {
+			remove(it->second);
+			m_misses++;
+			return false;
+		}
+		m_lru.splice(m_lru.begin(), m_lru, it->second);
+		m_hits++;
+		return true;
+	}
+	void insert(const std::string &key, const ShvGetLogParams &params, const RpcValue &result)
+	{
+		auto it = m_index.find(key);
+		if(it != m_index.end())
+			remove(it->second);
+		Entry e;
+		e.key = key;
+		e.data = result.toChainPack();
+		if(params.isSinceLast() || !params.until.isDateTime())
+			e.untilMsec = std::numeric_limits<int64_t>::max();
+		else
+			e.untilMsec = params.until.toDateTime().msecsSinceEpoch();
+		if(entrySize(e) > m_budget)
+			return;
+		m_size += entrySize(e);
+		m_lru.push_front(std::move(e));
+		m_index[key] = m_lru.begin();
+		evict();
+	}
+	/// entry appended on msec can change results of queries with until after msec
+	void invalidate(int64_t msec)
+	{
+		for(auto it = m_lru.begin(); it != m_lru.end(); ) {
+			auto it2 = it++;
+			if(it2->untilMsec >= msec) {
+				remove(it2);
+				m_invalidations++;
+			}
+		}
+	}
+	void clear()
+	{
+		m_invalidations += m_lru.size();
+		m_lru.clear();
+		m_index.clear();
+		m_size = 0;
+	}
+	RpcValue stats() const
+	{
+		return RpcValue::Map {
+			{"hits", static_cast<int64_t>(m_hits)},
+			{"misses", static_cast<int64_t>(m_misses)},
+			{"entries", static_cast<int64_t>(m_lru.size())},
+			{"size", static_cast<int64_t>(m_size)},
+			{"budget", static_cast<int64_t>(m_budget)},
+			{"evictions", static_cast<int64_t>(m_evictions)},
+			{"invalidations", static_cast<int64_t>(m_invalidations)},
+		};
+	}
+private:
+	struct Entry
+	{
+		std::string key;
+		std::string data;
+		int64_t untilMsec = 0;
+	};
+	using EntryList = std::list<Entry>;
+
+	static size_t entrySize(const Entry &e) { return e.key.size() + e.data.size(); }
+	void remove(EntryList::iterator it)
+	{
+		m_size -= entrySize(*it);
+		m_index.erase(it->key);
+		m_lru.erase(it);
+	}
+	void evict()
+	{
+		while(m_size > m_budget && !m_lru.empty()) {
+			remove(std::prev(m_lru.end()));
+			m_evictions++;
+		}
+	}
+private:
+	size_t m_budget;
+	size_t m_size = 0;
+	EntryList m_lru;
+	std::unordered_map<std::string, EntryList::iterator> m_index;
+	uint64_t m_hits = 0;
+	uint64_t m_misses = 0;
+	uint64_t m_evictions = 0;
+	uint64_t m_invalidations = 0;
+};
+
+namespace {
+/**
+Parses journal files in worker threads, so getLog() does not need to wait for file I/O and parsing.
+Files are parsed at most thread count * 2 files ahead of the one currently consumed by getLog(),
+parsing of files after the first entry after 'until' is not started.
+*/
+class JournalFilesParser
+{
+public:
+	JournalFilesParser(const ShvFileJournal::JournalContext &journal_context
+					   , std::vector<int64_t>::const_iterator first_file_it
+					   , std::vector<int64_t>::const_iterator end_file_it
+					   , const ShvGetLogParams &params
+					   , int64_t until_msec
+					   , int thread_count)
+		: m_params(params)
+		, m_untilMsec(until_msec)
+		, m_window(static_cast<size_t>(thread_count) * 2)
+	{
+		for(auto it = first_file_it; it != end_file_it; ++it)
+			m_fileNames.push_back(journal_context.fileMsecToFilePath(*it));
+		m_files.resize(m_fileNames.size());
+		m_endFile = m_fileNames.size();
+		for (int i = 0; i < thread_count; ++i)
+			m_threads.emplace_back(&JournalFilesParser::worker, this);
+	}
+	~JournalFilesParser()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_cond.notify_all();
+		for(auto &th : m_threads)
+			th.join();
+	}
+	/// blocks until file is parsed, files must be taken in order, returns false on read error
+	bool takeFile(size_t ix, std::vector<ShvJournalEntry> &entries)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_cond.wait(lock, [this, ix]() { return m_files[ix].done || ix >= m_endFile; });
+		entries = std::move(m_files[ix].entries);
+		bool ok = m_files[ix].ok;
+		m_consumedFile = ix + 1;
+		lock.unlock();
+		m_cond.notify_all();
+		return ok;
+	}
+private:
+	void worker()
+	{
+		PatternMatcher pattern_matcher(m_params);
+		while(true) {
+			size_t ix;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_cond.wait(lock, [this]() { return m_stop || m_nextFile >= m_endFile || m_nextFile < m_consumedFile + m_window; });
+				if(m_stop || m_nextFile >= m_endFile)
+					return;
+				ix = m_nextFile++;
+			}
+			std::vector<ShvJournalEntry> entries;
+			bool ok = true;
+			bool after_until = false;
+			try {
+				ShvJournalFileReader rd(m_fileNames[ix]);
+				while(!m_stop && rd.next()) {
+					const ShvJournalEntry &e = rd.entry();
+					bool match = m_params.pathPattern.empty() || pattern_matcher.match(e.path, e.domain);
+					if(match)
+						entries.push_back(e);
+					// journal is monotonic, first entry after until finishes log, do not parse the rest
+					if(m_untilMsec > 0 && e.epochMsec >= m_untilMsec) {
+						after_until = true;
+						break;
+					}
+				}
+			}
+			catch (const std::exception &e) {
+				logWShvJournal() << "Cannot read shv journal file:" << m_fileNames[ix] << e.what();
+				ok = false;
+			}
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				ParsedFile &file = m_files[ix];
+				file.entries = std::move(entries);
+				file.ok = ok;
+				file.done = true;
+				if(after_until)
+					m_endFile = std::min(m_endFile, ix + 1);
+			}
+			m_cond.notify_all();
+		}
+	}
+private:
+	struct ParsedFile
+	{
+		std::vector<ShvJournalEntry> entries;
+		bool ok = true;
+		bool done = false;
+	};
+	const ShvGetLogParams &m_params;
+	const int64_t m_untilMsec;
+	const size_t m_window;
+	std::vector<std::string> m_fileNames;
+	std::vector<ParsedFile> m_files;
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	size_t m_nextFile = 0;
+	size_t m_consumedFile = 0;
+	size_t m_endFile = 0;
+	std::atomic<bool> m_stop{false};
+	std::vector<std::thread> m_threads;
+};
+}
+
+struct ShvFileJournal::AsyncWriter
+{
+	explicit AsyncWriter(size_t queue_capacity) : queue(queue_capacity) {}
+
+	MpscRingBuffer<ShvJournalEntry> queue;
+	std::thread thread;
+	/// guards journal state, held by writer thread while it is appending entries
+	std::mutex journalMutex;
+	std::mutex waitMutex;
+	/// writer thread waits for new entries
+	std::condition_variable dataCond;
+	/// producers wait for free space in queue or for written entries
+	std::condition_variable progressCond;
+	std::atomic<bool> writerSleeping{false};
+	std::atomic<bool> stop{false};
+	std::atomic<int> waitingCount{0};
+	std::atomic<uint64_t> enqueuedCount{0};
+	std::atomic<uint64_t> writtenCount{0};
+	/// copy of FlushPolicy::maxPendingMsec, writer thread cannot read m_flushPolicy without journal lock
+	std::atomic<int64_t> idleFlushMsec{1000};
+};
 
 ShvFileJournal::ShvFileJournal(std::string device_id)
 	//, m_appendLogTSNowFn([]() {return RpcValue::DateTime::now().msecsSinceEpoch();})
@@ -133,6 +474,14 @@ ShvFileJournal::ShvFileJournal(std::string device_id)
 	setDeviceId(device_id);
 }
 
+ShvFileJournal::~ShvFileJournal()
+{
+	stopAsyncWriter();
+	closeFileWriter();
+	if(m_manifestEnabled && m_journalContext.isConsistent())
+		saveManifest();
+}
+
 void ShvFileJournal::setJournalDir(std::string s)
 {
 	if(s == m_journalContext.journalDir)
@@ -171,7 +520,203 @@ void ShvFileJournal::setJournalSizeLimit(const std::string &n)
 	setJournalSizeLimit(str_to_size(n));
 }
 
+void ShvFileJournal::setFlushPolicy(const ShvJournalFileWriter::FlushPolicy &policy)
+{
+	auto lock = lockJournal();
+	m_flushPolicy = policy;
+	if(m_asyncWriter)
+		m_asyncWriter->idleFlushMsec = policy.maxPendingMsec > 0? policy.maxPendingMsec: 1000;
+	if(m_fileWriter) {
+		m_fileWriter->setFlushPolicy(policy);
+		flushFileWriter();
+	}
+}
+
+void ShvFileJournal::flush()
+{
+	auto lock = lockJournal();
+	flushFileWriter();
+}
+
+void ShvFileJournal::setGetLogCacheBudget(size_t budget_bytes)
+{
+	auto lock = lockJournal();
+	if(budget_bytes == 0)
+		m_getLogCache.reset();
+	else if(m_getLogCache)
+		m_getLogCache->setBudget(budget_bytes);
+	else
+		m_getLogCache.reset(new GetLogCache(budget_bytes));
+}
+
+size_t ShvFileJournal::getLogCacheBudget() const
+{
+	return m_getLogCache? m_getLogCache->budget(): 0;
+}
+
+chainpack::RpcValue ShvFileJournal::getLogCacheStats()
+{
+	auto lock = lockJournal();
+	if(m_getLogCache)
+		return m_getLogCache->stats();
+	return GetLogCache(0).stats();
+}
+
+void ShvFileJournal::flushFileWriter()
+{
+	if(m_fileWriter)
+		m_fileWriter->flush();
+}
+
+ShvJournalFileWriter &ShvFileJournal::fileWriter(int64_t journal_file_start_msec)
+{
+	if(!m_fileWriter || m_fileWriterStartMsec != journal_file_start_msec) {
+		closeFileWriter();
+		m_fileWriter.reset(new ShvJournalFileWriter(journalDir(), journal_file_start_msec, m_journalContext.recentTimeStamp));
+		m_fileWriter->setFlushPolicy(m_flushPolicy);
+		m_fileWriterStartMsec = journal_file_start_msec;
+	}
+	return *m_fileWriter;
+}
+
+void ShvFileJournal::closeFileWriter()
+{
+	if(!m_fileWriter)
+		return;
+	// writer destructor flushes pending data
+	m_fileWriter.reset();
+	m_fileWriterStartMsec = 0;
+}
+
 void ShvFileJournal::append(const ShvJournalEntry &entry)
+{
+	if(m_asyncWriter) {
+		enqueue(entry);
+		return;
+	}
+	appendSync(entry);
+}
+
+void ShvFileJournal::startAsyncWriter(size_t queue_capacity)
+{
+	if(m_asyncWriter)
+		return;
+	logMShvJournal() << "Starting async journal writer, queue capacity:" << queue_capacity;
+	m_asyncWriter.reset(new AsyncWriter(queue_capacity));
+	if(m_flushPolicy.maxPendingMsec > 0)
+		m_asyncWriter->idleFlushMsec = m_flushPolicy.maxPendingMsec;
+	m_asyncWriter->thread = std::thread(&ShvFileJournal::asyncWriterLoop, this);
+}
+
+void ShvFileJournal::stopAsyncWriter()
+{
+	if(!m_asyncWriter)
+		return;
+	logMShvJournal() << "Stopping async journal writer";
+	{
+		std::lock_guard<std::mutex> lock(m_asyncWriter->waitMutex);
+		m_asyncWriter->stop = true;
+		m_asyncWriter->dataCond.notify_one();
+	}
+	m_asyncWriter->thread.join();
+	m_asyncWriter.reset();
+}
+
+void ShvFileJournal::enqueue(const ShvJournalEntry &entry)
+{
+	AsyncWriter &aw = *m_asyncWriter;
+	ShvJournalEntry e = entry;
+	// entry time is time of append() call, not the time when it is written
+	if(e.epochMsec == 0)
+		e.epochMsec = RpcValue::DateTime::now().msecsSinceEpoch();
+	while(!aw.queue.tryPush(std::move(e))) {
+		// queue is full, slow down producer
+		aw.waitingCount++;
+		std::unique_lock<std::mutex> lock(aw.waitMutex);
+		aw.dataCond.notify_one();
+		aw.progressCond.wait_for(lock, std::chrono::milliseconds(10));
+		aw.waitingCount--;
+	}
+	aw.enqueuedCount++;
+	// pairs with fence in asyncWriterLoop(), either we see writer sleeping or writer sees the entry
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(aw.writerSleeping) {
+		std::lock_guard<std::mutex> lock(aw.waitMutex);
+		aw.dataCond.notify_one();
+	}
+}
+
+void ShvFileJournal::asyncWriterLoop()
+{
+	AsyncWriter &aw = *m_asyncWriter;
+	ShvJournalEntry entry;
+	while(true) {
+		size_t n = 0;
+		{
+			std::lock_guard<std::mutex> lock(aw.journalMutex);
+			// limit batch size to let getLog() in
+			while(n < aw.queue.capacity() && aw.queue.tryPop(entry)) {
+				appendSync(entry);
+				aw.writtenCount++;
+				n++;
+			}
+		}
+		if(n > 0 && aw.waitingCount > 0) {
+			std::lock_guard<std::mutex> lock(aw.waitMutex);
+			aw.progressCond.notify_all();
+		}
+		if(n > 0)
+			continue;
+		if(aw.stop)
+			break;
+		bool idle = false;
+		{
+			std::unique_lock<std::mutex> lock(aw.waitMutex);
+			aw.writerSleeping = true;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(aw.queue.isEmpty() && !aw.stop) {
+				idle = aw.dataCond.wait_for(lock, std::chrono::milliseconds(aw.idleFlushMsec.load())) == std::cv_status::timeout;
+			}
+			aw.writerSleeping = false;
+		}
+		if(idle) {
+			// nothing appended for a while, write pending entries
+			std::lock_guard<std::mutex> lock(aw.journalMutex);
+			try {
+				flushFileWriter();
+			}
+			catch (std::exception &e) {
+				logWShvJournal() << "Flush journal failed:" << e.what();
+			}
+		}
+	}
+	std::lock_guard<std::mutex> lock(aw.journalMutex);
+	try {
+		flushFileWriter();
+	}
+	catch (std::exception &e) {
+		logWShvJournal() << "Flush journal failed:" << e.what();
+	}
+}
+
+std::unique_lock<std::mutex> ShvFileJournal::lockJournal()
+{
+	if(!m_asyncWriter)
+		return std::unique_lock<std::mutex>();
+	AsyncWriter &aw = *m_asyncWriter;
+	uint64_t enqueued_cnt = aw.enqueuedCount;
+	if(aw.writtenCount < enqueued_cnt) {
+		aw.waitingCount++;
+		std::unique_lock<std::mutex> lock(aw.waitMutex);
+		aw.dataCond.notify_one();
+		while(aw.writtenCount < enqueued_cnt)
+			aw.progressCond.wait_for(lock, std::chrono::milliseconds(10));
+		aw.waitingCount--;
+	}
+	return std::unique_lock<std::mutex>(aw.journalMutex);
+}
+
+void ShvFileJournal::appendSync(const ShvJournalEntry &entry)
 {
 	try {
 		appendThrow(entry);
@@ -218,13 +763,20 @@ void ShvFileJournal::appendThrow(const ShvJournalEntry &entry)
 
 	if(addToSnapshot(m_snapshot, e)) {
 		// log only not-default changes or changes from not-default to default
-		ShvJournalFileWriter wr(journalDir(), journal_file_start_msec, m_journalContext.recentTimeStamp);
+		ShvJournalFileWriter &wr = fileWriter(journal_file_start_msec);
 		ssize_t orig_fsz = wr.fileSize();
 		wr.appendMonotonic(e);
 		m_journalContext.recentTimeStamp = wr.recentTimeStamp();
 		ssize_t new_fsz = wr.fileSize();
+		if(m_getLogCache)
+			m_getLogCache->invalidate(m_journalContext.recentTimeStamp);
 		m_journalContext.lastFileSize = new_fsz;
 		m_journalContext.journalSize += new_fsz - orig_fsz;
+		if(m_snapshotCheckpointInterval > 0
+				&& journal_file_start_msec == m_checkpointFileMsec
+				&& new_fsz - m_lastCheckpointFileSize >= m_snapshotCheckpointInterval) {
+			writeSnapshotCheckpoint(wr);
+		}
 		if(m_journalContext.journalSize > m_journalSizeLimit) {
 			rotateJournal();
 		}
@@ -239,13 +791,58 @@ void ShvFileJournal::createNewLogFile(int64_t journal_file_start_msec)
 		if(!m_journalContext.files.empty() && m_journalContext.files[m_journalContext.files.size() - 1] >= journal_file_start_msec)
 			SHV_EXCEPTION("Journal context corrupted, new log file is older than last existing one.");
 	}
-	ShvJournalFileWriter wr(journalDir(), journal_file_start_msec, journal_file_start_msec);
+	if(!m_journalContext.files.empty()) {
+		JournalFileInfo &closed_file = m_fileInfos[m_journalContext.files[m_journalContext.files.size() - 1]];
+		closed_file.size = m_journalContext.lastFileSize;
+		closed_file.lastEntryMsec = m_journalContext.recentTimeStamp;
+	}
+	m_journalContext.recentTimeStamp = journal_file_start_msec;
+	ShvJournalFileWriter &wr = fileWriter(journal_file_start_msec);
 	logMShvJournal() << "New log file:" << wr.fileName() << "created.";
 	// new file should start with snapshot
 	logDShvJournal() << "Writing snapshot, entries count:" << m_snapshot.keyvals.size();
+	ssize_t orig_fsz = wr.fileSize();
 	wr.appendSnapshot(journal_file_start_msec, m_snapshot.keyvals);
 	m_journalContext.files.push_back(journal_file_start_msec);
-	m_journalContext.recentTimeStamp = journal_file_start_msec;
+	m_journalContext.lastFileSize = wr.fileSize();
+	m_journalContext.journalSize += wr.fileSize() - orig_fsz;
+	m_checkpointFileMsec = journal_file_start_msec;
+	m_lastCheckpointFileSize = wr.fileSize();
+	if(m_manifestEnabled)
+		saveManifest();
+}
+
+void ShvFileJournal::writeSnapshotCheckpoint(ShvJournalFileWriter &wr)
+{
+	wr.flush();
+	RpcValue::List entries;
+	for(const auto &kv : m_snapshot.keyvals) {
+		ShvJournalEntry e = kv.second;
+		// the same time as in file snapshot
+		if(e.epochMsec < m_checkpointFileMsec)
+			e.epochMsec = m_checkpointFileMsec;
+		entries.push_back(e.toRpcValueMap());
+	}
+	std::string line = std::to_string(wr.fileSize());
+	line += FIELD_SEPARATOR;
+	line += std::to_string(wr.recentTimeStamp());
+	line += FIELD_SEPARATOR;
+	line += RpcValue(std::move(entries)).toCpon();
+	line += RECORD_SEPARATOR;
+	std::string fn = checkpoint_index_file_name(wr.fileName());
+	bool new_index_file = file_size_if_exists(fn) < 0;
+	{
+		std::ofstream out(fn, std::ios::binary | std::ios::out | std::ios::app);
+		out << line;
+		out.flush();
+		if(!out)
+			SHV_EXCEPTION("Cannot write snapshot checkpoint to file " + fn);
+	}
+	logDShvJournal() << "Snapshot checkpoint written, file pos:" << wr.fileSize() << "entries count:" << m_snapshot.keyvals.size();
+	m_journalContext.journalSize += static_cast<int64_t>(line.size());
+	m_lastCheckpointFileSize = wr.fileSize();
+	if(new_index_file && m_manifestEnabled)
+		saveManifest();
 }
 
 int64_t ShvFileJournal::JournalContext::fileNameToFileMsec(const std::string &fn)
@@ -273,12 +870,22 @@ void ShvFileJournal::checkJournalContext_helper(bool force)
 {
 	if(!m_journalContext.isConsistent() || force) {
 		logMShvJournal() << "journal context not consistent or check forced, check forced:" << force;
+		closeFileWriter();
+		m_checkpointFileMsec = 0;
+		if(m_getLogCache)
+			m_getLogCache->clear();
 		m_journalContext.recentTimeStamp = 0;
 		m_journalContext.journalDirExists = journalDirExists();
 		if(!m_journalContext.journalDirExists)
 			ensureJournalDir();
-		if(m_journalContext.journalDirExists)
-			updateJournalStatus();
+		if(m_journalContext.journalDirExists) {
+			// forced check means that journal dir content cannot be trusted
+			if(force || !m_manifestEnabled || !loadManifest()) {
+				updateJournalStatus();
+				if(m_manifestEnabled)
+					saveManifest();
+			}
+		}
 		else
 			shvWarning() << "Journal dir:" << journalDir() << "does not exist!";
 		if(m_journalContext.isConsistent())
@@ -307,10 +914,15 @@ bool ShvFileJournal::journalDirExists()
 void ShvFileJournal::rotateJournal()
 {
 	logMShvJournal() << "Rotating journal of size:" << m_journalContext.journalSize;
-	updateJournalStatus();
-	size_t file_cnt = m_journalContext.files.size();
-	for(int64_t file_msec : m_journalContext.files) {
-		if(file_cnt == 1) {
+	flushFileWriter();
+	if(m_getLogCache)
+		m_getLogCache->clear();
+	// journal size is tracked incrementally, do not rescan journal dir
+	std::vector<int64_t> &files = m_journalContext.files;
+	size_t rm_cnt = 0;
+	bool rm_error = false;
+	for(int64_t file_msec : files) {
+		if(files.size() - rm_cnt == 1) {
 			/// keep at least one file in case of bad limits configuration
 			break;
 		}
@@ -318,10 +930,24 @@ void ShvFileJournal::rotateJournal()
 			break;
 		std::string fn = m_journalContext.fileMsecToFilePath(file_msec);
 		logMShvJournal() << "\t deleting file:" << fn;
-		m_journalContext.journalSize -= rm_file(fn);
-		file_cnt--;
+		int64_t sz = file_size_if_exists(fn);
+		int64_t rm_sz = rm_file(fn);
+		if(sz > 0 && rm_sz == 0)
+			rm_error = true;
+		m_journalContext.journalSize -= rm_sz;
+		std::string index_fn = checkpoint_index_file_name(fn);
+		if(file_size_if_exists(index_fn) >= 0)
+			m_journalContext.journalSize -= rm_file(index_fn);
+		m_fileInfos.erase(file_msec);
+		rm_cnt++;
 	}
-	updateJournalStatus();
+	files.erase(files.begin(), files.begin() + static_cast<std::ptrdiff_t>(rm_cnt));
+	if(rm_error) {
+		// some file cannot be deleted, read real journal dir state
+		updateJournalStatus();
+	}
+	if(m_manifestEnabled)
+		saveManifest();
 	logMShvJournal() << "New journal of size:" << m_journalContext.journalSize;
 }
 
@@ -395,17 +1021,25 @@ void ShvFileJournal::updateJournalStatus()
 	m_journalContext.journalSize = 0;
 	m_journalContext.lastFileSize = 0;
 	m_journalContext.files.clear();
+	m_fileInfos.clear();
 	int64_t max_file_msec = -1;
 	DIR *dir;
 	struct dirent *ent;
 	if ((dir = opendir (m_journalContext.journalDir.c_str())) != nullptr) {
 		m_journalContext.journalSize = 0;
 		const std::string &ext = FILE_EXT;
+		const std::string checkpoint_index_ext = FILE_EXT + CHECKPOINT_INDEX_EXT;
 		while ((ent = readdir (dir)) != nullptr) {
 #ifdef DIRENT_HAS_TYPE_FIELD
 			if(ent->d_type == DT_REG) {
 #endif
 				std::string fn = ent->d_name;
+				if(shv::core::String::endsWith(fn, checkpoint_index_ext)) {
+					int64_t sz = file_size(m_journalContext.journalDir + '/' + fn);
+					if(sz > 0)
+						m_journalContext.journalSize += sz;
+					continue;
+				}
 				if(!shv::core::String::endsWith(fn, ext))
 					continue;
 				try {
@@ -413,6 +1047,7 @@ void ShvFileJournal::updateJournalStatus()
 					m_journalContext.files.push_back(msec);
 					fn = m_journalContext.journalDir + '/' + fn;
 					int64_t sz = file_size(fn);
+					m_fileInfos[msec].size = sz;
 					if(msec > max_file_msec) {
 						max_file_msec = msec;
 						m_journalContext.lastFileSize = sz;
@@ -441,6 +1076,117 @@ void ShvFileJournal::updateJournalStatus()
 		SHV_EXCEPTION("Cannot read content of dir: " + m_journalContext.journalDir);
 	}
 }
+/**
+Manifest is rewritten in place after every change of journal dir content made by journal itself,
+rewriting existing file does not change dir modification time, so it can be stored in manifest.
+Manifest is valid if dir modification time is the same as stored one.
+Last file can be appended after manifest is saved, its size is read from file system always.
+*/
+bool ShvFileJournal::loadManifest()
+{
+	const std::string fn = journalDir() + '/' + MANIFEST_DIR_NAME + '/' + MANIFEST_FILE_NAME;
+	std::ifstream in(fn, std::ios::in | std::ios::binary);
+	if(!in)
+		return false;
+	std::string cpon((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	std::string err;
+	RpcValue rv = RpcValue::fromCpon(cpon, &err);
+	if(!err.empty()) {
+		logWShvJournal() << "Invalid journal manifest:" << fn << "error:" << err;
+		return false;
+	}
+	const RpcValue::Map &m = rv.asMap();
+	if(m.value("version").toInt() != 1)
+		return false;
+	if(m.value("dirMTime").toInt64() != dir_mtime_nsec(journalDir())) {
+		logMShvJournal() << "Journal dir was modified after manifest was saved";
+		return false;
+	}
+	std::vector<int64_t> files;
+	std::map<int64_t, JournalFileInfo> file_infos;
+	for(const RpcValue &rv_file : m.value("files").asList()) {
+		const RpcValue::List &lst = rv_file.asList();
+		int64_t file_msec = lst.value(0).toInt64();
+		if(file_msec <= 0 || (!files.empty() && file_msec <= files[files.size() - 1])) {
+			logWShvJournal() << "Invalid journal manifest:" << fn << "file list corrupted";
+			return false;
+		}
+		files.push_back(file_msec);
+		JournalFileInfo &info = file_infos[file_msec];
+		info.size = lst.value(1).toInt64();
+		info.lastEntryMsec = lst.value(2).toInt64();
+	}
+	int64_t journal_size = m.value("journalSize").toInt64();
+	int64_t last_file_size = 0;
+	int64_t recent_time_stamp = 0;
+	if(!files.empty()) {
+		int64_t last_file_msec = files[files.size() - 1];
+		const JournalFileInfo &info = file_infos[last_file_msec];
+		std::string last_fn = m_journalContext.fileMsecToFilePath(last_file_msec);
+		last_file_size = file_size_if_exists(last_fn);
+		if(last_file_size < 0)
+			return false;
+		journal_size += last_file_size - info.size;
+		int64_t index_size = file_size_if_exists(checkpoint_index_file_name(last_fn));
+		journal_size += std::max(index_size, int64_t(0)) - m.value("lastFileIndexSize").toInt64();
+		// last entry time stamp is valid only if nothing was appended after manifest was saved
+		if(last_file_size == info.size)
+			recent_time_stamp = info.lastEntryMsec;
+	}
+	m_journalContext.files = std::move(files);
+	m_fileInfos = std::move(file_infos);
+	m_journalContext.journalSize = journal_size;
+	m_journalContext.lastFileSize = last_file_size;
+	m_journalContext.recentTimeStamp = recent_time_stamp;
+	logMShvJournal() << "Journal manifest loaded, files count:" << m_journalContext.files.size() << "journal size:" << journal_size;
+	return true;
+}
+
+void ShvFileJournal::saveManifest()
+{
+	const std::string manifest_dir = journalDir() + '/' + MANIFEST_DIR_NAME;
+	// creating of manifest dir changes journal dir modification time, create it before the time is read
+	if(!mkpath(manifest_dir)) {
+		logWShvJournal() << "Cannot create journal manifest dir:" << manifest_dir;
+		return;
+	}
+	int64_t dir_mtime = dir_mtime_nsec(journalDir());
+	RpcValue::List files;
+	int64_t last_file_index_size = 0;
+	for(int64_t file_msec : m_journalContext.files) {
+		JournalFileInfo info = m_fileInfos[file_msec];
+		if(file_msec == m_journalContext.files[m_journalContext.files.size() - 1]) {
+			info.size = m_journalContext.lastFileSize;
+			info.lastEntryMsec = m_journalContext.recentTimeStamp;
+			last_file_index_size = std::max(file_size_if_exists(checkpoint_index_file_name(m_journalContext.fileMsecToFilePath(file_msec))), int64_t(0));
+		}
+		files.push_back(RpcValue::List{file_msec, info.size, info.lastEntryMsec});
+	}
+	RpcValue::Map m;
+	m["version"] = 1;
+	m["dirMTime"] = dir_mtime;
+	m["journalSize"] = m_journalContext.journalSize;
+	m["lastFileIndexSize"] = last_file_index_size;
+	m["files"] = std::move(files);
+	// write temporary file and rename it, crash during write cannot leave truncated manifest then
+	const std::string fn = manifest_dir + '/' + MANIFEST_FILE_NAME;
+	const std::string tmp_fn = fn + ".tmp";
+	{
+		std::ofstream out(tmp_fn, std::ios::binary | std::ios::out | std::ios::trunc);
+		out << RpcValue(std::move(m)).toCpon();
+		out.flush();
+		if(!out) {
+			logWShvJournal() << "Cannot write journal manifest:" << tmp_fn;
+			SHV_REMOVE_FILE(tmp_fn.c_str());
+			return;
+		}
+	}
+	if(std::rename(tmp_fn.c_str(), fn.c_str())) {
+		logWShvJournal() << "Cannot rename:" << tmp_fn << "to:" << fn;
+		SHV_REMOVE_FILE(tmp_fn.c_str());
+	}
+}
+
 /*
 int64_t ShvFileJournal::lastEntryTimeStamp()
 {
@@ -578,13 +1324,26 @@ const ShvFileJournal::JournalContext &ShvFileJournal::checkJournalContext(bool f
 
 chainpack::RpcValue ShvFileJournal::getLog(const ShvGetLogParams &params)
 {
+	auto lock = lockJournal();
+	flushFileWriter();
 	JournalContext ctx = checkJournalContext();
+	if(m_getLogCache) {
+		std::string key = GetLogCache::makeKey(params);
+		RpcValue ret;
+		if(m_getLogCache->find(key, ret)) {
+			logMShvJournal() << "getLog result found in cache";
+			return ret;
+		}
+		ret = getLog(ctx, params);
+		m_getLogCache->insert(key, params, ret);
+		return ret;
+	}
 	return getLog(ctx, params);
 }
 
 chainpack::RpcValue ShvFileJournal::getSnapShotMap()
 {
-	std::vector<ShvJournalEntry> snapshot;
+	auto lock = lockJournal();
 	RpcValue::Map m;
 	for(const auto &kv : m_snapshot.keyvals) {
 		const ShvJournalEntry &e = kv.second;
@@ -607,6 +1366,9 @@ chainpack::RpcValue ShvFileJournal::getLog(const ShvFileJournal::JournalContext
 	snapshot_ctx.snapshotWritten = !params.withSnapshot;
 
 	RpcValue::List log;
+	ShvLogColumnsWriter log_columns;
+	int rec_cnt = 0;
+	const bool with_paths_dict = params.withPathsDict || params.columnar;
 	bool since_last = params.isSinceLast();
 
 	RpcValue::Map path_cache;
@@ -622,11 +1384,11 @@ chainpack::RpcValue ShvFileJournal::getLog(const ShvFileJournal::JournalContext
 
 	/// this ensure that there be only one copy of each path in memory
 	int max_path_id = 0;
-	auto make_path_shared = [&path_cache, &max_path_id, &params](const std::string &path) -> RpcValue {
+	auto make_path_shared = [&path_cache, &max_path_id, with_paths_dict](const std::string &path) -> RpcValue {
 		RpcValue ret = path_cache.value(path);
 		if(ret.isValid())
 			return ret;
-		if(params.withPathsDict)
+		if(with_paths_dict)
 			ret = ++max_path_id;
 		else
 			ret = path;
@@ -634,14 +1396,19 @@ chainpack::RpcValue ShvFileJournal::getLog(const ShvFileJournal::JournalContext
 		path_cache[path] = ret;
 		return ret;
 	};
-	auto append_log_entry = [make_path_shared, rec_cnt_limit, &rec_cnt_limit_hit, &first_record_msec, &last_record_msec, &log](const ShvJournalEntry &e) {
-		if((int)log.size() >= rec_cnt_limit) {
+	auto append_log_entry = [make_path_shared, rec_cnt_limit, &rec_cnt, &rec_cnt_limit_hit, &first_record_msec, &last_record_msec, &log, &log_columns, &params](const ShvJournalEntry &e) {
+		if(rec_cnt >= rec_cnt_limit) {
 			rec_cnt_limit_hit = true;
 			return false;
 		}
 		if(first_record_msec == 0)
 			first_record_msec = e.epochMsec;
 		last_record_msec = e.epochMsec;
+		rec_cnt++;
+		if(params.columnar) {
+			log_columns.append(e, e.epochMsec, make_path_shared(e.path).toInt());
+			return true;
+		}
 		RpcValue::List rec;
 		rec.push_back(e.dateTime());
 		rec.push_back(make_path_shared(e.path));
@@ -713,71 +1480,119 @@ chainpack::RpcValue ShvFileJournal::getLog(const ShvFileJournal::JournalContext
 			}
 			return true;
 		};
+		std::set<std::string> not_default_keys_missing_in_snapshot;
+		std::vector<ShvJournalEntry> entries;
+		/// returns false when log is complete
+		auto process_file_entry = [&](const ShvJournalEntry &e1, bool in_snapshot) -> bool {
+			entries.resize(0);
+			entries.push_back(e1);
+			if(in_snapshot) {
+				not_default_keys_missing_in_snapshot.erase(e1.path);
+			}
+			else if(!not_default_keys_missing_in_snapshot.empty()) {
+				/**
+				 * If cabinet is switched off and on again and some property goes to false meanwhile,
+				 * then its property path is present in prev file, but not in this file snapshot.
+				 */
+				for(const auto &path : not_default_keys_missing_in_snapshot) {
+					logDShvJournal() << "\t Setting missing snapshot entry to default value, path:" << path;
+					ShvJournalEntry e2 = snapshot_ctx.snapshot.keyvals[path];
+					e2.value.setDefaultValue();
+					entries.push_back(e2);
+				}
+				not_default_keys_missing_in_snapshot.clear();
+			}
+			for(const ShvJournalEntry &e : entries) {
+				bool before_since = params_since_msec > 0 && e.epochMsec < params_since_msec;
+				bool after_until = params_until_msec > 0 && e.epochMsec >= params_until_msec;
+				if(before_since) {
+					logDShvJournal() << "\t SNAPSHOT entry:" << e.toRpcValueMap().toCpon();
+					addToSnapshot(snapshot_ctx.snapshot, e);
+				}
+				else if(after_until) {
+					return false;
+				}
+				else {
+					if(!snapshot_ctx.snapshotWritten) {
+						if(!write_snapshot())
+							return false;
+					}
+#ifdef SKIP_DUP_LOG_ENTRIES
+					{
+						// skip CHNG duplicates, values that are the same as last log entry for the same path
+						auto it = snapshot_ctx.snapshot.find(e.path);
+						if (it != snapshot_ctx.snapshot.cend()) {
+							if(it->second.value == e.value && e.domain == chainpack::Rpc::SIG_VAL_CHANGED) {
+								logDShvJournal() << "\t Skipping DUP LOG entry:" << e.toRpcValueMap().toCpon();
+								snapshot_ctx.snapshot.erase(it);
+								continue;
+							}
+						}
+					}
+#endif
+					logDShvJournal() << "\t LOG entry:" << e.toRpcValueMap().toCpon();
+					if(!append_log_entry(e))
+						return false;
+				}
+			}
+			return true;
+		};
+		// files following the first one are parsed in advance by worker threads
+		std::unique_ptr<JournalFilesParser> parser;
+		if(journal_context.getLogThreadCount > 1 && std::next(first_file_it) != journal_context.files.end()) {
+			parser.reset(new JournalFilesParser(journal_context, std::next(first_file_it), journal_context.files.end()
+												, params, params_until_msec, journal_context.getLogThreadCount));
+		}
 		for(auto file_it = first_file_it; file_it != journal_context.files.end(); file_it++) {
 			std::string fn = journal_context.fileMsecToFilePath(*file_it);
 			logMShvJournal() << "-------- opening file:" << fn;
+			not_default_keys_missing_in_snapshot.clear();
+			for(const auto &kv : snapshot_ctx.snapshot.keyvals)
+				if(kv.second.domain == Rpc::SIG_VAL_CHANGED)
+					not_default_keys_missing_in_snapshot.insert(kv.first);
+			if(parser && file_it != first_file_it) {
+				std::vector<ShvJournalEntry> file_entries;
+				if(!parser->takeFile(static_cast<size_t>(file_it - first_file_it - 1), file_entries))
+					shvError() << "Cannot read shv journal file:" << fn;
+				for(const ShvJournalEntry &e1 : file_entries) {
+					// the same as ShvJournalFileReader::inSnapshot()
+					if(!process_file_entry(e1, e1.epochMsec == *file_it))
+						goto log_finish;
+				}
+				continue;
+			}
+			if(!parser && std::next(file_it) != journal_context.files.end()) {
+				// let kernel read next file while this one is parsed
+				MappedFile::prefetch(journal_context.fileMsecToFilePath(*std::next(file_it)));
+			}
 			try {
-				std::set<std::string> not_default_keys_missing_in_snapshot;
-				for(const auto &kv : snapshot_ctx.snapshot.keyvals)
-					if(kv.second.domain == Rpc::SIG_VAL_CHANGED)
-						not_default_keys_missing_in_snapshot.insert(kv.first);
-				std::vector<ShvJournalEntry> entries;
 				ShvJournalFileReader rd(fn);
+				SnapshotCheckpoint checkpoint;
+				if(file_it == first_file_it && params_since_msec > 0
+						&& find_snapshot_checkpoint(fn, params_since_msec, checkpoint)
+						&& rd.seek(checkpoint.filePos)) {
+					// state on checkpoint is the same as replaying file from its beginning up to checkpoint file pos
+					std::string err;
+					RpcValue checkpoint_snapshot = RpcValue::fromCpon(checkpoint.snapshotCpon, &err);
+					if(err.empty()) {
+						logMShvJournal() << "\t starting on snapshot checkpoint, file pos:" << checkpoint.filePos;
+						for(const RpcValue &rv : checkpoint_snapshot.asList()) {
+							ShvJournalEntry e = ShvJournalEntry::fromRpcValueMap(rv.asMap());
+							if(path_match(e))
+								addToSnapshot(snapshot_ctx.snapshot, e);
+						}
+					}
+					else {
+						logWShvJournal() << "Invalid snapshot checkpoint in index of:" << fn << "error:" << err;
+						rd.seek(0);
+					}
+				}
 				while(rd.next()) {
 					const ShvJournalEntry &e1 = rd.entry();
 					if(!path_match(e1))
 						continue;
-					entries.resize(0);
-					entries.push_back(e1);
-					if(rd.inSnapshot()) {
-						not_default_keys_missing_in_snapshot.erase(e1.path);
-					}
-					else if(!not_default_keys_missing_in_snapshot.empty()) {
-						/**
-						 * If cabinet is switched off and on again and some property goes to false meanwhile,
-						 * then its property path is present in prev file, but not in this file snapshot.
-						 */
-						for(const auto &path : not_default_keys_missing_in_snapshot) {
-							logDShvJournal() << "\t Setting missing snapshot entry to default value, path:" << path;
-							ShvJournalEntry e2 = snapshot_ctx.snapshot.keyvals[path];
-							e2.value.setDefaultValue();
-							entries.push_back(e2);
-						}
-						not_default_keys_missing_in_snapshot.clear();
-					}
-					for(const ShvJournalEntry &e : entries) {
-						bool before_since = params_since_msec > 0 && e.epochMsec < params_since_msec;
-						bool after_until = params_until_msec > 0 && e.epochMsec >= params_until_msec;
-						if(before_since) {
-							logDShvJournal() << "\t SNAPSHOT entry:" << e.toRpcValueMap().toCpon();
-							addToSnapshot(snapshot_ctx.snapshot, e);
-						}
-						else if(after_until) {
-							goto log_finish;
-						}
-						else {
-							if(!snapshot_ctx.snapshotWritten) {
-								if(!write_snapshot())
-									goto log_finish;
-							}
-	#ifdef SKIP_DUP_LOG_ENTRIES
-							{
-								// skip CHNG duplicates, values that are the same as last log entry for the same path
-								auto it = snapshot_ctx.snapshot.find(e.path);
-								if (it != snapshot_ctx.snapshot.cend()) {
-									if(it->second.value == e.value && e.domain == chainpack::Rpc::SIG_VAL_CHANGED) {
-										logDShvJournal() << "\t Skipping DUP LOG entry:" << e.toRpcValueMap().toCpon();
-										snapshot_ctx.snapshot.erase(it);
-										continue;
-									}
-								}
-							}
-	#endif
-							logDShvJournal() << "\t LOG entry:" << e.toRpcValueMap().toCpon();
-							if(!append_log_entry(e))
-								goto log_finish;
-						}
-					}
+					if(!process_file_entry(e1, rd.inSnapshot()))
+						goto log_finish;
 				}
 			}
 			catch (const shv::core::Exception &e) {
@@ -804,7 +1619,7 @@ log_finish:
 	if(params_until_msec == 0 || rec_cnt_limit_hit) {
 		log_until_msec = last_record_msec;
 	}
-	RpcValue ret = log;
+	RpcValue ret = params.columnar? log_columns.takeColumns(): RpcValue(std::move(log));
 	ShvLogHeader log_header;
 	{
 		log_header.setDeviceId(journal_context.deviceId);
@@ -813,11 +1628,11 @@ log_finish:
 		log_header.setLogParams(params);
 		log_header.setSince((log_since_msec > 0)? RpcValue(RpcValue::DateTime::fromMSecsSinceEpoch(log_since_msec)): RpcValue(nullptr));
 		log_header.setUntil((log_until_msec > 0)? RpcValue(RpcValue::DateTime::fromMSecsSinceEpoch(log_until_msec)): RpcValue(nullptr));
-		log_header.setRecordCount((int)log.size());
+		log_header.setRecordCount(rec_cnt);
 		log_header.setRecordCountLimit(rec_cnt_limit);
 		log_header.setRecordCountLimitHit(rec_cnt_limit_hit);
 		log_header.setWithSnapShot(params.withSnapshot);
-		log_header.setWithPathsDict(params.withPathsDict);
+		log_header.setWithPathsDict(with_paths_dict);
 
 		using Column = ShvLogHeader::Column;
 		RpcValue::List fields;
@@ -830,7 +1645,7 @@ log_finish:
 		fields.push_back(RpcValue::Map{{KEY_NAME, Column::name(Column::Enum::UserId)}});
 		log_header.setFields(std::move(fields));
 	}
-	if(params.withPathsDict) {
+	if(with_paths_dict) {
 		logMShvJournal() << "Generating paths dict size:" << path_cache.size();
 		RpcValue::IMap path_dict;
 		for(auto kv : path_cache) {
@@ -843,7 +1658,7 @@ log_finish:
 		log_header.setTypeInfo(journal_context.typeInfo);
 	}
 	ret.setMetaData(log_header.toMetaData());
-	logIShvJournal() << "result record cnt:" << log.size();
+	logIShvJournal() << "result record cnt:" << rec_cnt;
 	return ret;
 }
 
@@ -6,8 +6,11 @@
 #include "abstractshvjournal.h"
 #include "shvjournalentry.h"
 #include "shvgetlogparams.h"
+#include "shvjournalfilewriter.h"
 
 #include <functional>
+#include <memory>
+#include <mutex>
 
 namespace shv {
 namespace core {
@@ -20,12 +23,18 @@ public:
 	static constexpr long DEFAULT_JOURNAL_SIZE_LIMIT = 100 * DEFAULT_FILE_SIZE_LIMIT;
 	static constexpr char FIELD_SEPARATOR = '\t';
 	static constexpr char RECORD_SEPARATOR = '\n';
+	static constexpr size_t DEFAULT_ASYNC_QUEUE_CAPACITY = 4096;
 	static const std::string FILE_EXT;
+	static const std::string CHECKPOINT_INDEX_EXT;
+	/// manifest is kept in subdirectory, so it can be replaced atomically without changing journal dir modification time
+	static const std::string MANIFEST_DIR_NAME;
+	static const std::string MANIFEST_FILE_NAME;
 public:
 	using SnapShot = std::vector<ShvJournalEntry>;
 	using TSNowFn = std::function<int64_t ()>;
 
 	ShvFileJournal(std::string device_id);
+	~ShvFileJournal() override;
 
 	void setJournalDir(std::string s);
 	const std::string& journalDir();
@@ -42,6 +51,37 @@ public:
 	std::string deviceType() const { return m_journalContext.deviceType; }
 	void setDeviceType(std::string type) { m_journalContext.deviceType = std::move(type); }
 	int64_t recentlyWrittenEntryDateTime() const { return m_journalContext.recentTimeStamp; }
+	void setGetLogThreadCount(int n) { m_journalContext.getLogThreadCount = n; }
+	int getLogThreadCount() const { return m_journalContext.getLogThreadCount; }
+	/// current journal file is kept open, entries are written according to flush policy
+	void setFlushPolicy(const ShvJournalFileWriter::FlushPolicy &policy);
+	const ShvJournalFileWriter::FlushPolicy& flushPolicy() const { return m_flushPolicy; }
+	/// write pending entries, should be called periodically when maxPendingMsec is set
+	void flush();
+
+	/// write snapshot checkpoint to the journal file sidecar index every n bytes of the file, 0 means disabled,
+	/// getLog() with since parameter then replays journal file from the nearest checkpoint only
+	void setSnapshotCheckpointInterval(int64_t n) { m_snapshotCheckpointInterval = n; }
+	int64_t snapshotCheckpointInterval() const { return m_snapshotCheckpointInterval; }
+
+	/// keep journal files list in manifest file, journal dir is not scanned on start then, if it was not modified meanwhile
+	void setManifestEnabled(bool b) { m_manifestEnabled = b; }
+	bool isManifestEnabled() const { return m_manifestEnabled; }
+
+	/// cache getLog() results encoded as ChainPack up to budget bytes, least recently used results are evicted,
+	/// results are invalidated when an entry is appended inside their time range, 0 disables cache
+	void setGetLogCacheBudget(size_t budget_bytes);
+	size_t getLogCacheBudget() const;
+	/// {"hits": int, "misses": int, "entries": int, "size": int, "budget": int, "evictions": int, "invalidations": int}
+	shv::chainpack::RpcValue getLogCacheStats();
+
+	/// append() only enqueues entries then, they are written by dedicated thread,
+	/// append(), getLog(), getSnapShotMap() and flush() can be called from any thread in async mode,
+	/// journal should be configured before async writer is started
+	void startAsyncWriter(size_t queue_capacity = DEFAULT_ASYNC_QUEUE_CAPACITY);
+	/// write all the enqueued entries and stop writer thread
+	void stopAsyncWriter();
+	bool isAsyncWriterRunning() const { return m_asyncWriter != nullptr; }
 
 	static int64_t findLastEntryDateTime(const std::string &fn, int64_t journal_start_msec, ssize_t *p_date_time_fpos = nullptr);
 	void append(const ShvJournalEntry &entry) override;
@@ -81,6 +121,8 @@ public:
 		std::string deviceId;
 		std::string deviceType;
 		ShvLogTypeInfo typeInfo;
+		/// number of threads parsing journal files in getLog(), 1 means reading files sequentially in the calling thread
+		int getLogThreadCount = 1;
 
 		bool isConsistent() const {return journalDirExists && journalSize >= 0;}
 		//void setNotConsistent() {journalSize = -1;}
@@ -99,13 +141,46 @@ private:
 
 	void rotateJournal();
 	void updateJournalStatus();
+	bool loadManifest();
+	void saveManifest();
 	void checkRecentTimeStamp();
 	void ensureJournalDir();
 	bool journalDirExists();
 
+	void appendSync(const ShvJournalEntry &entry);
 	void appendThrow(const ShvJournalEntry &entry);
+	ShvJournalFileWriter& fileWriter(int64_t journal_file_start_msec);
+	void writeSnapshotCheckpoint(ShvJournalFileWriter &wr);
+	void flushFileWriter();
+	void closeFileWriter();
+
+	void enqueue(const ShvJournalEntry &entry);
+	void asyncWriterLoop();
+	/// wait until async writer has written all the entries enqueued so far and lock journal then
+	std::unique_lock<std::mutex> lockJournal();
 private:
+	struct AsyncWriter;
+	std::unique_ptr<AsyncWriter> m_asyncWriter;
+	class GetLogCache;
+	std::unique_ptr<GetLogCache> m_getLogCache;
+
 	JournalContext m_journalContext;
+	std::unique_ptr<ShvJournalFileWriter> m_fileWriter;
+	int64_t m_fileWriterStartMsec = 0;
+	ShvJournalFileWriter::FlushPolicy m_flushPolicy;
+	struct JournalFileInfo
+	{
+		int64_t size = 0;
+		/// 0 if not known
+		int64_t lastEntryMsec = 0;
+	};
+	/// journal files info for manifest, current size of the last file is in journal context
+	std::map<int64_t, JournalFileInfo> m_fileInfos;
+	bool m_manifestEnabled = false;
+	int64_t m_snapshotCheckpointInterval = 0;
+	/// checkpoints can be written only to file created by this instance, m_snapshot is not consistent with other files
+	int64_t m_checkpointFileMsec = 0;
+	int64_t m_lastCheckpointFileSize = 0;
 
 	int64_t m_fileSizeLimit = DEFAULT_FILE_SIZE_LIMIT;
 	int64_t m_journalSizeLimit = DEFAULT_JOURNAL_SIZE_LIMIT;
@@ -20,6 +20,7 @@ const char *ShvGetLogParams::KEY_WITH_UNTIL = "until";
 const char *ShvGetLogParams::KEY_PATH_PATTERN_TYPE = "pathPatternType";
 const char *ShvGetLogParams::KEY_PATH_PATTERN = "pathPattern";
 const char *ShvGetLogParams::KEY_DOMAIN_PATTERN = "domainPattern";
+const char *ShvGetLogParams::KEY_COLUMNAR = "columnar";
 
 static const char *SINCE_NOW = "now";
 const char *ShvGetLogParams::SINCE_LAST = "last";
@@ -58,6 +59,9 @@ chainpack::RpcValue ShvGetLogParams::toRpcValue( bool fill_legacy_fields ) const
 	m[KEY_WITH_SNAPSHOT] = withSnapshot;
 	m[KEY_WITH_PATHS_DICT] = withPathsDict;
 	m[KEY_WITH_TYPE_INFO] = withTypeInfo;
+	// legacy devices does not know columnar log, do not send the key if not needed
+	if(columnar)
+		m[KEY_COLUMNAR] = columnar;
 	if(fill_legacy_fields) {
 		//for compatibility with legacy devices (don't remove ! :-))
 		unsigned flags = HeaderOptions::BasicInfo | HeaderOptions::FieldInfo
@@ -90,6 +94,7 @@ ShvGetLogParams ShvGetLogParams::fromRpcValue(const chainpack::RpcValue &v)
 	ret.withTypeInfo = m.value(KEY_WITH_TYPE_INFO,ret.withTypeInfo).toBool();
 	ret.withSnapshot = m.value(KEY_WITH_SNAPSHOT,ret.withSnapshot).toBool();
 	ret.withPathsDict = m.value(KEY_WITH_PATHS_DICT, ret.withPathsDict).toBool();
+	ret.columnar = m.value(KEY_COLUMNAR, ret.columnar).toBool();
 	return ret;
 }
 
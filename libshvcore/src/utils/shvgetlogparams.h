@@ -25,6 +25,7 @@ struct SHVCORE_DECL_EXPORT ShvGetLogParams
 	static const char *KEY_PATH_PATTERN;
 	static const char *KEY_PATH_PATTERN_TYPE;
 	static const char *KEY_DOMAIN_PATTERN;
+	static const char *KEY_COLUMNAR;
 
 	static const char *SINCE_LAST;
 
@@ -45,6 +46,9 @@ struct SHVCORE_DECL_EXPORT ShvGetLogParams
 	std::string domainPattern; /// always regexp
 	bool withTypeInfo = false;
 	bool withPathsDict = true;
+	/// return log as Map of compressed columns instead of List of records, see ShvLogColumnsWriter
+	/// paths dictionary is always used for columnar log
+	bool columnar = false;
 
 	ShvGetLogParams() {}
 	ShvGetLogParams(const shv::chainpack::RpcValue &opts);
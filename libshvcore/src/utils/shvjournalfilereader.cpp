@@ -7,6 +7,8 @@
 #include "../stringview.h"
 #include "../string.h"
 
+#include <cstring>
+
 #define logWShvJournal() shvCWarning("ShvJournal")
 #define logIShvJournal() shvCInfo("ShvJournal")
 #define logMShvJournal() shvCMessage("ShvJournal")
@@ -18,83 +20,86 @@ namespace shv {
 namespace core {
 namespace utils {
 
-static std::string getLine(std::istream &in, char sep)
-{
-	std::string line;
-	while(in) {
-		auto c = in.get();
-		if(c == std::char_traits<char>::eof())
-			return line;
-		if(c == sep)
-			return line;
-		if(c == 0)
-			continue; // sometimes log file contains zeros, skip them, istream::getline cannot handle this
-		line += std::char_traits<char>::to_char_type(c);
-	}
-	return line;
-}
-
 ShvJournalFileReader::ShvJournalFileReader(const std::string &file_name)
 	: m_fileName(file_name)
+	, m_file(file_name, MappedFile::Access::Sequential)
 {
-	m_ifstream.open(file_name, std::ios::binary);
-	if(!m_ifstream)
-		SHV_EXCEPTION("Cannot open file " + file_name + " for reading.");
 	m_snapshotMsec = fileNameToFileMsec(file_name, !shv::core::Exception::Throw);
 }
 
 bool ShvJournalFileReader::next()
 {
-	using Column = ShvFileJournal::TxtColumn;
 	while(true) {
 		m_currentEntry = ShvJournalEntry();
-		if(!m_ifstream)
+		if(m_pos >= m_file.size())
 			return false;
 
-		std::string line = getLine(m_ifstream, ShvFileJournal::RECORD_SEPARATOR);
-		shv::core::StringView sv(line);
-		shv::core::StringViewList line_record = sv.split(ShvFileJournal::FIELD_SEPARATOR, shv::core::StringView::KeepEmptyParts);
-		if(line_record.empty()) {
-			logDShvJournal() << "skipping empty line";
-			continue; // skip empty line
-		}
-		std::string dtstr = line_record[Column::Timestamp].toString();
-		size_t len;
-		cp::RpcValue::DateTime dt = cp::RpcValue::DateTime::fromUtcString(dtstr, &len);
-		//logDShvJournal() << dtstr << "-->" << dt.toIsoString();
-		if(len == 0) {
-			logWShvJournal() << "invalid date time string:" << dtstr << "line will be ignored";
-			continue;
-		}
-		if(len >= line.size() || line[len] != ShvFileJournal::FIELD_SEPARATOR) {
-			logWShvJournal() << "invalid date time string:" << dtstr << "correct date time should end with field separator on position:" << len << ", line will be ignored";
-			continue;
+		const char *line_begin = m_file.data() + m_pos;
+		const size_t rest = m_file.size() - m_pos;
+		auto *sep = static_cast<const char*>(std::memchr(line_begin, ShvFileJournal::RECORD_SEPARATOR, rest));
+		const size_t line_len = sep? static_cast<size_t>(sep - line_begin): rest;
+		m_pos += sep? line_len + 1: line_len;
+		bool ok;
+		if(std::memchr(line_begin, 0, line_len)) {
+			// sometimes log file contains zeros, skip them
+			std::string line;
+			line.reserve(line_len);
+			for (size_t i = 0; i < line_len; ++i) {
+				if(line_begin[i])
+					line += line_begin[i];
+			}
+			ok = parseLine(line, m_currentEntry);
 		}
-		std::string path = line_record.value(Column::Path).toString();
-		if(path.empty()) {
-			logWShvJournal() << "skipping invalid line with empy path, line:" << line;
-			continue;
+		else {
+			ok = parseLine(StringView(line_begin, line_len), m_currentEntry);
 		}
-		std::string domain = line_record.value(Column::Domain).toString();
-		if(domain.empty())
-			domain = ShvJournalEntry::DOMAIN_VAL_CHANGE;
-		StringView short_time_sv = line_record.value(Column::ShortTime);
-		auto value_flags = shv::core::String::toInt(line_record.value(Column::ValueFlags).toString());
-
-		m_currentEntry.path = std::move(path);
-		m_currentEntry.epochMsec = dt.msecsSinceEpoch();
-		bool ok;
-		int short_time = short_time_sv.toInt(&ok);
-		m_currentEntry.shortTime = ok && short_time >= 0? short_time: ShvJournalEntry::NO_SHORT_TIME;
-		m_currentEntry.domain = std::move(domain);
-		m_currentEntry.valueFlags = value_flags;
-		m_currentEntry.userId = line_record.value(Column::UserId).toString();
-		std::string err;
-		m_currentEntry.value = cp::RpcValue::fromCpon(line_record.value(Column::Value).toString(), &err);
-		if(!err.empty())
-			logWShvJournal() << "Invalid CPON value:" << line_record.value(Column::Value).toString();
-		return true;
+		if(ok)
+			return true;
+	}
+}
+
+bool ShvJournalFileReader::parseLine(const StringView &line, ShvJournalEntry &entry)
+{
+	using Column = ShvFileJournal::TxtColumn;
+	shv::core::StringViewList line_record = line.split(ShvFileJournal::FIELD_SEPARATOR, shv::core::StringView::KeepEmptyParts);
+	if(line_record.empty()) {
+		logDShvJournal() << "skipping empty line";
+		return false; // skip empty line
 	}
+	std::string dtstr = line_record[Column::Timestamp].toString();
+	size_t len;
+	cp::RpcValue::DateTime dt = cp::RpcValue::DateTime::fromUtcString(dtstr, &len);
+	//logDShvJournal() << dtstr << "-->" << dt.toIsoString();
+	if(len == 0) {
+		logWShvJournal() << "invalid date time string:" << dtstr << "line will be ignored";
+		return false;
+	}
+	if(len >= line.size() || line[len] != ShvFileJournal::FIELD_SEPARATOR) {
+		logWShvJournal() << "invalid date time string:" << dtstr << "correct date time should end with field separator on position:" << len << ", line will be ignored";
+		return false;
+	}
+	StringView path = line_record.value(Column::Path);
+	if(path.empty()) {
+		logWShvJournal() << "skipping invalid line with empy path, line:" << line;
+		return false;
+	}
+	StringView domain = line_record.value(Column::Domain);
+	StringView short_time_sv = line_record.value(Column::ShortTime);
+	auto value_flags = line_record.value(Column::ValueFlags).toInt();
+
+	entry.path = path.toString();
+	entry.epochMsec = dt.msecsSinceEpoch();
+	bool ok;
+	int short_time = short_time_sv.toInt(&ok);
+	entry.shortTime = ok && short_time >= 0? short_time: ShvJournalEntry::NO_SHORT_TIME;
+	entry.domain = domain.empty()? ShvJournalEntry::DOMAIN_VAL_CHANGE: domain.toString();
+	entry.valueFlags = value_flags;
+	entry.userId = line_record.value(Column::UserId).toString();
+	std::string err;
+	entry.value = cp::RpcValue::fromCpon(line_record.value(Column::Value).toString(), &err);
+	if(!err.empty())
+		logWShvJournal() << "Invalid CPON value:" << line_record.value(Column::Value);
+	return true;
 }
 
 bool ShvJournalFileReader::last()
@@ -102,8 +107,7 @@ bool ShvJournalFileReader::last()
 	ssize_t fpos;
 	ShvFileJournal::findLastEntryDateTime(m_fileName, 0, &fpos);
 	if(fpos >= 0) {
-		m_ifstream.clear();
-		m_ifstream.seekg(fpos, std::ios::beg);
+		m_pos = static_cast<size_t>(fpos);
 		return next();
 	}
 	else {
@@ -112,6 +116,23 @@ bool ShvJournalFileReader::last()
 	}
 }
 
+bool ShvJournalFileReader::seek(ssize_t fpos)
+{
+	if(fpos > 0) {
+		const size_t pos = static_cast<size_t>(fpos);
+		if(pos > m_file.size() || m_file.data()[pos - 1] != ShvFileJournal::RECORD_SEPARATOR) {
+			logWShvJournal() << m_fileName << "file position:" << fpos << "is not on record boundary";
+			m_pos = 0;
+			return false;
+		}
+		m_pos = pos;
+	}
+	else {
+		m_pos = 0;
+	}
+	return true;
+}
+
 const ShvJournalEntry &ShvJournalFileReader::entry()
 {
 	return m_currentEntry;
@@ -4,10 +4,11 @@
 #include "../shvcoreglobal.h"
 #include "shvjournalentry.h"
 #include "shvlogtypeinfo.h"
+#include "mappedfile.h"
 #include "../exception.h"
+#include "../stringview.h"
 
 #include <string>
-#include <fstream>
 
 namespace shv {
 namespace core {
@@ -16,18 +17,26 @@ namespace utils {
 class SHVCORE_DECL_EXPORT ShvJournalFileReader
 {
 public:
+	/// file is memory mapped, records are parsed in place, file must not be truncated while it is read, see MappedFile
 	ShvJournalFileReader(const std::string &file_name);
 
 	bool next();
 	bool last();
+	/// continue reading from fpos, returns false and rewinds the file if fpos is not on record boundary
+	bool seek(ssize_t fpos);
 	const ShvJournalEntry& entry();
 	bool inSnapshot() const;
 
+	/// parses single .log2 record without record separator, line can be a view into any buffer
+	/// returns false if the line is empty or invalid
+	static bool parseLine(const StringView &line, ShvJournalEntry &entry);
+
 	static int64_t fileNameToFileMsec(const std::string &fn, bool throw_exc = shv::core::Exception::Throw);
 	static std::string msecToBaseFileName(int64_t msec);
 private:
 	std::string m_fileName;
-	std::ifstream m_ifstream;
+	MappedFile m_file;
+	size_t m_pos = 0;
 	ShvJournalEntry m_currentEntry;
 	int64_t m_snapshotMsec = -1;
 };
@@ -5,19 +5,31 @@
 
 #include <shv/chainpack/rpc.h>
 
+#include <fstream>
+#include <chrono>
+
 namespace cp = shv::chainpack;
 
+#ifdef _WIN32
+#include <io.h>
+#define SHV_FILENO(f)	::_fileno(f)
+#define SHV_FSYNC(fd)	::_commit(fd)
+#else
+#include <unistd.h>
+#define SHV_FILENO(f)	::fileno(f)
+#define SHV_FSYNC(fd)	::fsync(fd)
+#endif
+
+#define logWShvJournal() shvCWarning("ShvJournal")
+
 namespace shv {
 namespace core {
 namespace utils {
 
-static int uptimeSec()
+static int64_t steadyMsec()
 {
-	int uptime;
-	if (std::ifstream("/proc/uptime", std::ios::in) >> uptime) {
-		return uptime;
-	}
-	return 0;
+	using namespace std::chrono;
+	return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
 }
 
 ShvJournalFileWriter::ShvJournalFileWriter(const std::string &file_name)
@@ -33,18 +45,95 @@ ShvJournalFileWriter::ShvJournalFileWriter(const std::string &journal_dir, int64
 	open();
 }
 
+ShvJournalFileWriter::~ShvJournalFileWriter()
+{
+	try {
+		flush();
+	}
+	catch (std::exception &e) {
+		logWShvJournal() << "Journal file:" << m_fileName << "close error, pending data lost, size:" << m_pending.size() << "error:" << e.what();
+	}
+	close();
+}
+
 void ShvJournalFileWriter::open()
 {
-	m_out.open(m_fileName, std::ios::binary | std::ios::out | std::ios::app);
-	if(!m_out)
+	// a+ is needed to check the last byte of the existing file, all the writes are appended
+	m_file = std::fopen(m_fileName.c_str(), "a+b");
+	if(!m_file)
 		SHV_EXCEPTION("Cannot open file " + m_fileName + " for writing");
+	if(std::fseek(m_file, 0, SEEK_END) != 0 || (m_fileSize = std::ftell(m_file)) < 0) {
+		close();
+		SHV_EXCEPTION("Cannot seek file " + m_fileName);
+	}
+	if(m_fileSize > 0) {
+		// previous run might be killed in the middle of writing record,
+		// terminate torn record, reader will skip it then, and it cannot spoil the first appended one
+		std::fseek(m_file, -1, SEEK_END);
+		int c = std::fgetc(m_file);
+		std::fseek(m_file, 0, SEEK_END);
+		if(c != ShvFileJournal::RECORD_SEPARATOR) {
+			logWShvJournal() << "Journal file:" << m_fileName << "does not end with record separator, last record is probably truncated";
+			m_pending += ShvFileJournal::RECORD_SEPARATOR;
+			m_fileSize++;
+			flush();
+		}
+	}
 	//if(m_recentTimeStamp <= 0)
 	//	SHV_EXCEPTION("Cannot append to file " + m_fileName + ", find recent entry timestamp error.");
 }
 
-ssize_t ShvJournalFileWriter::fileSize()
+void ShvJournalFileWriter::close()
+{
+	if(m_file) {
+		std::fclose(m_file);
+		m_file = nullptr;
+	}
+}
+
+void ShvJournalFileWriter::flush()
 {
-	return m_out.tellp();
+	if(m_pending.empty())
+		return;
+	if(!m_file)
+		SHV_EXCEPTION("File " + m_fileName + " is not open");
+	size_t n = std::fwrite(m_pending.data(), 1, m_pending.size(), m_file);
+	bool ok = n == m_pending.size() && std::fflush(m_file) == 0;
+	if(ok && m_flushPolicy.fsync)
+		ok = SHV_FSYNC(SHV_FILENO(m_file)) == 0;
+	if(n < m_pending.size()) {
+		// keep unwritten tail, file size is tracked including pending data
+		m_pending.erase(0, n);
+	}
+	else {
+		m_pending.clear();
+	}
+	if(!ok)
+		SHV_EXCEPTION("Cannot write to file " + m_fileName);
+}
+
+void ShvJournalFileWriter::checkFlush()
+{
+	if(m_flushPolicy.maxPendingBytes <= 0 || static_cast<int64_t>(m_pending.size()) >= m_flushPolicy.maxPendingBytes) {
+		flush();
+		return;
+	}
+	if(m_flushPolicy.maxPendingMsec > 0 && steadyMsec() - m_pendingSinceMsec >= m_flushPolicy.maxPendingMsec)
+		flush();
+}
+
+int ShvJournalFileWriter::uptimeSec()
+{
+	// uptime has resolution of seconds, do not read /proc/uptime on every append
+	int64_t now = steadyMsec();
+	if(m_uptimeReadMsec < 0 || now - m_uptimeReadMsec >= 1000) {
+		m_uptimeReadMsec = now;
+		m_uptimeSec = 0;
+		int uptime;
+		if (std::ifstream("/proc/uptime", std::ios::in) >> uptime)
+			m_uptimeSec = uptime;
+	}
+	return m_uptimeSec;
 }
 
 void ShvJournalFileWriter::append(const ShvJournalEntry &entry)
@@ -54,6 +143,7 @@ void ShvJournalFileWriter::append(const ShvJournalEntry &entry)
 		msec = cp::RpcValue::DateTime::now().msecsSinceEpoch();
 	m_recentTimeStamp = msec;
 	append(msec, uptimeSec(), entry);
+	checkFlush();
 }
 
 void ShvJournalFileWriter::appendMonotonic(const ShvJournalEntry &entry)
@@ -70,6 +160,7 @@ void ShvJournalFileWriter::appendMonotonic(const ShvJournalEntry &entry)
 		m_recentTimeStamp = msec;
 	}
 	append(msec, uptimeSec(), entry);
+	checkFlush();
 }
 
 void ShvJournalFileWriter::appendSnapshot(int64_t msec, const std::vector<ShvJournalEntry> &snapshot)
@@ -83,6 +174,7 @@ void ShvJournalFileWriter::appendSnapshot(int64_t msec, const std::vector<ShvJou
 		append(msec, uptime, e);
 	}
 	m_recentTimeStamp = msec;
+	checkFlush();
 }
 
 void ShvJournalFileWriter::appendSnapshot(int64_t msec, const std::map<std::string, ShvJournalEntry> &snapshot)
@@ -97,28 +189,32 @@ void ShvJournalFileWriter::appendSnapshot(int64_t msec, const std::map<std::stri
 		append(msec, uptime, e);
 	}
 	m_recentTimeStamp = msec;
+	checkFlush();
 }
 
 void ShvJournalFileWriter::append(int64_t msec, int uptime, const ShvJournalEntry &entry)
 {
-	m_out << cp::RpcValue::DateTime::fromMSecsSinceEpoch(msec).toIsoString();
-	m_out << ShvFileJournal::FIELD_SEPARATOR;
-	m_out << uptime;
-	m_out << ShvFileJournal::FIELD_SEPARATOR;
-	m_out << entry.path;
-	m_out << ShvFileJournal::FIELD_SEPARATOR;
-	m_out << entry.value.toCpon();
-	m_out << ShvFileJournal::FIELD_SEPARATOR;
+	if(m_pending.empty())
+		m_pendingSinceMsec = steadyMsec();
+	size_t orig_size = m_pending.size();
+	m_pending += cp::RpcValue::DateTime::fromMSecsSinceEpoch(msec).toIsoString();
+	m_pending += ShvFileJournal::FIELD_SEPARATOR;
+	m_pending += std::to_string(uptime);
+	m_pending += ShvFileJournal::FIELD_SEPARATOR;
+	m_pending += entry.path;
+	m_pending += ShvFileJournal::FIELD_SEPARATOR;
+	m_pending += entry.value.toCpon();
+	m_pending += ShvFileJournal::FIELD_SEPARATOR;
 	if(entry.shortTime >= 0)
-		m_out << entry.shortTime;
-	m_out << ShvFileJournal::FIELD_SEPARATOR;
-	m_out << entry.domain;
-	m_out << ShvFileJournal::FIELD_SEPARATOR;
-	m_out << (int)entry.valueFlags;
-	m_out << ShvFileJournal::FIELD_SEPARATOR;
-	m_out << entry.userId;
-	m_out << ShvFileJournal::RECORD_SEPARATOR;
-	m_out.flush();
+		m_pending += std::to_string(entry.shortTime);
+	m_pending += ShvFileJournal::FIELD_SEPARATOR;
+	m_pending += entry.domain;
+	m_pending += ShvFileJournal::FIELD_SEPARATOR;
+	m_pending += std::to_string((int)entry.valueFlags);
+	m_pending += ShvFileJournal::FIELD_SEPARATOR;
+	m_pending += entry.userId;
+	m_pending += ShvFileJournal::RECORD_SEPARATOR;
+	m_fileSize += static_cast<ssize_t>(m_pending.size() - orig_size);
 	m_recentTimeStamp = msec;
 }
 
@@ -5,7 +5,7 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <fstream>
+#include <cstdio>
 
 namespace shv {
 namespace core {
@@ -15,25 +15,58 @@ class ShvJournalEntry;
 
 class SHVCORE_DECL_EXPORT ShvJournalFileWriter
 {
+public:
+	/// Group commit settings, entries are kept in memory until one of the limits is reached.
+	/// Default policy writes every entry to the file immediately.
+	struct FlushPolicy
+	{
+		/// flush when pending data size reaches this limit, 0 means flush after every entry
+		int64_t maxPendingBytes = 0;
+		/// flush when the oldest pending entry is older than this, 0 means no time limit
+		/// the limit is checked in append(), call flush() periodically to be sure
+		int64_t maxPendingMsec = 0;
+		/// fsync() file after every flush, data survive power loss then
+		bool fsync = false;
+	};
 public:
 	ShvJournalFileWriter(const std::string &file_name);
 	ShvJournalFileWriter(const std::string &journal_dir, int64_t journal_start_time, int64_t last_entry_ts);
+	~ShvJournalFileWriter();
+
+	ShvJournalFileWriter(const ShvJournalFileWriter &) = delete;
+	ShvJournalFileWriter& operator=(const ShvJournalFileWriter &) = delete;
+
+	void setFlushPolicy(const FlushPolicy &policy) { m_flushPolicy = policy; }
+	const FlushPolicy& flushPolicy() const { return m_flushPolicy; }
 
 	void append(const ShvJournalEntry &entry);
 	void appendMonotonic(const ShvJournalEntry &entry);
 	void appendSnapshot(int64_t msec, const std::vector<ShvJournalEntry> &snapshot);
 	void appendSnapshot(int64_t msec, const std::map<std::string, ShvJournalEntry> &snapshot);
 
-	ssize_t fileSize();
+	/// write pending entries to the file
+	void flush();
+	/// file size including entries not flushed yet
+	ssize_t fileSize() const { return m_fileSize; }
+	size_t pendingSize() const { return m_pending.size(); }
 	const std::string& fileName() const { return m_fileName; }
 	int64_t recentTimeStamp() const { return m_recentTimeStamp; }
 private:
 	void open();
+	void close();
 	void append(int64_t msec, int uptime, const ShvJournalEntry &entry);
+	void checkFlush();
+	int uptimeSec();
 private:
 	std::string m_fileName;
-	std::ofstream m_out;
+	std::FILE *m_file = nullptr;
+	ssize_t m_fileSize = 0;
+	std::string m_pending;
+	int64_t m_pendingSinceMsec = 0;
+	FlushPolicy m_flushPolicy;
 	int64_t m_recentTimeStamp = 0;
+	int m_uptimeSec = 0;
+	int64_t m_uptimeReadMsec = -1;
 };
 
 } // namespace utils
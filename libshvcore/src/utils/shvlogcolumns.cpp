@@ -0,0 +1,212 @@
+#include "shvlogcolumns.h"
+#include "shvjournalentry.h"
+#include "shvlogheader.h"
+#include "abstractshvjournal.h"
+
+#include "../exception.h"
+
+namespace cp = shv::chainpack;
+
+namespace shv {
+namespace core {
+namespace utils {
+
+namespace {
+
+using Column = ShvLogHeader::Column;
+
+void write_uint(cp::RpcValue::Blob &blob, uint64_t n)
+{
+	while(n >= 0x80) {
+		blob.push_back(static_cast<uint8_t>(n | 0x80));
+		n >>= 7;
+	}
+	blob.push_back(static_cast<uint8_t>(n));
+}
+
+uint64_t zigzag(int64_t n)
+{
+	return (static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63);
+}
+
+int64_t unzigzag(uint64_t n)
+{
+	return static_cast<int64_t>(n >> 1) ^ -static_cast<int64_t>(n & 1);
+}
+
+const std::string& empty_string()
+{
+	static const std::string s;
+	return s;
+}
+
+}
+
+//============================================================
+// ShvLogColumnsWriter
+//============================================================
+void ShvLogColumnsWriter::StringRuns::append(const std::string &val)
+{
+	if(runLength > 0 && val != runValue)
+		flush();
+	if(runLength == 0)
+		runValue = val;
+	runLength++;
+}
+
+void ShvLogColumnsWriter::StringRuns::flush()
+{
+	if(runLength == 0)
+		return;
+	runs.push_back(runValue.empty()? cp::RpcValue(nullptr): cp::RpcValue(runValue));
+	runs.push_back(static_cast<uint64_t>(runLength));
+	runLength = 0;
+}
+
+void ShvLogColumnsWriter::append(const ShvJournalEntry &entry, int64_t epoch_msec, int path_id)
+{
+	write_uint(m_timestamps, zigzag(epoch_msec - m_lastMsec));
+	m_lastMsec = epoch_msec;
+	write_uint(m_paths, static_cast<unsigned>(path_id));
+	m_values.push_back(entry.value);
+	write_uint(m_shortTimes, zigzag(entry.shortTime < 0? ShvJournalEntry::NO_SHORT_TIME: entry.shortTime));
+	const bool default_domain = entry.domain.empty() || entry.domain == ShvJournalEntry::DOMAIN_VAL_CHANGE;
+	m_domains.append(default_domain? empty_string(): entry.domain);
+	if(m_valueFlagsRunLength > 0 && entry.valueFlags != m_valueFlagsRunValue) {
+		write_uint(m_valueFlags, m_valueFlagsRunValue);
+		write_uint(m_valueFlags, m_valueFlagsRunLength);
+		m_valueFlagsRunLength = 0;
+	}
+	m_valueFlagsRunValue = entry.valueFlags;
+	m_valueFlagsRunLength++;
+	m_userIds.append(entry.userId);
+}
+
+chainpack::RpcValue ShvLogColumnsWriter::takeColumns()
+{
+	m_domains.flush();
+	m_userIds.flush();
+	if(m_valueFlagsRunLength > 0) {
+		write_uint(m_valueFlags, m_valueFlagsRunValue);
+		write_uint(m_valueFlags, m_valueFlagsRunLength);
+		m_valueFlagsRunLength = 0;
+	}
+	cp::RpcValue::Map ret;
+	ret[Column::name(Column::Timestamp)] = std::move(m_timestamps);
+	ret[Column::name(Column::Path)] = std::move(m_paths);
+	ret[Column::name(Column::Value)] = std::move(m_values);
+	ret[Column::name(Column::ShortTime)] = std::move(m_shortTimes);
+	ret[Column::name(Column::Domain)] = std::move(m_domains.runs);
+	ret[Column::name(Column::ValueFlags)] = std::move(m_valueFlags);
+	ret[Column::name(Column::UserId)] = std::move(m_userIds.runs);
+	return ret;
+}
+
+//============================================================
+// ShvLogColumnsReader
+//============================================================
+uint64_t ShvLogColumnsReader::BlobColumn::readUInt()
+{
+	const cp::RpcValue::Blob &data = blob.asBlob();
+	uint64_t ret = 0;
+	for(unsigned shift = 0; shift < 64; shift += 7) {
+		if(pos >= data.size())
+			SHV_EXCEPTION("Columnar log corrupted, unexpected column end.");
+		uint8_t b = data[pos++];
+		ret |= static_cast<uint64_t>(b & 0x7f) << shift;
+		if(!(b & 0x80))
+			return ret;
+	}
+	SHV_EXCEPTION("Columnar log corrupted, varint too long.");
+}
+
+int64_t ShvLogColumnsReader::BlobColumn::readInt()
+{
+	return unzigzag(readUInt());
+}
+
+const std::string &ShvLogColumnsReader::StringRuns::next()
+{
+	const cp::RpcValue::List &lst = runs.asList();
+	while(runRest == 0) {
+		if(runIndex + 1 >= lst.size())
+			SHV_EXCEPTION("Columnar log corrupted, unexpected run-length column end.");
+		runRest = lst[runIndex + 1].toUInt64();
+		runIndex += 2;
+	}
+	runRest--;
+	return lst[runIndex - 2].asString();
+}
+
+ShvLogColumnsReader::ShvLogColumnsReader(const chainpack::RpcValue &columns, const chainpack::RpcValue &path_dict)
+	: m_pathDict(path_dict)
+{
+	const cp::RpcValue::Map &m = columns.asMap();
+	m_timestamps.blob = m.value(Column::name(Column::Timestamp));
+	m_paths.blob = m.value(Column::name(Column::Path));
+	m_values = m.value(Column::name(Column::Value));
+	m_shortTimes.blob = m.value(Column::name(Column::ShortTime));
+	m_domains.runs = m.value(Column::name(Column::Domain));
+	m_valueFlags.blob = m.value(Column::name(Column::ValueFlags));
+	m_userIds.runs = m.value(Column::name(Column::UserId));
+	if(!m_values.isList())
+		SHV_EXCEPTION("Columnar log corrupted, missing value column.");
+}
+
+bool ShvLogColumnsReader::next(ShvJournalEntry &entry)
+{
+	const cp::RpcValue::List &values = m_values.asList();
+	if(m_index >= values.size())
+		return false;
+	m_lastMsec += m_timestamps.readInt();
+	entry.epochMsec = m_lastMsec;
+	auto path_id = static_cast<cp::RpcValue::Int>(m_paths.readUInt());
+	const cp::RpcValue::IMap &path_dict = m_pathDict.asIMap();
+	auto it = path_dict.find(path_id);
+	if(it == path_dict.end())
+		SHV_EXCEPTION("Path dictionary corrupted, missing path id: " + std::to_string(path_id));
+	entry.path = it->second.asString();
+	entry.value = values[m_index++];
+	int64_t short_time = m_shortTimes.readInt();
+	entry.shortTime = short_time >= 0? static_cast<int>(short_time): ShvJournalEntry::NO_SHORT_TIME;
+	const std::string &domain = m_domains.next();
+	entry.domain = domain.empty()? ShvJournalEntry::DOMAIN_VAL_CHANGE: domain;
+	if(m_valueFlagsRunRest == 0) {
+		m_valueFlagsRunValue = static_cast<unsigned>(m_valueFlags.readUInt());
+		m_valueFlagsRunRest = m_valueFlags.readUInt();
+		if(m_valueFlagsRunRest == 0)
+			SHV_EXCEPTION("Columnar log corrupted, empty value flags run.");
+	}
+	m_valueFlagsRunRest--;
+	entry.valueFlags = m_valueFlagsRunValue;
+	entry.userId = m_userIds.next();
+	return true;
+}
+
+chainpack::RpcValue ShvLogColumnsReader::toRowLog(const chainpack::RpcValue &log)
+{
+	if(!isColumnar(log))
+		return log;
+	ShvLogColumnsReader reader(log, log.metaValue(AbstractShvJournal::KEY_PATHS_DICT));
+	cp::RpcValue::List rows;
+	rows.reserve(reader.recordCount());
+	ShvJournalEntry e;
+	while(reader.next(e)) {
+		cp::RpcValue::List rec;
+		rec.push_back(cp::RpcValue::DateTime::fromMSecsSinceEpoch(e.epochMsec));
+		rec.push_back(e.path);
+		rec.push_back(e.value);
+		rec.push_back(e.shortTime == ShvJournalEntry::NO_SHORT_TIME? cp::RpcValue(nullptr): cp::RpcValue(e.shortTime));
+		rec.push_back(e.domain == ShvJournalEntry::DOMAIN_VAL_CHANGE? cp::RpcValue(nullptr): cp::RpcValue(e.domain));
+		rec.push_back(e.valueFlags);
+		rec.push_back(e.userId.empty()? cp::RpcValue(nullptr): cp::RpcValue(e.userId));
+		rows.push_back(std::move(rec));
+	}
+	cp::RpcValue ret = rows;
+	ret.setMetaData(cp::RpcValue::MetaData(log.metaData()));
+	return ret;
+}
+
+} // namespace utils
+} // namespace core
+} // namespace shv
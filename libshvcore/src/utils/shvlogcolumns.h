@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../shvcoreglobal.h"
+
+#include <shv/chainpack/rpcvalue.h>
+
+#include <string>
+
+namespace shv {
+namespace core {
+namespace utils {
+
+class ShvJournalEntry;
+
+/// Columnar getLog result, requested by ShvGetLogParams::columnar.
+/// Log is Map of columns instead of List of 7-item records, header (meta data) stays the same,
+/// paths are always encoded as ids to pathsDict.
+///   timestamp:  Blob, zigzag varint msec differences to previous record, first one to 0
+///   path:       Blob, varint path ids
+///   value:      List of values
+///   shortTime:  Blob, zigzag varint short times, -1 for no short time
+///   domain:     List of run-length encoded domains [domain, count, domain, count, ...], null stands for chng
+///   valueFlags: Blob, run-length encoded varint pairs (flags, count)
+///   userId:     List of run-length encoded user IDs [userId, count, ...], null stands for empty user ID
+class SHVCORE_DECL_EXPORT ShvLogColumnsWriter
+{
+public:
+	void append(const ShvJournalEntry &entry, int64_t epoch_msec, int path_id);
+	size_t recordCount() const {return m_values.size();}
+	/// flushes pending runs, writer cannot be used after this call
+	shv::chainpack::RpcValue takeColumns();
+private:
+	struct StringRuns
+	{
+		void append(const std::string &val);
+		void flush();
+
+		shv::chainpack::RpcValue::List runs;
+		std::string runValue;
+		size_t runLength = 0;
+	};
+private:
+	shv::chainpack::RpcValue::Blob m_timestamps;
+	shv::chainpack::RpcValue::Blob m_paths;
+	shv::chainpack::RpcValue::List m_values;
+	shv::chainpack::RpcValue::Blob m_shortTimes;
+	StringRuns m_domains;
+	shv::chainpack::RpcValue::Blob m_valueFlags;
+	StringRuns m_userIds;
+	int64_t m_lastMsec = 0;
+	unsigned m_valueFlagsRunValue = 0;
+	size_t m_valueFlagsRunLength = 0;
+};
+
+class SHVCORE_DECL_EXPORT ShvLogColumnsReader
+{
+public:
+	/// path_dict is IMap of path ids, like pathsDict log meta value, throws shv::core::Exception if columns are corrupted
+	ShvLogColumnsReader(const shv::chainpack::RpcValue &columns, const shv::chainpack::RpcValue &path_dict);
+
+	size_t recordCount() const {return m_values.asList().size();}
+	/// decodes next record to entry, returns false on log end, throws shv::core::Exception if columns are corrupted
+	bool next(ShvJournalEntry &entry);
+
+	static bool isColumnar(const shv::chainpack::RpcValue &log) {return log.isMap();}
+	/// converts columnar log to List of records, row log is returned as it is
+	static shv::chainpack::RpcValue toRowLog(const shv::chainpack::RpcValue &log);
+private:
+	struct StringRuns
+	{
+		const std::string& next();
+
+		shv::chainpack::RpcValue runs;
+		size_t runIndex = 0;
+		uint64_t runRest = 0;
+	};
+	struct BlobColumn
+	{
+		uint64_t readUInt();
+		int64_t readInt();
+
+		shv::chainpack::RpcValue blob;
+		size_t pos = 0;
+	};
+private:
+	shv::chainpack::RpcValue m_pathDict;
+	BlobColumn m_timestamps;
+	BlobColumn m_paths;
+	shv::chainpack::RpcValue m_values;
+	BlobColumn m_shortTimes;
+	StringRuns m_domains;
+	BlobColumn m_valueFlags;
+	StringRuns m_userIds;
+	size_t m_index = 0;
+	int64_t m_lastMsec = 0;
+	unsigned m_valueFlagsRunValue = 0;
+	uint64_t m_valueFlagsRunRest = 0;
+};
+
+} // namespace utils
+} // namespace core
+} // namespace shv
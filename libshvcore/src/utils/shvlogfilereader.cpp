@@ -26,10 +26,11 @@ ShvLogFileReader::ShvLogFileReader(chainpack::ChainPackReader *reader)
 ShvLogFileReader::ShvLogFileReader(const std::string &file_name)
 {
 	m_readerCreated = true;
-	m_ifstream = new std::ifstream;
-	m_ifstream->open(file_name, std::ios::binary);
-	if(!m_ifstream)
+	m_ifstream = new std::ifstream(file_name, std::ios::binary);
+	if(!*m_ifstream) {
+		delete m_ifstream;
 		SHV_EXCEPTION("Cannot open file " + file_name + " for reading.");
+	}
 	m_reader = new shv::chainpack::ChainPackReader(*m_ifstream);
 	init();
 }
@@ -48,10 +49,8 @@ void ShvLogFileReader::init()
 ShvLogFileReader::~ShvLogFileReader()
 {
 	if(m_readerCreated) {
-		if(m_reader)
-			delete m_reader;
-		if(m_ifstream)
-			delete m_ifstream;
+		delete m_reader;
+		delete m_ifstream;
 	}
 }
 
@@ -60,7 +59,7 @@ bool ShvLogFileReader::next()
 	using Column = ShvLogHeader::Column;
 	while(true) {
 		m_currentEntry = ShvJournalEntry();
-		if(!m_ifstream)
+		if(!m_reader)
 			return false;
 		chainpack::ChainPackReader::ItemType tt = m_reader->peekNext();
 		//logDShvJournal() << "peek next type:" << chainpack::ChainPackReader::itemTypeToString(tt);
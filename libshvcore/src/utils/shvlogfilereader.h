@@ -22,6 +22,8 @@ class SHVCORE_DECL_EXPORT ShvLogFileReader
 {
 public:
 	ShvLogFileReader(shv::chainpack::ChainPackReader *reader);
+	/// log file can be any .chpk file, it is read by stream, not memory mapped,
+	/// access to mapped file truncated by other process would kill the process with SIGBUS
 	ShvLogFileReader(const std::string &file_name);
 	~ShvLogFileReader();
 
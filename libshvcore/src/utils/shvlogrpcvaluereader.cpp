@@ -1,4 +1,6 @@
 #include "shvlogrpcvaluereader.h"
+#include "shvlogcolumns.h"
+#include "abstractshvjournal.h"
 
 #include "../exception.h"
 #include "../log.h"
@@ -21,53 +23,161 @@ ShvLogRpcValueReader::ShvLogRpcValueReader(const shv::chainpack::RpcValue &log,
 	if(m_logHeader.withSnapShot())
 		m_snapshotMsec = m_logHeader.sinceMsec();
 
-	if(!m_log.isList() && m_isThrowExceptions)
+	if(ShvLogColumnsReader::isColumnar(m_log)) {
+		initColumnsReader();
+	}
+	else if(!m_log.isList() && m_isThrowExceptions) {
 		SHV_EXCEPTION("Log is corrupted!");
+	}
+}
+
+ShvLogRpcValueReader::ShvLogRpcValueReader(std::istream &in, chainpack::PullReader::Format format, bool throw_exceptions)
+	: m_isThrowExceptions(throw_exceptions)
+	, m_pullReader(new cp::PullReader(in, format))
+{
+	cp::RpcValue::MetaData md;
+	cp::PullReader::Event event = cp::PullReader::Event::None;
+	try {
+		m_pullReader->read(md);
+		event = m_pullReader->next();
+		if(event == cp::PullReader::Event::MapBegin) {
+			// columns can be decoded only when the whole log is read
+			m_log = m_pullReader->readValue();
+			m_pullReader.reset();
+		}
+	}
+	catch (const cp::PullReader::ParseException &e) {
+		if(m_isThrowExceptions)
+			SHV_EXCEPTION(std::string("Log is corrupted! ") + e.what());
+		logWShvJournal() << "Log is corrupted:" << e.what();
+		m_pullReader.reset();
+		return;
+	}
+	m_logHeader = ShvLogHeader::fromMetaData(md);
+	if(m_logHeader.withSnapShot())
+		m_snapshotMsec = m_logHeader.sinceMsec();
+
+	if(ShvLogColumnsReader::isColumnar(m_log)) {
+		m_log.setMetaData(std::move(md));
+		initColumnsReader();
+	}
+	else if(event != cp::PullReader::Event::ListBegin) {
+		m_pullReader.reset();
+		if(m_isThrowExceptions)
+			SHV_EXCEPTION("Log is corrupted!");
+	}
+}
+
+ShvLogRpcValueReader::~ShvLogRpcValueReader()
+{
+}
+
+void ShvLogRpcValueReader::initColumnsReader()
+{
+	try {
+		m_columnsReader.reset(new ShvLogColumnsReader(m_log, m_log.metaValue(AbstractShvJournal::KEY_PATHS_DICT)));
+	}
+	catch (const shv::core::Exception &e) {
+		if(m_isThrowExceptions)
+			throw;
+		logWShvJournal() << e.what();
+	}
 }
 
 bool ShvLogRpcValueReader::next()
 {
-	using Column = ShvLogHeader::Column;
+	if(m_pullReader)
+		return nextStreamed();
+	if(ShvLogColumnsReader::isColumnar(m_log))
+		return nextColumnar();
 	while(true) {
 		m_currentEntry = ShvJournalEntry();
 		const chainpack::RpcValue::List &list = m_log.toList();
 		if(m_currentIndex >= list.size())
 			return false;
+		if(readRow(list[m_currentIndex++]))
+			return true;
+	}
+}
 
-		const cp::RpcValue &val = list[m_currentIndex++];
-		const chainpack::RpcValue::List &row = val.toList();
-		cp::RpcValue dt = row.value(Column::Timestamp);
-		if(!dt.isDateTime()) {
-			if(m_isThrowExceptions)
-				throw shv::core::Exception("Invalid date time, row: " + val.toCpon());
-			else
-				logWShvJournal() << "Skipping invalid date time, row:" << val.toCpon();
-			continue;
+bool ShvLogRpcValueReader::nextStreamed()
+{
+	while(true) {
+		m_currentEntry = ShvJournalEntry();
+		cp::RpcValue val;
+		try {
+			if(m_pullReader->next() == cp::PullReader::Event::ContainerEnd) {
+				m_pullReader.reset();
+				return false;
+			}
+			val = m_pullReader->readValue();
 		}
-		int64_t time = dt.toDateTime().msecsSinceEpoch();
-		cp::RpcValue p = row.value(Column::Path);
-		if(p.isInt())
-			p = m_logHeader.pathDictCRef().value(p.toInt());
-		const std::string &path = p.asString();
-		if(path.empty()) {
+		catch (const cp::PullReader::ParseException &e) {
+			m_pullReader.reset();
 			if(m_isThrowExceptions)
-				throw shv::core::Exception("Path dictionary corrupted, row: " + val.toCpon());
-			else
-				logWShvJournal() << "Path dictionary corrupted, row:" << val.toCpon();
-			continue;
+				SHV_EXCEPTION(std::string("Log is corrupted! ") + e.what());
+			logWShvJournal() << "Log is corrupted, rest of log will be skipped:" << e.what();
+			return false;
 		}
-		//logDShvJournal() << "row:" << val.toCpon();
-		m_currentEntry.epochMsec = time;
-		m_currentEntry.path = path;
-		m_currentEntry.value = row.value(Column::Value);
-		cp::RpcValue st = row.value(Column::ShortTime);
-		m_currentEntry.shortTime = (st.isInt() && st.toInt() >= 0)? st.toInt(): ShvJournalEntry::NO_SHORT_TIME;
-		m_currentEntry.domain = row.value(Column::Domain).asString();
-		if(m_currentEntry.domain.empty() || m_currentEntry.domain == "C")
-			m_currentEntry.domain = ShvJournalEntry::DOMAIN_VAL_CHANGE;
-		m_currentEntry.valueFlags = row.value(Column::ValueFlags).toUInt();
-		m_currentEntry.userId = row.value(Column::UserId).asString();
-		return true;
+		m_currentIndex++;
+		if(readRow(val))
+			return true;
+	}
+}
+
+bool ShvLogRpcValueReader::readRow(const chainpack::RpcValue &val)
+{
+	using Column = ShvLogHeader::Column;
+	const chainpack::RpcValue::List &row = val.toList();
+	cp::RpcValue dt = row.value(Column::Timestamp);
+	if(!dt.isDateTime()) {
+		if(m_isThrowExceptions)
+			throw shv::core::Exception("Invalid date time, row: " + val.toCpon());
+		else
+			logWShvJournal() << "Skipping invalid date time, row:" << val.toCpon();
+		return false;
+	}
+	int64_t time = dt.toDateTime().msecsSinceEpoch();
+	cp::RpcValue p = row.value(Column::Path);
+	if(p.isInt())
+		p = m_logHeader.pathDictCRef().value(p.toInt());
+	const std::string &path = p.asString();
+	if(path.empty()) {
+		if(m_isThrowExceptions)
+			throw shv::core::Exception("Path dictionary corrupted, row: " + val.toCpon());
+		else
+			logWShvJournal() << "Path dictionary corrupted, row:" << val.toCpon();
+		return false;
+	}
+	//logDShvJournal() << "row:" << val.toCpon();
+	m_currentEntry.epochMsec = time;
+	m_currentEntry.path = path;
+	m_currentEntry.value = row.value(Column::Value);
+	cp::RpcValue st = row.value(Column::ShortTime);
+	m_currentEntry.shortTime = (st.isInt() && st.toInt() >= 0)? st.toInt(): ShvJournalEntry::NO_SHORT_TIME;
+	m_currentEntry.domain = row.value(Column::Domain).asString();
+	if(m_currentEntry.domain.empty() || m_currentEntry.domain == "C")
+		m_currentEntry.domain = ShvJournalEntry::DOMAIN_VAL_CHANGE;
+	m_currentEntry.valueFlags = row.value(Column::ValueFlags).toUInt();
+	m_currentEntry.userId = row.value(Column::UserId).asString();
+	return true;
+}
+
+bool ShvLogRpcValueReader::nextColumnar()
+{
+	m_currentEntry = ShvJournalEntry();
+	if(!m_columnsReader)
+		return false;
+	try {
+		return m_columnsReader->next(m_currentEntry);
+	}
+	catch (const shv::core::Exception &e) {
+		if(m_isThrowExceptions)
+			throw;
+		logWShvJournal() << "Columnar log corrupted, rest of log will be skipped:" << e.what();
+		m_columnsReader.reset();
+		m_currentEntry = ShvJournalEntry();
+		return false;
 	}
 }
 
@@ -4,30 +4,48 @@
 #include "shvlogheader.h"
 #include "shvjournalentry.h"
 
+#include <shv/chainpack/pullreader.h>
+
+#include <istream>
+#include <memory>
+
 namespace shv {
 namespace core {
 namespace utils {
 
 class ShvJournalEntry;
+class ShvLogColumnsReader;
 
+/// reads both List of records and columnar log
 class SHVCORE_DECL_EXPORT ShvLogRpcValueReader
 {
 public:
 	ShvLogRpcValueReader(const shv::chainpack::RpcValue &log, bool throw_exceptions = false);
+	/// List of records is decoded from stream record by record, so the whole log is never held in memory,
+	/// columnar log is read completely
+	ShvLogRpcValueReader(std::istream &in, shv::chainpack::PullReader::Format format, bool throw_exceptions = false);
+	~ShvLogRpcValueReader();
 
 	bool next();
 	bool isInSnapshot() const { return m_snapshotMsec == m_currentEntry.epochMsec || m_currentEntry.isSnapshotValue(); }
 	const ShvJournalEntry& entry() { return m_currentEntry; }
 
 	const ShvLogHeader &logHeader() const {return m_logHeader;}
+private:
+	void initColumnsReader();
+	bool nextColumnar();
+	bool nextStreamed();
+	bool readRow(const shv::chainpack::RpcValue &val);
 private:
 	ShvLogHeader m_logHeader;
 	ShvJournalEntry m_currentEntry;
 
-	const shv::chainpack::RpcValue m_log;
+	shv::chainpack::RpcValue m_log;
 	bool m_isThrowExceptions;
 	size_t m_currentIndex = 0;
 	int64_t m_snapshotMsec = -1;
+	std::unique_ptr<ShvLogColumnsReader> m_columnsReader;
+	std::unique_ptr<shv::chainpack::PullReader> m_pullReader;
 };
 
 } // namespace utils
@@ -1,4 +1,5 @@
 #include "shvmemoryjournal.h"
+#include "shvlogcolumns.h"
 #include "shvlogheader.h"
 #include "shvpath.h"
 #include "shvfilejournal.h"
@@ -151,6 +152,8 @@ chainpack::RpcValue ShvMemoryJournal::getLog(const ShvGetLogParams &params)
 	logIShvJournal() << "params:" << params.toRpcValue().toCpon();
 	using Column = ShvLogHeader::Column;
 	cp::RpcValue::List log;
+	ShvLogColumnsWriter log_columns;
+	const bool with_paths_dict = params.withPathsDict || params.columnar;
 	cp::RpcValue::Map path_cache;
 	int max_path_index = 0;
 	int rec_cnt = 0;
@@ -195,11 +198,11 @@ chainpack::RpcValue ShvMemoryJournal::getLog(const ShvGetLogParams &params)
 		}
 
 		/// this ensure that there be only one copy of each path in memory
-		auto make_path_shared = [&path_cache, &max_path_index, &params](const std::string &path) -> cp::RpcValue {
+		auto make_path_shared = [&path_cache, &max_path_index, with_paths_dict](const std::string &path) -> cp::RpcValue {
 			cp::RpcValue ret = path_cache.value(path);
 			if(ret.isValid())
 				return ret;
-			if(params.withPathsDict)
+			if(with_paths_dict)
 				ret = ++max_path_index;
 			else
 				ret = path;
@@ -221,6 +224,12 @@ chainpack::RpcValue ShvMemoryJournal::getLog(const ShvGetLogParams &params)
 			rec.push_back(e.userId.empty()? cp::RpcValue(nullptr): cp::RpcValue(e.userId));
 			return rec;
 		};
+		auto append_record = [&entry_to_rpcvalue, &make_path_shared, &log, &log_columns, &params](int64_t epoch_msec, const Entry &e) {
+			if(params.columnar)
+				log_columns.append(e, epoch_msec, make_path_shared(e.path).toInt());
+			else
+				log.push_back(entry_to_rpcvalue(epoch_msec, e));
+		};
 
 		ShvSnapshot snapshot;
 		if(params.withSnapshot) {
@@ -245,7 +254,7 @@ chainpack::RpcValue ShvMemoryJournal::getLog(const ShvGetLogParams &params)
 					if(since_msec == 0)
 						since_msec = entry.epochMsec;
 					last_record_msec = since_msec;
-					log.push_back(entry_to_rpcvalue(since_msec, entry));
+					append_record(since_msec, entry);
 					rec_cnt++;
 				}
 			}
@@ -263,14 +272,14 @@ chainpack::RpcValue ShvMemoryJournal::getLog(const ShvGetLogParams &params)
 						since_msec = it->epochMsec;
 					last_record_msec = it->epochMsec;
 
-					log.push_back(entry_to_rpcvalue(it->epochMsec, *it));
+					append_record(it->epochMsec, *it);
 					rec_cnt++;
 				}
 			}
 		}
 	}
 log_finish:
-	cp::RpcValue ret = log;
+	cp::RpcValue ret = params.columnar? log_columns.takeColumns(): cp::RpcValue(std::move(log));
 	ShvLogHeader hdr;
 	{
 		hdr.setDeviceId(m_logHeader.deviceId());
@@ -289,7 +298,7 @@ log_finish:
 		hdr.setRecordCountLimit(rec_cnt_limit);
 		hdr.setRecordCountLimitHit(rec_cnt_limit_hit);
 		hdr.setWithSnapShot(params.withSnapshot);
-		hdr.setWithPathsDict(params.withPathsDict);
+		hdr.setWithPathsDict(with_paths_dict);
 
 		cp::RpcValue::List fields;
 		fields.push_back(cp::RpcValue::Map{{KEY_NAME, Column::name(Column::Enum::Timestamp)}});
@@ -304,7 +313,7 @@ log_finish:
 		if(params.withTypeInfo)
 			hdr.copyTypeInfo(m_logHeader);
 	}
-	if(params.withPathsDict) {
+	if(with_paths_dict) {
 		logIShvJournal() << "Generating paths dict";
 		cp::RpcValue::IMap path_dict;
 		for(auto kv : path_cache) {
@@ -8,7 +8,7 @@ namespace shv {
 namespace core {
 namespace utils {
 
-ShvUrl::ShvUrl(const std::string &shv_path)
+ShvUrl::ShvUrl(const StringView &shv_path)
 	: m_shvPath(shv_path)
 {
 	auto ix = serviceProviderMarkIndex(shv_path);
@@ -20,17 +20,17 @@ ShvUrl::ShvUrl(const std::string &shv_path)
 			m_type = Type::MountPointRelativeService;
 		else if(type_mark == DOWNTREE_MARK)
 			m_type = Type::DownTreeService;
-		m_service = StringView(shv_path, 0, ix);
+		m_service = shv_path.mid(0, ix);
 		ssize_t bid_ix = m_service.lastIndexOf('@');
 		if(bid_ix > 0) {
 			m_fullBrokerId = m_service.mid(bid_ix);
 			m_service = m_service.mid(0, bid_ix);
 		}
-		m_pathPart = StringView(shv_path, ix + typeMark(m_type).size() + 1);
+		m_pathPart = shv_path.mid(ix + typeMark(m_type).size() + 1);
 	}
 	else {
 		m_type = Type::Plain;
-		m_pathPart = StringView(shv_path);
+		m_pathPart = shv_path;
 	}
 }
 
@@ -87,7 +87,7 @@ std::string ShvUrl::makeShvUrlString(ShvUrl::Type type, const StringView &servic
 	return StringViewList{srv, path_rest}.join(ShvPath::SHV_PATH_DELIM);
 }
 
-size_t ShvUrl::serviceProviderMarkIndex(const std::string &path)
+size_t ShvUrl::serviceProviderMarkIndex(const StringView &path)
 {
 	for (size_t ix = 1; ix + 1 < path.size(); ++ix) {
 		if(path[ix + 1] == END_MARK && (path.size() == ix + 2 || path[ix + 2] == ShvPath::SHV_PATH_DELIM)) {
@@ -12,7 +12,8 @@ class SHVCORE_DECL_EXPORT ShvUrl
 public:
 	enum class Type { Plain, AbsoluteService, MountPointRelativeService, DownTreeService };
 public:
-	ShvUrl(const std::string &shv_path);
+	/// shv_path buffer must outlive the ShvUrl instance, all the parts are views into it
+	ShvUrl(const StringView &shv_path);
 
 	bool isServicePath() const { return type() != Type::Plain; }
 	bool isUpTreeMountPointRelative() const { return type() == Type::MountPointRelativeService; }
@@ -29,7 +30,7 @@ public:
 	StringView pathPart() const { return m_pathPart; }
 	std::string toPlainPath(const StringView &path_part_prefix = {}) const;
 	std::string toString(const StringView &path_part_prefix = {}) const;
-	const std::string& shvPath() const { return m_shvPath;}
+	std::string shvPath() const { return m_shvPath.toString();}
 
 	static std::string makeShvUrlString(Type type, const StringView &service, const StringView &full_broker_id, const StringView &path_rest);
 	//static std::string joinPath(const StringView &a, const StringView &b);
@@ -39,11 +40,11 @@ private:
 	static constexpr char ABSOLUTE_MARK = '|';
 	static constexpr char DOWNTREE_MARK = '>';
 
-	static size_t serviceProviderMarkIndex(const std::string &path);
+	static size_t serviceProviderMarkIndex(const StringView &path);
 	std::string typeMark() const { return typeMark(type()); }
 	static std::string typeMark(Type t);
 private:
-	const std::string &m_shvPath;
+	StringView m_shvPath;
 	Type m_type = Type::Plain;
 	StringView m_service;
 	StringView m_fullBrokerId; // including @, like '@mpk'
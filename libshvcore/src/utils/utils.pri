@@ -1,12 +1,15 @@
 HEADERS += \
     $$PWD/abstractshvjournal.h \
     $$PWD/crypt.h \
+    $$PWD/mappedfile.h \
+    $$PWD/mpscringbuffer.h \
     $$PWD/shvalarm.h \
     $$PWD/shvfilejournal.h \
     $$PWD/shvgetlogparams.h \
     $$PWD/shvjournalentry.h \
     $$PWD/shvjournalfilereader.h \
     $$PWD/shvjournalfilewriter.h \
+    $$PWD/shvlogcolumns.h \
     $$PWD/shvlogfilereader.h \
     $$PWD/shvlogheader.h \
     $$PWD/shvlogrpcvaluereader.h \
@@ -22,12 +25,14 @@ HEADERS += \
 SOURCES += \
     $$PWD/abstractshvjournal.cpp \
     $$PWD/crypt.cpp \
+    $$PWD/mappedfile.cpp \
     $$PWD/shvalarm.cpp \
     $$PWD/shvfilejournal.cpp \
     $$PWD/shvgetlogparams.cpp \
     $$PWD/shvjournalentry.cpp \
     $$PWD/shvjournalfilereader.cpp \
     $$PWD/shvjournalfilewriter.cpp \
+    $$PWD/shvlogcolumns.cpp \
     $$PWD/shvlogfilereader.cpp \
     $$PWD/shvlogheader.cpp \
     $$PWD/shvlogrpcvaluereader.cpp \
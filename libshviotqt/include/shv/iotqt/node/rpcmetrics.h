@@ -0,0 +1 @@
+#include "../../../../src/node/rpcmetrics.h"
@@ -3,6 +3,8 @@ HEADERS += \
     $$PWD/shvnode.h \
     $$PWD/localfsnode.h \
 	$$PWD/filenode.h \
+	$$PWD/rpcmetrics.h \
+	$$PWD/rpcmetricsnode.h \
     #$$PWD/shvtreenode.h
 
 SOURCES += \
@@ -10,4 +12,6 @@ SOURCES += \
     $$PWD/shvnode.cpp \
     $$PWD/localfsnode.cpp \
 	$$PWD/filenode.cpp \
+	$$PWD/rpcmetrics.cpp \
+	$$PWD/rpcmetricsnode.cpp \
     #$$PWD/shvtreenode.cpp
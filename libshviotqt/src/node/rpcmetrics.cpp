@@ -0,0 +1,247 @@
+#include "rpcmetrics.h"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace cp = shv::chainpack;
+
+namespace shv {
+namespace iotqt {
+namespace node {
+
+//===========================================================
+// RpcMetrics::Histogram
+//===========================================================
+constexpr size_t RpcMetrics::Histogram::LINEAR_BUCKET_COUNT;
+constexpr size_t RpcMetrics::Histogram::SUB_BUCKET_COUNT;
+constexpr size_t RpcMetrics::Histogram::BUCKET_COUNT;
+
+static int most_significant_bit(uint64_t n)
+{
+#if defined(__GNUC__)
+	return 63 - __builtin_clzll(n);
+#else
+	int msb = 0;
+	while (n >>= 1)
+		msb++;
+	return msb;
+#endif
+}
+
+size_t RpcMetrics::Histogram::bucketIndex(uint64_t usec)
+{
+	if(usec < LINEAR_BUCKET_COUNT)
+		return static_cast<size_t>(usec);
+	// msb >= 4, 2 bits below msb select one of 4 sub-buckets
+	const int msb = most_significant_bit(usec);
+	const size_t sub = static_cast<size_t>(usec >> (msb - 2)) & (SUB_BUCKET_COUNT - 1);
+	return LINEAR_BUCKET_COUNT + static_cast<size_t>(msb - 4) * SUB_BUCKET_COUNT + sub;
+}
+
+uint64_t RpcMetrics::Histogram::bucketUpperBound(size_t ix)
+{
+	if(ix < LINEAR_BUCKET_COUNT)
+		return ix;
+	const int msb = 4 + static_cast<int>((ix - LINEAR_BUCKET_COUNT) / SUB_BUCKET_COUNT);
+	const uint64_t sub = (ix - LINEAR_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+	const uint64_t lower = (uint64_t{1} << msb) + (sub << (msb - 2));
+	return lower + ((uint64_t{1} << (msb - 2)) - 1);
+}
+
+uint64_t RpcMetrics::Histogram::percentile(double p) const
+{
+	uint64_t total = 0;
+	for(uint64_t n : m_buckets)
+		total += n;
+	if(total == 0)
+		return 0;
+	uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100 * static_cast<double>(total)));
+	if(rank == 0)
+		rank = 1;
+	uint64_t cnt = 0;
+	for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+		cnt += m_buckets[i];
+		if(cnt >= rank)
+			return bucketUpperBound(i);
+	}
+	return bucketUpperBound(BUCKET_COUNT - 1);
+}
+
+//===========================================================
+// RpcMetrics
+//===========================================================
+constexpr size_t RpcMetrics::DEFAULT_MAX_SERIES_COUNT;
+const char *RpcMetrics::OTHER_PATH = "<other>";
+const char *RpcMetrics::UNRESOLVED_METHOD = "<unresolved>";
+
+RpcMetrics &RpcMetrics::instance()
+{
+	static RpcMetrics s_instance;
+	return s_instance;
+}
+
+RpcMetrics::MethodMetrics &RpcMetrics::series(const std::string &shv_path, const std::string &method)
+{
+	auto it1 = m_metrics.find(shv_path);
+	if(it1 != m_metrics.end()) {
+		auto it2 = it1->second.find(method);
+		if(it2 != it1->second.end())
+			return it2->second;
+	}
+	if(m_seriesCount >= m_maxSeriesCount) {
+		std::map<std::string, MethodMetrics> &other = m_metrics[OTHER_PATH];
+		auto it2 = other.find(method);
+		if(it2 != other.end())
+			return it2->second;
+		// keep the other bucket bounded too, arbitrary method names can be called on arbitrary paths
+		if(other.size() >= m_maxSeriesCount)
+			return other[OTHER_PATH];
+		m_seriesCount++;
+		return other[method];
+	}
+	m_seriesCount++;
+	return m_metrics[shv_path][method];
+}
+
+static uint64_t usec_since(RpcMetrics::Clock::time_point start)
+{
+	auto usec = std::chrono::duration_cast<std::chrono::microseconds>(RpcMetrics::Clock::now() - start).count();
+	return static_cast<uint64_t>(usec < 0? 0: usec);
+}
+
+void RpcMetrics::record(const std::string &shv_path, const std::string &method, Clock::time_point start, bool is_error)
+{
+	record(shv_path, method, usec_since(start), is_error);
+}
+
+void RpcMetrics::record(const std::string &shv_path, const std::string &method, uint64_t usec, bool is_error)
+{
+	if(!m_enabled)
+		return;
+	recordUsec(series(shv_path, method), usec, is_error);
+}
+
+void RpcMetrics::recordUnresolved(Clock::time_point start)
+{
+	if(!m_enabled)
+		return;
+	static const std::string other_path(OTHER_PATH);
+	static const std::string unresolved_method(UNRESOLVED_METHOD);
+	// this series is always created, it must not be pushed out by the max series limit
+	std::map<std::string, MethodMetrics> &other = m_metrics[other_path];
+	auto it = other.find(unresolved_method);
+	if(it == other.end()) {
+		m_seriesCount++;
+		it = other.emplace(unresolved_method, MethodMetrics()).first;
+	}
+	recordUsec(it->second, usec_since(start), true);
+}
+
+void RpcMetrics::recordUsec(MethodMetrics &mm, uint64_t usec, bool is_error)
+{
+	mm.callCount++;
+	if(is_error)
+		mm.errorCount++;
+	mm.totalUsec += usec;
+	if(usec > mm.maxUsec)
+		mm.maxUsec = usec;
+	mm.histogram.record(usec);
+}
+
+void RpcMetrics::clear()
+{
+	m_metrics.clear();
+	m_seriesCount = 0;
+}
+
+const RpcMetrics::MethodMetrics *RpcMetrics::metrics(const std::string &shv_path, const std::string &method) const
+{
+	auto it1 = m_metrics.find(shv_path);
+	if(it1 == m_metrics.end())
+		return nullptr;
+	auto it2 = it1->second.find(method);
+	if(it2 == it1->second.end())
+		return nullptr;
+	return &it2->second;
+}
+
+cp::RpcValue RpcMetrics::toRpcValue() const
+{
+	cp::RpcValue::List ret;
+	for(const auto &kv1 : m_metrics) {
+		for(const auto &kv2 : kv1.second) {
+			const MethodMetrics &mm = kv2.second;
+			ret.push_back(cp::RpcValue::Map{
+							  {"path", kv1.first},
+							  {"method", kv2.first},
+							  {"calls", static_cast<int64_t>(mm.callCount)},
+							  {"errors", static_cast<int64_t>(mm.errorCount)},
+							  {"totalUsec", static_cast<int64_t>(mm.totalUsec)},
+							  {"maxUsec", static_cast<int64_t>(mm.maxUsec)},
+							  {"p50Usec", static_cast<int64_t>(mm.histogram.percentile(50))},
+							  {"p99Usec", static_cast<int64_t>(mm.histogram.percentile(99))},
+							  {"p999Usec", static_cast<int64_t>(mm.histogram.percentile(99.9))},
+						  });
+		}
+	}
+	return ret;
+}
+
+namespace {
+std::string prometheus_escape(const std::string &s)
+{
+	std::string ret;
+	ret.reserve(s.size());
+	for(char c : s) {
+		switch (c) {
+		case '\\': ret += "\\\\"; break;
+		case '"': ret += "\\\""; break;
+		case '\n': ret += "\\n"; break;
+		default: ret += c; break;
+		}
+	}
+	return ret;
+}
+}
+
+std::string RpcMetrics::toPrometheusText() const
+{
+	// coarse bucket set with stable boundaries, fine grained internal buckets are folded into them
+	static const uint64_t le_usec[] = {100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000};
+	std::ostringstream out;
+	out.precision(std::numeric_limits<double>::digits10);
+	out << "# HELP shv_rpc_calls_total Number of RPC calls handled by shv node.\n";
+	out << "# TYPE shv_rpc_calls_total counter\n";
+	for(const auto &kv1 : m_metrics)
+		for(const auto &kv2 : kv1.second)
+			out << "shv_rpc_calls_total{path=\"" << prometheus_escape(kv1.first) << "\",method=\"" << prometheus_escape(kv2.first) << "\"} " << kv2.second.callCount << '\n';
+	out << "# HELP shv_rpc_errors_total Number of RPC calls finished with error.\n";
+	out << "# TYPE shv_rpc_errors_total counter\n";
+	for(const auto &kv1 : m_metrics)
+		for(const auto &kv2 : kv1.second)
+			out << "shv_rpc_errors_total{path=\"" << prometheus_escape(kv1.first) << "\",method=\"" << prometheus_escape(kv2.first) << "\"} " << kv2.second.errorCount << '\n';
+	out << "# HELP shv_rpc_duration_seconds RPC call handling duration.\n";
+	out << "# TYPE shv_rpc_duration_seconds histogram\n";
+	for(const auto &kv1 : m_metrics) {
+		for(const auto &kv2 : kv1.second) {
+			const std::string labels = "path=\"" + prometheus_escape(kv1.first) + "\",method=\"" + prometheus_escape(kv2.first) + "\"";
+			const MethodMetrics &mm = kv2.second;
+			uint64_t cnt = 0;
+			size_t bucket_ix = 0;
+			for(uint64_t le : le_usec) {
+				while(bucket_ix < Histogram::BUCKET_COUNT && Histogram::bucketUpperBound(bucket_ix) <= le)
+					cnt += mm.histogram.bucketCount(bucket_ix++);
+				out << "shv_rpc_duration_seconds_bucket{" << labels << ",le=\"" << static_cast<double>(le) / 1000000 << "\"} " << cnt << '\n';
+			}
+			out << "shv_rpc_duration_seconds_bucket{" << labels << ",le=\"+Inf\"} " << mm.callCount << '\n';
+			out << "shv_rpc_duration_seconds_sum{" << labels << "} " << static_cast<double>(mm.totalUsec) / 1000000 << '\n';
+			out << "shv_rpc_duration_seconds_count{" << labels << "} " << mm.callCount << '\n';
+		}
+	}
+	return out.str();
+}
+
+} // namespace node
+} // namespace iotqt
+} // namespace shv
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../shviotqtglobal.h"
+
+#include <shv/chainpack/rpcvalue.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace shv {
+namespace iotqt {
+namespace node {
+
+/// Per (shv path, method) RPC call counters and latency histograms
+/// recorded by ShvNode request handlers, not thread safe, use it from the node tree thread only
+class SHVIOTQT_DECL_EXPORT RpcMetrics
+{
+public:
+	/// log-linear histogram of latencies in usec, exact values up to 16 usec,
+	/// then every power of two interval is split into 4 buckets
+	class SHVIOTQT_DECL_EXPORT Histogram
+	{
+	public:
+		static constexpr size_t LINEAR_BUCKET_COUNT = 16;
+		static constexpr size_t SUB_BUCKET_COUNT = 4;
+		static constexpr size_t BUCKET_COUNT = LINEAR_BUCKET_COUNT + (64 - 4) * SUB_BUCKET_COUNT;
+
+		void record(uint64_t usec) { m_buckets[bucketIndex(usec)]++; }
+		uint64_t bucketCount(size_t ix) const { return m_buckets[ix]; }
+		/// percentile in range 0 - 100, result is upper bound of bucket containing the percentile
+		uint64_t percentile(double p) const;
+
+		static size_t bucketIndex(uint64_t usec);
+		static uint64_t bucketUpperBound(size_t ix);
+	private:
+		std::array<uint64_t, BUCKET_COUNT> m_buckets = {};
+	};
+
+	struct MethodMetrics
+	{
+		uint64_t callCount = 0;
+		uint64_t errorCount = 0;
+		uint64_t totalUsec = 0;
+		uint64_t maxUsec = 0;
+		Histogram histogram;
+	};
+
+	/// calls above this limit are accounted to OTHER_PATH to limit memory usage
+	static constexpr size_t DEFAULT_MAX_SERIES_COUNT = 1000;
+	static const char *OTHER_PATH;
+	/// calls of nonexistent path or method are accounted to single series OTHER_PATH, UNRESOLVED_METHOD
+	static const char *UNRESOLVED_METHOD;
+
+	using Clock = std::chrono::steady_clock;
+public:
+	static RpcMetrics& instance();
+
+	bool isEnabled() const { return m_enabled; }
+	void setEnabled(bool b) { m_enabled = b; }
+	size_t maxSeriesCount() const { return m_maxSeriesCount; }
+	void setMaxSeriesCount(size_t n) { m_maxSeriesCount = n; }
+
+	void record(const std::string &shv_path, const std::string &method, Clock::time_point start, bool is_error);
+	void record(const std::string &shv_path, const std::string &method, uint64_t usec, bool is_error);
+	void recordUnresolved(Clock::time_point start);
+	void clear();
+
+	const MethodMetrics* metrics(const std::string &shv_path, const std::string &method) const;
+	size_t seriesCount() const { return m_seriesCount; }
+
+	/// [{"path": str, "method": str, "calls": int, "errors": int, "totalUsec": int, "maxUsec": int, "p50Usec": int, "p99Usec": int, "p999Usec": int}, ...]
+	shv::chainpack::RpcValue toRpcValue() const;
+	/// Prometheus text exposition format, histogram buckets are written as cumulative shv_rpc_duration_seconds_bucket
+	std::string toPrometheusText() const;
+private:
+	RpcMetrics() = default;
+	MethodMetrics& series(const std::string &shv_path, const std::string &method);
+	static void recordUsec(MethodMetrics &mm, uint64_t usec, bool is_error);
+private:
+	bool m_enabled = true;
+	size_t m_maxSeriesCount = DEFAULT_MAX_SERIES_COUNT;
+	size_t m_seriesCount = 0;
+	std::map<std::string, std::map<std::string, MethodMetrics>> m_metrics;
+};
+
+} // namespace node
+} // namespace iotqt
+} // namespace shv
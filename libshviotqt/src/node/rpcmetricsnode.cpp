@@ -0,0 +1,59 @@
+#include "rpcmetricsnode.h"
+#include "rpcmetrics.h"
+
+#include <shv/chainpack/metamethod.h>
+#include <shv/chainpack/rpc.h>
+
+namespace cp = shv::chainpack;
+
+namespace shv {
+namespace iotqt {
+namespace node {
+
+const char *RpcMetricsNode::NODE_ID = "metrics";
+const char *RpcMetricsNode::M_GET = "get";
+const char *RpcMetricsNode::M_PROMETHEUS = "prometheus";
+const char *RpcMetricsNode::M_RESET = "reset";
+const char *RpcMetricsNode::M_ENABLED = "enabled";
+const char *RpcMetricsNode::M_SET_ENABLED = "setEnabled";
+
+static const std::vector<cp::MetaMethod> meta_methods {
+	{cp::Rpc::METH_DIR, cp::MetaMethod::Signature::RetParam, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_BROWSE},
+	{cp::Rpc::METH_LS, cp::MetaMethod::Signature::RetParam, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_BROWSE},
+	{RpcMetricsNode::M_GET, cp::MetaMethod::Signature::RetVoid, cp::MetaMethod::Flag::IsGetter | cp::MetaMethod::Flag::LargeResultHint, cp::Rpc::ROLE_READ,
+		"Returns list of {path, method, calls, errors, totalUsec, maxUsec, p50Usec, p99Usec, p999Usec}"},
+	{RpcMetricsNode::M_PROMETHEUS, cp::MetaMethod::Signature::RetVoid, cp::MetaMethod::Flag::LargeResultHint, cp::Rpc::ROLE_READ,
+		"Returns metrics in Prometheus text exposition format"},
+	{RpcMetricsNode::M_RESET, cp::MetaMethod::Signature::VoidVoid, cp::MetaMethod::Flag::None, cp::Rpc::ROLE_COMMAND},
+	{RpcMetricsNode::M_ENABLED, cp::MetaMethod::Signature::RetVoid, cp::MetaMethod::Flag::IsGetter, cp::Rpc::ROLE_READ},
+	{RpcMetricsNode::M_SET_ENABLED, cp::MetaMethod::Signature::VoidParam, cp::MetaMethod::Flag::IsSetter, cp::Rpc::ROLE_CONFIG},
+};
+
+RpcMetricsNode::RpcMetricsNode(ShvNode *parent)
+	: Super(NODE_ID, &meta_methods, parent)
+{
+}
+
+cp::RpcValue RpcMetricsNode::callMethod(const StringViewList &shv_path, const std::string &method, const cp::RpcValue &params, const cp::RpcValue &user_id)
+{
+	if(shv_path.empty()) {
+		RpcMetrics &metrics = RpcMetrics::instance();
+		if(method == M_GET)
+			return metrics.toRpcValue();
+		if(method == M_PROMETHEUS)
+			return metrics.toPrometheusText();
+		if(method == M_RESET) {
+			metrics.clear();
+			return true;
+		}
+		if(method == M_ENABLED)
+			return metrics.isEnabled();
+		if(method == M_SET_ENABLED) {
+			metrics.setEnabled(params.toBool());
+			return true;
+		}
+	}
+	return Super::callMethod(shv_path, method, params, user_id);
+}
+
+}}}
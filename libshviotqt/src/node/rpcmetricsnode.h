@@ -0,0 +1,28 @@
+#pragma once
+
+#include "shvnode.h"
+
+namespace shv {
+namespace iotqt {
+namespace node {
+
+/// Exposes RpcMetrics::instance(), applications usually mount it as .app/metrics
+class SHVIOTQT_DECL_EXPORT RpcMetricsNode : public MethodsTableNode
+{
+	Q_OBJECT
+
+	using Super = MethodsTableNode;
+public:
+	static const char *NODE_ID;
+	static const char *M_GET;
+	static const char *M_PROMETHEUS;
+	static const char *M_RESET;
+	static const char *M_ENABLED;
+	static const char *M_SET_ENABLED;
+public:
+	explicit RpcMetricsNode(ShvNode *parent = nullptr);
+
+	shv::chainpack::RpcValue callMethod(const StringViewList &shv_path, const std::string &method, const shv::chainpack::RpcValue &params, const shv::chainpack::RpcValue &user_id) override;
+};
+
+}}}
@@ -1,4 +1,5 @@
 #include "shvnode.h"
+#include "rpcmetrics.h"
 #include "../utils.h"
 
 #include <shv/core/utils/shvfilejournal.h>
@@ -38,6 +39,21 @@ namespace node {
 std::string ShvNode::LOCAL_NODE_HACK = ".local";
 std::string ShvNode::ADD_LOCAL_TO_LS_RESULT_HACK_META_KEY = "__add_local_to_ls_hack";
 
+namespace {
+/// walks child nodes along shv_path and checks if the last one found has method requested
+bool is_method_resolved(ShvNode *nd, const ShvNode::StringViewList &shv_path, const std::string &method)
+{
+	size_t ix = 0;
+	for(; ix < shv_path.size(); ++ix) {
+		ShvNode *child = nd->childNode(shv_path.at(ix).toString(), !shv::core::Exception::Throw);
+		if(!child)
+			break;
+		nd = child;
+	}
+	return nd->metaMethod(shv_path.mid(ix), method) != nullptr;
+}
+}
+
 ShvNode::ShvNode(ShvNode *parent)
 	: QObject(parent)
 {
@@ -137,7 +153,9 @@ void ShvNode::handleRawRpcRequest(RpcValue::MetaData &&meta, std::string &&data)
 	ShvUrl shv_url(RpcMessage::shvPath(meta).asString());
 	core::StringViewList shv_path = ShvPath::split(shv_url.pathPart());
 	const bool ls_hook = meta.hasKey(ADD_LOCAL_TO_LS_RESULT_HACK_META_KEY);
+	const RpcMetrics::Clock::time_point start = RpcMetrics::Clock::now();
 	RpcResponse resp = RpcResponse::forRequest(meta);
+	bool method_resolved = false;
 	try {
 		if(!shv_path.empty()) {
 			ShvNode *nd = childNode(shv_path.at(0).toString(), !shv::core::Exception::Throw);
@@ -155,6 +173,7 @@ void ShvNode::handleRawRpcRequest(RpcValue::MetaData &&meta, std::string &&data)
 		const chainpack::MetaMethod *mm = metaMethod(shv_path, method);
 		if(mm) {
 			shvDebug() << "Metamethod:" << method << "on path:" << ShvPath::joinDirs(shv_path) << "FOUND";
+			method_resolved = true;
 			std::string errmsg;
 			RpcMessage rpc_msg = RpcDriver::composeRpcMessage(std::move(meta), data, &errmsg);
 			if(!errmsg.empty())
@@ -182,6 +201,13 @@ void ShvNode::handleRawRpcRequest(RpcValue::MetaData &&meta, std::string &&data)
 		RpcResponse::Error err = RpcResponse::Error::create(RpcResponse::Error::MethodCallException , err_str);
 		resp.setError(err);
 	}
+	RpcMetrics &metrics = RpcMetrics::instance();
+	if(metrics.isEnabled()) {
+		if(method_resolved)
+			metrics.record(shv::core::Utils::joinPath(shvPath(), shv_path_str), method, start, resp.isError());
+		else
+			metrics.recordUnresolved(start);
+	}
 	if(resp.hasRetVal()) {
 		ShvNode *root = rootNode();
 		if(root) {
@@ -206,6 +232,7 @@ void ShvNode::handleRpcRequest(const chainpack::RpcRequest &rq)
 	const chainpack::RpcValue::String &method = rq.method().asString();
 	const chainpack::RpcValue::String &shv_path_str = rq.shvPath().asString();
 	core::StringViewList shv_path = ShvPath::split(shv_path_str);
+	const RpcMetrics::Clock::time_point start = RpcMetrics::Clock::now();
 	RpcResponse resp = RpcResponse::forRequest(rq);
 	try {
 		chainpack::RpcValue ret_val = handleRpcRequestImpl(rq);
@@ -221,6 +248,14 @@ void ShvNode::handleRpcRequest(const chainpack::RpcRequest &rq)
 		shvError() << e.what();
 		resp.setError(RpcResponse::Error::create(RpcResponse::Error::MethodCallException, e.what()));
 	}
+	RpcMetrics &metrics = RpcMetrics::instance();
+	if(metrics.isEnabled()) {
+		// successful call was resolved for sure, look the method up on error only
+		if(!resp.isError() || is_method_resolved(this, shv_path, method))
+			metrics.record(shv::core::Utils::joinPath(shvPath(), shv_path_str), method, start, resp.isError());
+		else
+			metrics.recordUnresolved(start);
+	}
 	if(resp.hasResult()) {
 		ShvNode *root = rootNode();
 		if(root) {
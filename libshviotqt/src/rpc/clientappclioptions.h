@@ -34,6 +34,7 @@ public:
 	CLIOPTION_GETTER_SETTER2(int, "rpc.defaultRpcTimeout", d, setD, efaultRpcTimeout)
 	CLIOPTION_GETTER_SETTER2(int, "rpc.reconnectInterval", r, setR, econnectInterval)
 	CLIOPTION_GETTER_SETTER2(int, "rpc.heartbeatInterval", h, setH, eartBeatInterval)
+	CLIOPTION_GETTER_SETTER2(std::string, "rpc.compression", c, setC, ompression)
 };
 
 } // namespace client
@@ -139,6 +139,13 @@ void ClientConnection::setCliOptions(const ClientAppCliOptions *cli_opts)
 	{
 		cp::RpcValue::Map opts;
 		opts[cp::Rpc::OPT_IDLE_WD_TIMEOUT] = 3 * heartBeatInterval();
+		cp::Rpc::CompressionType compression = cp::Rpc::compressionTypeFromString(cli_opts->compression());
+		if(compression != cp::Rpc::CompressionType::None) {
+			if(isCompressionSupported(compression))
+				opts[cp::Rpc::OPT_COMPRESSION] = cp::Rpc::compressionTypeToString(compression);
+			else
+				shvWarning() << "Compression:" << cli_opts->compression() << "is not supported by this build";
+		}
 		setConnectionOptions(opts);
 	}
 }
@@ -436,6 +443,12 @@ void ClientConnection::processInitPhase(const chainpack::RpcMessage &msg)
 		}
 		else if(m_connectionState.loginRequestId == id) {
 			m_connectionState.loginResult = resp.result();
+			cp::Rpc::CompressionType compression = cp::Rpc::compressionTypeFromString(loginResult().value(cp::Rpc::OPT_COMPRESSION).asString());
+			if(compression != cp::Rpc::CompressionType::None && isCompressionSupported(compression)) {
+				shvInfo() << "Frame compression enabled:" << cp::Rpc::compressionTypeToString(compression);
+				setSendCompression(compression);
+				setReceiveCompression(compression);
+			}
 			setState(State::BrokerConnected);
 			return;
 		}
@@ -163,9 +163,13 @@ void ServerConnection::setLoginResult(const chainpack::UserLoginResult &result)
 {
 	m_loginOk = result.passwordOk;
 	auto resp = cp::RpcResponse::forRequest(m_userLoginContext.loginRequest);
+	cp::UserLoginResult login_result = result;
 	if(result.passwordOk) {
 		shvInfo().nospace() << "Client logged in user: " << m_userLogin.user << " from: " << peerAddress() << ':' << peerPort();
-		resp.setResult(result.toRpcValue());
+		cp::Rpc::CompressionType compression = cp::Rpc::compressionTypeFromString(m_connectionOptions.toMap().value(cp::Rpc::OPT_COMPRESSION).asString());
+		if(isCompressionSupported(compression))
+			login_result.compression = compression;
+		resp.setResult(login_result.toRpcValue());
 	}
 	else {
 		shvWarning().nospace() << "Invalid authentication for user: " << m_userLogin.user
@@ -175,7 +179,11 @@ void ServerConnection::setLoginResult(const chainpack::UserLoginResult &result)
 																			 + " reason: " + result.loginError
 																			 + " at: " + connectionName()));
 	}
+	// client starts to compress its frames after login response is received
+	setReceiveCompression(login_result.compression);
 	sendMessage(resp);
+	// client accepts compressed frames after login response is processed, response still waiting in send queue is not compressed
+	setSendCompression(login_result.compression);
 }
 
 }}}
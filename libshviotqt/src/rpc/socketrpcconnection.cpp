@@ -118,7 +118,7 @@ void SocketRpcConnection::onReadyRead()
 		f->flush();
 	}
 #endif
-	onBytesRead(ba.toStdString());
+	onBytesRead(ba.constData(), static_cast<size_t>(ba.size()));
 }
 
 void SocketRpcConnection::onBytesWritten()
@@ -13,6 +13,8 @@ WebSocket::WebSocket(QWebSocket *socket, QObject *parent)
 	, m_socket(socket)
 {
 	m_socket->setParent(this);
+	// reserved capacity is kept by resize(0), write buffer is reused then for all the messages
+	m_writeBuffer.reserve(WRITE_BUFFER_RESERVED_SIZE);
 
 	connect(m_socket, &QWebSocket::connected, this, &Socket::connected);
 	connect(m_socket, &QWebSocket::disconnected, this, &Socket::disconnected);
@@ -68,27 +70,26 @@ quint16 WebSocket::peerPort() const
 
 QByteArray WebSocket::readAll()
 {
-	QByteArray ret = m_readBuffer;
-	m_readBuffer.clear();
+	QByteArray ret;
+	ret.swap(m_readBuffer);
 	return ret;
 }
 
 qint64 WebSocket::write(const char *data, qint64 data_size)
 {
-	QByteArray ba(data, static_cast<int>(data_size));
-	m_writeBuffer.append(ba);
+	m_writeBuffer.append(data, static_cast<int>(data_size));
 	return data_size;
 }
 
 void WebSocket::writeMessageBegin()
 {
 	shvDebug() << __FUNCTION__;
-	m_writeBuffer.clear();
+	m_writeBuffer.resize(0);
 }
 
 void WebSocket::writeMessageEnd()
 {
-	shvDebug() << __FUNCTION__ << "message len:" << m_writeBuffer.size() << "\n" << m_writeBuffer;
+	shvDebug() << __FUNCTION__ << "message len:" << m_writeBuffer.size();
 	qint64 n = m_socket->sendBinaryMessage(m_writeBuffer);
 	if(n < m_writeBuffer.size())
 		shvError() << "Send message error, only" << n << "bytes written.";
@@ -111,7 +112,9 @@ void WebSocket::onTextMessageReceived(const QString &message)
 
 void WebSocket::onBinaryMessageReceived(const QByteArray &message)
 {
-	shvDebug() << "binary message received:" << message;
+	shvDebug() << "binary message received:" << message.size() << "bytes";
+	// one websocket message contains one RPC frame, append() shares data of the message
+	// when the read buffer is empty, so the frame is passed to the RpcDriver without copying
 	m_readBuffer.append(message);
 	emit readyRead();
 }
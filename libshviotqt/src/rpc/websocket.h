@@ -33,6 +33,8 @@ private:
 	void onTextMessageReceived(const QString &message);
 	void onBinaryMessageReceived(const QByteArray &message);
 private:
+	static constexpr int WRITE_BUFFER_RESERVED_SIZE = 1024;
+
 	QWebSocket *m_socket = nullptr;
 	QByteArray m_readBuffer;
 	QByteArray m_writeBuffer;
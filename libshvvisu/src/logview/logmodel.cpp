@@ -1,6 +1,7 @@
 #include "logmodel.h"
 
 #include <shv/core/utils/shvfilejournal.h>
+#include <shv/core/utils/shvlogcolumns.h>
 #include <shv/core/log.h>
 
 namespace cp = shv::chainpack;
@@ -29,7 +30,8 @@ void LogModel::setTimeZone(const QTimeZone &tz)
 void LogModel::setLog(const shv::chainpack::RpcValue &log)
 {
 	beginResetModel();
-	m_log = log;
+	// model needs random access to records
+	m_log = shv::core::utils::ShvLogColumnsReader::toRowLog(log);
 	endResetModel();
 }
 
@@ -5,6 +5,7 @@
 #include <shv/iotqt/rpc/clientconnection.h>
 #include <shv/iotqt/node/shvnodetree.h>
 #include <shv/iotqt/node/localfsnode.h>
+#include <shv/iotqt/node/rpcmetricsnode.h>
 #include <shv/coreqt/log.h>
 #include <shv/chainpack/tunnelctl.h>
 #include <shv/chainpack/metamethod.h>
@@ -168,6 +169,7 @@ SampleShvClientApp::SampleShvClientApp(int &argc, char **argv, AppCliOptions* cl
 	m_shvTree = new si::node::ShvNodeTree(root, this);
 	connect(m_shvTree->root(), &si::node::ShvRootNode::sendRpcMessage, m_rpcConnection, &si::rpc::ClientConnection::sendMessage);
 	//m_shvTree->mkdir("sys/rproc");
+	new si::node::RpcMetricsNode(m_shvTree->mkdir(".app"));
 
 	QTimer::singleShot(0, m_rpcConnection, &si::rpc::ClientConnection::open);
 }
@@ -0,0 +1,23 @@
+#include "appclioptions.h"
+
+namespace cp = shv::chainpack;
+
+AppCliOptions::AppCliOptions()
+{
+	addOption("loadgen.devices").setType(cp::RpcValue::Type::Int).setNames("-n", "--devices").setComment("Number of simulated devices").setDefaultValue(10);
+	addOption("loadgen.subscribers").setType(cp::RpcValue::Type::Int).setNames("-m", "--subscribers").setComment("Number of simulated clients subscribed to all device signals").setDefaultValue(1);
+	addOption("loadgen.nodesPerDevice").setType(cp::RpcValue::Type::Int).setNames("--nodes").setComment("Number of value nodes of each device").setDefaultValue(10);
+	addOption("loadgen.mountPointPrefix").setType(cp::RpcValue::Type::String).setNames("--mount-point-prefix").setComment("Devices are mounted to prefix/devN").setDefaultValue("test/loadgen");
+	addOption("loadgen.signalRate").setType(cp::RpcValue::Type::Int).setNames("--signal-rate").setComment("Value change signals per second sent by each device").setDefaultValue(10);
+	addOption("loadgen.callRate").setType(cp::RpcValue::Type::Int).setNames("--call-rate").setComment("RPC calls per second sent by each subscriber").setDefaultValue(10);
+	addOption("loadgen.callMix").setType(cp::RpcValue::Type::String).setNames("--call-mix").setComment("Weights of called methods, for example get:8,ls:1,dir:1").setDefaultValue("get:8,ls:1,dir:1");
+	addOption("loadgen.warmup").setType(cp::RpcValue::Type::Int).setNames("--warmup").setComment("Warmup time [sec], messages are not measured in warmup").setDefaultValue(2);
+	addOption("loadgen.duration").setType(cp::RpcValue::Type::Int).setNames("-d", "--duration").setComment("Measurement time [sec]").setDefaultValue(10);
+	addOption("loadgen.connectTimeout").setType(cp::RpcValue::Type::Int).setNames("--connect-timeout").setComment("Time to connect all devices and subscribers [sec]").setDefaultValue(30);
+	addOption("loadgen.brokerExec").setType(cp::RpcValue::Type::String).setNames("--broker-exec").setComment("Start local broker command line before test, broker is terminated after test");
+	addOption("loadgen.brokerPid").setType(cp::RpcValue::Type::Int).setNames("--broker-pid").setComment("PID of already running local broker, used to report broker RSS");
+	addOption("loadgen.brokerStartupDelay").setType(cp::RpcValue::Type::Int).setNames("--broker-startup-delay").setComment("Time to wait for broker started by --broker-exec [msec]").setDefaultValue(1000);
+	addOption("loadgen.output").setType(cp::RpcValue::Type::String).setNames("-o", "--output").setComment("Write results to file as JSON");
+	setReconnectInterval(0);
+	setHeartBeatInterval(0);
+}
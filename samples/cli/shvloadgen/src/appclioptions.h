@@ -0,0 +1,27 @@
+#pragma once
+
+#include <shv/iotqt/rpc/clientappclioptions.h>
+
+class AppCliOptions : public shv::iotqt::rpc::ClientAppCliOptions
+{
+private:
+	using Super = shv::iotqt::rpc::ClientAppCliOptions;
+public:
+	AppCliOptions();
+
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.devices", d, setD, eviceCount)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.subscribers", s, setS, ubscriberCount)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.nodesPerDevice", n, setN, odesPerDevice)
+	CLIOPTION_GETTER_SETTER2(std::string, "loadgen.mountPointPrefix", m, setM, ountPointPrefix)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.signalRate", s, setS, ignalRate)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.callRate", c, setC, allRate)
+	CLIOPTION_GETTER_SETTER2(std::string, "loadgen.callMix", c, setC, allMix)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.warmup", w, setW, armup)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.duration", d, setD, uration)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.connectTimeout", c, setC, onnectTimeout)
+	CLIOPTION_GETTER_SETTER2(std::string, "loadgen.brokerExec", b, setB, rokerExec)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.brokerPid", b, setB, rokerPid)
+	CLIOPTION_GETTER_SETTER2(int, "loadgen.brokerStartupDelay", b, setB, rokerStartupDelay)
+	CLIOPTION_GETTER_SETTER2(std::string, "loadgen.output", o, setO, utput)
+};
+
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/// collects latency samples [usec] and computes percentiles
+class LatencyRecorder
+{
+public:
+	void record(int64_t usec) {m_samples.push_back(usec); m_sorted = false;}
+	void clear() {m_samples.clear(); m_sorted = true;}
+	size_t count() const {return m_samples.size();}
+
+	int64_t percentile(double p)
+	{
+		if(m_samples.empty())
+			return 0;
+		sort();
+		size_t ix = static_cast<size_t>(p / 100 * static_cast<double>(m_samples.size() - 1) + 0.5);
+		return m_samples[std::min(ix, m_samples.size() - 1)];
+	}
+	int64_t max()
+	{
+		if(m_samples.empty())
+			return 0;
+		sort();
+		return m_samples.back();
+	}
+	double mean() const
+	{
+		if(m_samples.empty())
+			return 0;
+		double sum = 0;
+		for(int64_t s : m_samples)
+			sum += static_cast<double>(s);
+		return sum / static_cast<double>(m_samples.size());
+	}
+private:
+	void sort()
+	{
+		if(!m_sorted) {
+			std::sort(m_samples.begin(), m_samples.end());
+			m_sorted = true;
+		}
+	}
+private:
+	std::vector<int64_t> m_samples;
+	bool m_sorted = true;
+};
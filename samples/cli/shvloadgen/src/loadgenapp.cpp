@@ -0,0 +1,501 @@
+#include "loadgenapp.h"
+#include "appclioptions.h"
+
+#include <shv/iotqt/rpc/clientconnection.h>
+#include <shv/iotqt/rpc/deviceconnection.h>
+#include <shv/coreqt/log.h>
+#include <shv/chainpack/rpcmessage.h>
+#include <shv/core/exception.h>
+#include <shv/core/string.h>
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTimer>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace cp = shv::chainpack;
+namespace si = shv::iotqt;
+
+namespace {
+const int TICK_INTERVAL_MSEC = 5;
+const int DRAIN_TIMEOUT_USEC = 3 * 1000 * 1000;
+const char KEY_TS[] = "ts";
+const char KEY_VALUE[] = "value";
+
+std::string node_name(int ix)
+{
+	return "node" + std::to_string(ix);
+}
+
+QJsonObject latency_to_json(LatencyRecorder &rec)
+{
+	QJsonObject ret;
+	ret["count"] = static_cast<qint64>(rec.count());
+	ret["meanUsec"] = rec.mean();
+	ret["p50Usec"] = static_cast<qint64>(rec.percentile(50));
+	ret["p99Usec"] = static_cast<qint64>(rec.percentile(99));
+	ret["p999Usec"] = static_cast<qint64>(rec.percentile(99.9));
+	ret["maxUsec"] = static_cast<qint64>(rec.max());
+	return ret;
+}
+}
+
+LoadGenApp::LoadGenApp(int &argc, char **argv, AppCliOptions* cli_opts)
+	: Super(argc, argv)
+	, m_cliOptions(cli_opts)
+{
+	std::vector<double> weights;
+	std::string err;
+	// call mix is validated in main() already
+	parseCallMix(cli_opts->callMix(), m_callMethods, weights, err);
+	if(m_callMethods.empty()) {
+		m_callMethods.push_back(cp::Rpc::METH_GET);
+		weights.push_back(1);
+	}
+	m_callMixDistribution = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+
+	m_tickTimer = new QTimer(this);
+	m_tickTimer->setTimerType(Qt::PreciseTimer);
+	m_tickTimer->setInterval(TICK_INTERVAL_MSEC);
+	connect(m_tickTimer, &QTimer::timeout, this, &LoadGenApp::onTick);
+
+	m_brokerPid = cli_opts->brokerPid();
+	if(cli_opts->brokerExec().empty())
+		QTimer::singleShot(0, this, &LoadGenApp::connectClients);
+	else
+		QTimer::singleShot(0, this, &LoadGenApp::startBroker);
+}
+
+LoadGenApp::~LoadGenApp()
+{
+	if(m_brokerProcess && m_brokerProcess->state() != QProcess::NotRunning) {
+		m_brokerProcess->terminate();
+		m_brokerProcess->waitForFinished(3000);
+	}
+}
+
+bool LoadGenApp::parseCallMix(const std::string &call_mix, std::vector<std::string> &methods, std::vector<double> &weights, std::string &err)
+{
+	methods.clear();
+	weights.clear();
+	for(const std::string &item : shv::core::String::split(call_mix, ',')) {
+		std::vector<std::string> method_weight = shv::core::String::split(item, ':');
+		if(method_weight.empty() || method_weight[0].empty())
+			continue;
+		double weight = 1;
+		if(method_weight.size() > 1) {
+			const char *str = method_weight[1].c_str();
+			char *end;
+			weight = std::strtod(str, &end);
+			if(end == str || *end != '\0' || !(weight >= 0)) {
+				err = "Invalid call mix weight: '" + item + "', non-negative number expected";
+				methods.clear();
+				weights.clear();
+				return false;
+			}
+		}
+		methods.push_back(method_weight[0]);
+		weights.push_back(weight);
+	}
+	double weight_sum = 0;
+	for(double w : weights)
+		weight_sum += w;
+	if(!weights.empty() && weight_sum <= 0) {
+		err = "Invalid call mix: '" + call_mix + "', at least one weight must be positive";
+		methods.clear();
+		weights.clear();
+		return false;
+	}
+	return true;
+}
+
+void LoadGenApp::startBroker()
+{
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+	QStringList args = QString::fromStdString(m_cliOptions->brokerExec()).split(' ', QString::SkipEmptyParts);
+#else
+	QStringList args = QString::fromStdString(m_cliOptions->brokerExec()).split(' ', Qt::SkipEmptyParts);
+#endif
+	QString program = args.takeFirst();
+	m_brokerProcess = new QProcess(this);
+	m_brokerProcess->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+	m_brokerProcess->setStandardOutputFile(QProcess::nullDevice());
+	shvInfo() << "Starting broker:" << m_cliOptions->brokerExec();
+	m_brokerProcess->start(program, args);
+	if(!m_brokerProcess->waitForStarted()) {
+		exitWithError("Cannot start broker: " + m_brokerProcess->errorString().toStdString());
+		return;
+	}
+	m_brokerPid = m_brokerProcess->processId();
+	connect(m_brokerProcess, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, [this](int exit_code, QProcess::ExitStatus) {
+		if(m_phase != Phase::Finished)
+			exitWithError("Broker exited unexpectedly, exit code: " + std::to_string(exit_code));
+	});
+	QTimer::singleShot(m_cliOptions->brokerStartupDelay(), this, &LoadGenApp::connectClients);
+}
+
+void LoadGenApp::connectClients()
+{
+	const int device_count = m_cliOptions->deviceCount();
+	const int subscriber_count = m_cliOptions->subscriberCount();
+	shvInfo() << "Connecting" << device_count << "devices and" << subscriber_count << "subscribers";
+	m_devices.resize(static_cast<size_t>(device_count));
+	m_subscribers.resize(static_cast<size_t>(subscriber_count));
+	for (size_t i = 0; i < m_devices.size(); ++i) {
+		auto *conn = new si::rpc::DeviceConnection(this);
+		conn->si::rpc::ClientConnection::setCliOptions(m_cliOptions);
+		cp::RpcValue::Map opts = conn->connectionOptions().toMap();
+		opts[cp::Rpc::KEY_DEVICE] = cp::RpcValue::Map {
+			{cp::Rpc::KEY_DEVICE_ID, "loadgen-" + std::to_string(i)},
+			{cp::Rpc::KEY_MOUT_POINT, m_cliOptions->mountPointPrefix() + "/dev" + std::to_string(i)},
+		};
+		conn->setConnectionOptions(opts);
+		connect(conn, &si::rpc::ClientConnection::brokerConnectedChanged, this, &LoadGenApp::checkAllConnected);
+		connect(conn, &si::rpc::ClientConnection::rpcMessageReceived, this, [this, i](const cp::RpcMessage &msg) {
+			onDeviceMessageReceived(m_devices[i], msg);
+		});
+		m_devices[i].connection = conn;
+		conn->open();
+	}
+	for (size_t i = 0; i < m_subscribers.size(); ++i) {
+		auto *conn = new si::rpc::ClientConnection(this);
+		conn->setCliOptions(m_cliOptions);
+		connect(conn, &si::rpc::ClientConnection::brokerConnectedChanged, this, [this, i](bool is_connected) {
+			if(is_connected)
+				subscribe(m_subscribers[i]);
+			else
+				checkAllConnected();
+		});
+		connect(conn, &si::rpc::ClientConnection::rpcMessageReceived, this, [this, i](const cp::RpcMessage &msg) {
+			onSubscriberMessageReceived(m_subscribers[i], msg);
+		});
+		m_subscribers[i].connection = conn;
+		conn->open();
+	}
+	QTimer::singleShot(m_cliOptions->connectTimeout() * 1000, this, [this]() {
+		if(m_phase == Phase::Connecting)
+			exitWithError("Timeout while connecting clients to broker");
+	});
+}
+
+void LoadGenApp::subscribe(Subscriber &subscriber)
+{
+	si::rpc::ClientConnection *conn = subscriber.connection;
+	int rq_id = conn->nextRequestId();
+	subscriber.pendingCalls[rq_id] = 0;
+	conn->callMethodSubscribe(rq_id, m_cliOptions->mountPointPrefix(), cp::Rpc::SIG_VAL_CHANGED);
+}
+
+void LoadGenApp::checkAllConnected()
+{
+	for(const SimDevice &device : m_devices) {
+		if(!device.connection->isBrokerConnected()) {
+			if(m_phase != Phase::Connecting && m_phase != Phase::Finished)
+				exitWithError("Device disconnected from broker");
+			return;
+		}
+	}
+	for(const Subscriber &subscriber : m_subscribers) {
+		if(!subscriber.connection->isBrokerConnected()) {
+			if(m_phase != Phase::Connecting && m_phase != Phase::Finished)
+				exitWithError("Subscriber disconnected from broker");
+			return;
+		}
+		if(!subscriber.subscribed)
+			return;
+	}
+	if(m_phase == Phase::Connecting)
+		setPhase(Phase::Warmup);
+}
+
+void LoadGenApp::onDeviceMessageReceived(SimDevice &device, const cp::RpcMessage &msg)
+{
+	if(!msg.isRequest())
+		return;
+	cp::RpcRequest rq(msg);
+	cp::RpcResponse resp = cp::RpcResponse::forRequest(rq);
+	try {
+		resp.setResult(processDeviceRequest(device, rq));
+	}
+	catch (std::exception &e) {
+		resp.setError(cp::RpcResponse::Error::create(cp::RpcResponse::Error::MethodCallException, e.what()));
+	}
+	device.connection->sendMessage(resp);
+}
+
+cp::RpcValue LoadGenApp::processDeviceRequest(SimDevice &device, const cp::RpcRequest &rq)
+{
+	const std::string path = rq.shvPath().asString();
+	const cp::RpcValue::String method = rq.method().asString();
+	if(method == cp::Rpc::METH_DIR) {
+		cp::RpcValue::List ret{cp::Rpc::METH_DIR, cp::Rpc::METH_LS};
+		if(!path.empty())
+			ret.push_back(cp::Rpc::METH_GET);
+		return ret;
+	}
+	if(method == cp::Rpc::METH_LS) {
+		cp::RpcValue::List ret;
+		if(path.empty()) {
+			for (int i = 0; i < m_cliOptions->nodesPerDevice(); ++i)
+				ret.push_back(node_name(i));
+		}
+		return ret;
+	}
+	if(method == cp::Rpc::METH_GET && !path.empty())
+		return device.value;
+	SHV_EXCEPTION("Invalid method: " + method + " on path: " + path);
+}
+
+void LoadGenApp::onSubscriberMessageReceived(Subscriber &subscriber, const cp::RpcMessage &msg)
+{
+	const int64_t now = nowUsec();
+	if(msg.isSignal()) {
+		cp::RpcSignal sig(msg);
+		int64_t ts = sig.params().toMap().value(KEY_TS).toInt64();
+		if(ts >= m_measureStartUsec && m_measureStartUsec > 0 && (m_measureEndUsec == 0 || ts < m_measureEndUsec)) {
+			m_counters.signalsReceived++;
+			m_signalLatency.record(now - ts);
+		}
+		return;
+	}
+	if(msg.isResponse()) {
+		cp::RpcResponse resp(msg);
+		int rq_id = resp.requestId().toInt();
+		auto it = subscriber.pendingCalls.find(rq_id);
+		if(it == subscriber.pendingCalls.end())
+			return;
+		int64_t ts = it->second;
+		subscriber.pendingCalls.erase(it);
+		if(ts == 0) {
+			// subscription request
+			if(resp.isError()) {
+				exitWithError("Subscribe error: " + resp.errorString());
+				return;
+			}
+			subscriber.subscribed = true;
+			checkAllConnected();
+			return;
+		}
+		if(ts >= m_measureStartUsec && m_measureStartUsec > 0 && (m_measureEndUsec == 0 || ts < m_measureEndUsec)) {
+			m_counters.responsesReceived++;
+			if(resp.isError())
+				m_counters.callErrors++;
+			m_callLatency.record(now - ts);
+		}
+	}
+}
+
+void LoadGenApp::setPhase(Phase phase)
+{
+	m_phase = phase;
+	switch (phase) {
+	case Phase::Connecting:
+		break;
+	case Phase::Warmup:
+		shvInfo() << "All clients connected, warmup for" << m_cliOptions->warmup() << "sec";
+		m_loadStartUsec = nowUsec();
+		for(SimDevice &device : m_devices)
+			device.signalsSent = 0;
+		for(Subscriber &subscriber : m_subscribers)
+			subscriber.callsSent = 0;
+		m_tickTimer->start();
+		QTimer::singleShot(m_cliOptions->warmup() * 1000, this, [this]() { setPhase(Phase::Measuring); });
+		break;
+	case Phase::Measuring:
+		shvInfo() << "Measuring for" << m_cliOptions->duration() << "sec";
+		m_counters = Counters();
+		m_signalLatency.clear();
+		m_callLatency.clear();
+		m_brokerRssStartKiB = brokerRssKiB();
+		m_measureStartUsec = nowUsec();
+		QTimer::singleShot(m_cliOptions->duration() * 1000, this, [this]() { setPhase(Phase::Draining); });
+		break;
+	case Phase::Draining:
+		m_measureEndUsec = nowUsec();
+		m_brokerRssEndKiB = brokerRssKiB();
+		shvInfo() << "Measurement finished, waiting for pending messages";
+		break;
+	case Phase::Finished:
+		m_tickTimer->stop();
+		break;
+	}
+}
+
+void LoadGenApp::onTick()
+{
+	const int64_t now = nowUsec();
+	if(m_phase == Phase::Draining) {
+		bool drained = m_counters.signalsReceived >= m_counters.signalsSent * static_cast<int64_t>(m_subscribers.size());
+		for(const Subscriber &subscriber : m_subscribers)
+			drained = drained && subscriber.pendingCalls.empty();
+		if(drained || now - m_measureEndUsec > DRAIN_TIMEOUT_USEC)
+			finish();
+		return;
+	}
+	const double elapsed_sec = static_cast<double>(now - m_loadStartUsec) / 1e6;
+	const int64_t signals_due = static_cast<int64_t>(elapsed_sec * m_cliOptions->signalRate());
+	for(SimDevice &device : m_devices) {
+		while(device.signalsSent < signals_due)
+			sendSignal(device);
+	}
+	const int64_t calls_due = static_cast<int64_t>(elapsed_sec * m_cliOptions->callRate());
+	for(Subscriber &subscriber : m_subscribers) {
+		while(subscriber.callsSent < calls_due)
+			sendCall(subscriber);
+	}
+}
+
+void LoadGenApp::sendSignal(SimDevice &device)
+{
+	device.signalsSent++;
+	device.value++;
+	cp::RpcSignal sig;
+	sig.setMethod(cp::Rpc::SIG_VAL_CHANGED);
+	sig.setShvPath(node_name(static_cast<int>(m_random() % static_cast<unsigned>(m_cliOptions->nodesPerDevice()))));
+	sig.setParams(cp::RpcValue::Map{
+					  {KEY_VALUE, device.value},
+					  {KEY_TS, nowUsec()},
+				  });
+	device.connection->sendMessage(sig);
+	if(m_phase == Phase::Measuring)
+		m_counters.signalsSent++;
+}
+
+void LoadGenApp::sendCall(Subscriber &subscriber)
+{
+	subscriber.callsSent++;
+	const std::string &method = m_callMethods[m_callMixDistribution(m_random)];
+	std::string path = m_cliOptions->mountPointPrefix() + "/dev" + std::to_string(m_random() % m_devices.size());
+	if(method != cp::Rpc::METH_LS)
+		path += '/' + node_name(static_cast<int>(m_random() % static_cast<unsigned>(m_cliOptions->nodesPerDevice())));
+	si::rpc::ClientConnection *conn = subscriber.connection;
+	int rq_id = conn->nextRequestId();
+	subscriber.pendingCalls[rq_id] = nowUsec();
+	conn->callShvMethod(rq_id, path, method);
+	if(m_phase == Phase::Measuring)
+		m_counters.callsSent++;
+}
+
+void LoadGenApp::finish()
+{
+	setPhase(Phase::Finished);
+	for(SimDevice &device : m_devices)
+		device.connection->close();
+	for(Subscriber &subscriber : m_subscribers)
+		subscriber.connection->close();
+	writeReport();
+	if(m_brokerProcess) {
+		m_brokerProcess->terminate();
+		m_brokerProcess->waitForFinished(3000);
+	}
+	quit();
+}
+
+void LoadGenApp::writeReport()
+{
+	const double duration_sec = static_cast<double>(m_measureEndUsec - m_measureStartUsec) / 1e6;
+	int64_t calls_timed_out = 0;
+	for(const Subscriber &subscriber : m_subscribers) {
+		for(const auto &kv : subscriber.pendingCalls) {
+			if(kv.second >= m_measureStartUsec && kv.second < m_measureEndUsec)
+				calls_timed_out++;
+		}
+	}
+	const int64_t signals_expected = m_counters.signalsSent * static_cast<int64_t>(m_subscribers.size());
+	const int64_t messages_received = m_counters.signalsReceived + m_counters.responsesReceived;
+
+	QJsonObject config;
+	config["devices"] = static_cast<int>(m_devices.size());
+	config["subscribers"] = static_cast<int>(m_subscribers.size());
+	config["nodesPerDevice"] = m_cliOptions->nodesPerDevice();
+	config["signalRate"] = m_cliOptions->signalRate();
+	config["callRate"] = m_cliOptions->callRate();
+	config["callMix"] = QString::fromStdString(m_cliOptions->callMix());
+	config["scheme"] = QString::fromStdString(m_cliOptions->serverScheme());
+	config["protocolType"] = QString::fromStdString(m_cliOptions->protocolType());
+
+	QJsonObject signals_obj;
+	signals_obj["sent"] = static_cast<qint64>(m_counters.signalsSent);
+	signals_obj["expected"] = static_cast<qint64>(signals_expected);
+	signals_obj["received"] = static_cast<qint64>(m_counters.signalsReceived);
+	signals_obj["lost"] = static_cast<qint64>(signals_expected - m_counters.signalsReceived);
+	signals_obj["latency"] = latency_to_json(m_signalLatency);
+
+	QJsonObject calls_obj;
+	calls_obj["sent"] = static_cast<qint64>(m_counters.callsSent);
+	calls_obj["received"] = static_cast<qint64>(m_counters.responsesReceived);
+	calls_obj["errors"] = static_cast<qint64>(m_counters.callErrors);
+	calls_obj["timedOut"] = static_cast<qint64>(calls_timed_out);
+	calls_obj["latency"] = latency_to_json(m_callLatency);
+
+	QJsonObject result;
+	result["config"] = config;
+	result["durationSec"] = duration_sec;
+	result["messagesPerSec"] = duration_sec > 0? static_cast<double>(messages_received) / duration_sec: 0.;
+	result["signals"] = signals_obj;
+	result["calls"] = calls_obj;
+	if(m_brokerPid > 0) {
+		QJsonObject broker;
+		broker["pid"] = static_cast<qint64>(m_brokerPid);
+		broker["rssStartKiB"] = static_cast<qint64>(m_brokerRssStartKiB);
+		broker["rssEndKiB"] = static_cast<qint64>(m_brokerRssEndKiB);
+		result["broker"] = broker;
+	}
+
+	std::cout << "duration: " << duration_sec << " sec, messages/s: " << result["messagesPerSec"].toDouble() << "\n";
+	std::cout << "signals sent: " << m_counters.signalsSent << " received: " << m_counters.signalsReceived << " of: " << signals_expected
+			  << " latency p50: " << m_signalLatency.percentile(50) << " p99: " << m_signalLatency.percentile(99)
+			  << " p999: " << m_signalLatency.percentile(99.9) << " max: " << m_signalLatency.max() << " usec\n";
+	std::cout << "calls sent: " << m_counters.callsSent << " received: " << m_counters.responsesReceived << " errors: " << m_counters.callErrors
+			  << " latency p50: " << m_callLatency.percentile(50) << " p99: " << m_callLatency.percentile(99)
+			  << " p999: " << m_callLatency.percentile(99.9) << " max: " << m_callLatency.max() << " usec\n";
+	if(m_brokerPid > 0)
+		std::cout << "broker RSS start: " << m_brokerRssStartKiB << " end: " << m_brokerRssEndKiB << " KiB\n";
+
+	const std::string fn = m_cliOptions->output();
+	if(!fn.empty()) {
+		QFile f(QString::fromStdString(fn));
+		if(f.open(QFile::WriteOnly | QFile::Truncate))
+			f.write(QJsonDocument(result).toJson());
+		else
+			shvError() << "Cannot open file:" << fn << "for writing";
+	}
+}
+
+void LoadGenApp::exitWithError(const std::string &err)
+{
+	shvError() << err;
+	setPhase(Phase::Finished);
+	if(m_brokerProcess) {
+		m_brokerProcess->disconnect(this);
+		m_brokerProcess->terminate();
+		m_brokerProcess->waitForFinished(3000);
+	}
+	exit(EXIT_FAILURE);
+}
+
+int64_t LoadGenApp::nowUsec() const
+{
+	using namespace std::chrono;
+	return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t LoadGenApp::brokerRssKiB() const
+{
+	if(m_brokerPid <= 0)
+		return 0;
+	// VmRSS is available on Linux only
+	std::ifstream is("/proc/" + std::to_string(m_brokerPid) + "/status");
+	std::string line;
+	while(std::getline(is, line)) {
+		if(shv::core::String::startsWith(line, "VmRSS:"))
+			return std::stoll(line.substr(6));
+	}
+	return 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "latencyrecorder.h"
+
+#include <shv/chainpack/rpcvalue.h>
+
+#include <QCoreApplication>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class AppCliOptions;
+class QProcess;
+class QTimer;
+
+namespace shv { namespace chainpack { class RpcMessage; class RpcRequest; }}
+namespace shv { namespace iotqt { namespace rpc { class ClientConnection; class DeviceConnection; }}}
+
+class LoadGenApp : public QCoreApplication
+{
+	Q_OBJECT
+private:
+	using Super = QCoreApplication;
+public:
+	LoadGenApp(int &argc, char **argv, AppCliOptions* cli_opts);
+	~LoadGenApp() Q_DECL_OVERRIDE;
+
+	/// parse --call-mix value like get:8,ls:1, method without weight has weight 1
+	/// @return false and error message if some weight is not a non-negative number
+	static bool parseCallMix(const std::string &call_mix, std::vector<std::string> &methods, std::vector<double> &weights, std::string &err);
+private:
+	enum class Phase {Connecting, Warmup, Measuring, Draining, Finished};
+
+	struct SimDevice
+	{
+		shv::iotqt::rpc::DeviceConnection *connection = nullptr;
+		int64_t signalsSent = 0;
+		int value = 0;
+	};
+	struct Subscriber
+	{
+		shv::iotqt::rpc::ClientConnection *connection = nullptr;
+		bool subscribed = false;
+		int64_t callsSent = 0;
+		/// request ID -> send time [usec]
+		std::unordered_map<int, int64_t> pendingCalls;
+	};
+	struct Counters
+	{
+		int64_t signalsSent = 0;
+		int64_t signalsReceived = 0;
+		int64_t callsSent = 0;
+		int64_t responsesReceived = 0;
+		int64_t callErrors = 0;
+	};
+
+	void startBroker();
+	void connectClients();
+	void checkAllConnected();
+	void subscribe(Subscriber &subscriber);
+
+	void onDeviceMessageReceived(SimDevice &device, const shv::chainpack::RpcMessage &msg);
+	void onSubscriberMessageReceived(Subscriber &subscriber, const shv::chainpack::RpcMessage &msg);
+	shv::chainpack::RpcValue processDeviceRequest(SimDevice &device, const shv::chainpack::RpcRequest &rq);
+
+	void setPhase(Phase phase);
+	void onTick();
+	void sendSignal(SimDevice &device);
+	void sendCall(Subscriber &subscriber);
+	void finish();
+	void writeReport();
+	void exitWithError(const std::string &err);
+
+	int64_t nowUsec() const;
+	int64_t brokerRssKiB() const;
+private:
+	AppCliOptions *m_cliOptions;
+	std::vector<SimDevice> m_devices;
+	std::vector<Subscriber> m_subscribers;
+	std::vector<std::string> m_callMethods;
+	std::discrete_distribution<size_t> m_callMixDistribution;
+	std::mt19937 m_random;
+
+	QProcess *m_brokerProcess = nullptr;
+	int64_t m_brokerPid = 0;
+	int64_t m_brokerRssStartKiB = 0;
+	int64_t m_brokerRssEndKiB = 0;
+
+	QTimer *m_tickTimer = nullptr;
+	Phase m_phase = Phase::Connecting;
+	int64_t m_loadStartUsec = 0;
+	int64_t m_measureStartUsec = 0;
+	int64_t m_measureEndUsec = 0;
+
+	Counters m_counters;
+	LatencyRecorder m_signalLatency;
+	LatencyRecorder m_callLatency;
+};
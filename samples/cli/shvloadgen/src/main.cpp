@@ -0,0 +1,63 @@
+#include "loadgenapp.h"
+#include "appclioptions.h"
+
+#include <shv/chainpack/rpcmessage.h>
+
+#include <shv/coreqt/log.h>
+
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication::setOrganizationName("Elektroline");
+	QCoreApplication::setOrganizationDomain("elektroline.cz");
+	QCoreApplication::setApplicationName("shvloadgen");
+	QCoreApplication::setApplicationVersion("0.0.1");
+
+	std::vector<std::string> shv_args = NecroLog::setCLIOptions(argc, argv);
+
+	AppCliOptions cli_opts;
+	cli_opts.parse(shv_args);
+	if(cli_opts.isParseError()) {
+		for(const std::string &err : cli_opts.parseErrors())
+			shvError() << err;
+		return EXIT_FAILURE;
+	}
+	if(cli_opts.isAppBreak()) {
+		if(cli_opts.isHelp()) {
+			cli_opts.printHelp(std::cout);
+		}
+		return EXIT_SUCCESS;
+	}
+	for(const std::string &s : cli_opts.unusedArguments()) {
+		shvWarning() << "Undefined argument:" << s;
+	}
+
+	if(!cli_opts.loadConfigFile()) {
+		return EXIT_FAILURE;
+	}
+	if(cli_opts.deviceCount() <= 0 || cli_opts.nodesPerDevice() <= 0) {
+		shvError() << "At least one device with one node must be simulated";
+		return EXIT_FAILURE;
+	}
+	{
+		std::vector<std::string> methods;
+		std::vector<double> weights;
+		std::string err;
+		if(!LoadGenApp::parseCallMix(cli_opts.callMix(), methods, weights, err)) {
+			shvError() << err;
+			return EXIT_FAILURE;
+		}
+	}
+
+	shv::chainpack::RpcMessage::registerMetaTypes();
+
+	shvInfo() << "Starting SHV broker load generator, PID:" << QCoreApplication::applicationPid();
+
+	LoadGenApp a(argc, argv, &cli_opts);
+
+	int ret = a.exec();
+	shvInfo() << "main event loop exit code:" << ret;
+
+	return ret;
+}
@@ -0,0 +1,10 @@
+
+HEADERS += \
+    $$PWD/appclioptions.h \
+    $$PWD/latencyrecorder.h \
+    $$PWD/loadgenapp.h
+
+SOURCES += \
+    $$PWD/main.cpp\
+    $$PWD/appclioptions.cpp \
+    $$PWD/loadgenapp.cpp
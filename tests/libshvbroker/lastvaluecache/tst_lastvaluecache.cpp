@@ -0,0 +1,107 @@
+#include <shv/broker/lastvaluecache.h>
+
+#include <shv/chainpack/rpcmessage.h>
+
+#include <QtTest/QtTest>
+#include <QDebug>
+
+#include <string>
+#include <vector>
+
+using namespace shv::chainpack;
+using shv::broker::LastValueCache;
+
+class TestLastValueCache: public QObject
+{
+	Q_OBJECT
+private:
+	/// store signal the same way as broker does, meta data + packed message data
+	static void update(LastValueCache &cache, const std::string &shv_path, const RpcValue &value)
+	{
+		RpcSignal sig;
+		sig.setShvPath(shv_path);
+		sig.setMethod(Rpc::SIG_VAL_CHANGED);
+		sig.setParams(value);
+		RpcValue::MetaData meta_data(sig.value().metaData());
+		RpcMessage::setProtocolType(meta_data, Rpc::ProtocolType::ChainPack);
+		cache.update(shv_path, meta_data, sig.value().metaStripped().toChainPack());
+	}
+	static std::vector<std::string> treePaths(const LastValueCache &cache, const std::string &shv_path)
+	{
+		std::vector<std::string> ret;
+		cache.forEachInTree(shv_path, [&ret](const std::string &path, const LastValueCache::Entry &entry) {
+			QCOMPARE(RpcMessage::shvPath(entry.metaData).asString(), path);
+			ret.push_back(path);
+		});
+		return ret;
+	}
+
+	void testLastValueCache()
+	{
+		qDebug() << "============= LastValueCache test ============\n";
+		LastValueCache cache(5);
+		update(cache, "a/b", 1);
+		update(cache, "a/b/c", 2);
+		update(cache, "a/b/c/d", 3);
+		update(cache, "a/b-c", 4);
+		update(cache, "x", 5);
+		// existing path is updated, even if cache is full
+		update(cache, "a/b", 10);
+		QCOMPARE(cache.size(), static_cast<size_t>(5));
+		QCOMPARE(cache.values("a/b").value("a/b").toInt(), 10);
+		{
+			qDebug() << "------------- size cap";
+			update(cache, "y", 6);
+			QCOMPARE(cache.size(), cache.maxSize());
+			QVERIFY(!cache.values("").hasKey("y"));
+		}
+		{
+			qDebug() << "------------- forEachInTree";
+			QVERIFY(treePaths(cache, "a/b") == (std::vector<std::string>{"a/b", "a/b/c", "a/b/c/d"}));
+			QVERIFY(treePaths(cache, "a/b/c") == (std::vector<std::string>{"a/b/c", "a/b/c/d"}));
+			QVERIFY(treePaths(cache, "a/b-") == (std::vector<std::string>{}));
+			QCOMPARE(treePaths(cache, "").size(), cache.size());
+		}
+		{
+			qDebug() << "------------- values";
+			const RpcValue::Map all = cache.values("");
+			QCOMPARE(all.size(), cache.size());
+			QCOMPARE(all.value("a/b-c").toInt(), 4);
+			QCOMPARE(all.value("x").toInt(), 5);
+			QVERIFY(cache.values("**") == all);
+			QVERIFY(cache.values("a/*").keys() == (std::vector<std::string>{"a/b", "a/b-c"}));
+			// trailing ** matches zero dirs too
+			QVERIFY(cache.values("a/b/**").keys() == (std::vector<std::string>{"a/b", "a/b/c", "a/b/c/d"}));
+			QVERIFY(cache.values("*/b/*").keys() == (std::vector<std::string>{"a/b/c"}));
+			QVERIFY(cache.values("**/d").keys() == (std::vector<std::string>{"a/b/c/d"}));
+			QVERIFY(cache.values("a/c").empty());
+		}
+		{
+			qDebug() << "------------- removeTree";
+			cache.removeTree("a/b");
+			QVERIFY(cache.values("").keys() == (std::vector<std::string>{"a/b-c", "x"}));
+			// free space can be used by new paths again
+			update(cache, "y", 6);
+			QCOMPARE(cache.values("y").value("y").toInt(), 6);
+			cache.removeTree("");
+			QCOMPARE(cache.size(), static_cast<size_t>(0));
+		}
+	}
+private slots:
+	void initTestCase()
+	{
+		//qDebug("called before everything else");
+	}
+	void tests()
+	{
+		testLastValueCache();
+	}
+
+	void cleanupTestCase()
+	{
+		//qDebug("called after firstTest and secondTest");
+	}
+};
+
+QTEST_MAIN(TestLastValueCache)
+#include "tst_lastvaluecache.moc"
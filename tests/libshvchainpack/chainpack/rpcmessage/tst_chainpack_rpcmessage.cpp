@@ -1,6 +1,7 @@
 #include <shv/chainpack/chainpackreader.h>
 #include <shv/chainpack/chainpackwriter.h>
 #include <shv/chainpack/rpcmessage.h>
+#include <shv/chainpack/rpcdriver.h>
 //#include <shv/chainpack/chainpackprotocol.h>
 
 #include <cassert>
@@ -56,6 +57,46 @@ std::string binary_dump(const RpcValue::String &out)
 	return ret;
 }
 
+/// driver writing frames directly to the peer driver
+class LoopbackRpcDriver : public RpcDriver
+{
+public:
+	LoopbackRpcDriver *peer = nullptr;
+	std::vector<RpcValue> receivedMessages;
+	size_t bytesWritten = 0;
+	int readDataExceptionCount = 0;
+	/// device does not accept any data, like socket with full buffer
+	bool writeBlocked = false;
+
+	LoopbackRpcDriver()
+	{
+		setProtocolType(Rpc::ProtocolType::ChainPack);
+		setMessageReceivedCallback([this](const RpcValue &msg) { receivedMessages.push_back(msg); });
+	}
+	void unblockWrite()
+	{
+		writeBlocked = false;
+		enqueueDataToSend(MessageData());
+	}
+protected:
+	bool isOpen() override {return true;}
+	void writeMessageBegin() override {}
+	void writeMessageEnd() override {}
+	int64_t writeBytes(const char *bytes, size_t length) override
+	{
+		if(writeBlocked)
+			return 0;
+		bytesWritten += length;
+		peer->onBytesRead(bytes, length);
+		return static_cast<int64_t>(length);
+	}
+	void onProcessReadDataException(std::exception &e) override
+	{
+		qDebug() << "read data exception:" << e.what();
+		readDataExceptionCount++;
+	}
+};
+
 }
 
 class TestRpcMessage: public QObject
@@ -145,6 +186,140 @@ private:
 		QCOMPARE(rq2.params(), rq.params());
 	}
 }
+	void frameCompressionTest()
+	{
+		if(!RpcDriver::isCompressionSupported(Rpc::CompressionType::Deflate))
+			QSKIP("frame compression is not supported by this build");
+		QCOMPARE(Rpc::compressionTypeFromString(Rpc::compressionTypeToString(Rpc::CompressionType::Deflate)), Rpc::CompressionType::Deflate);
+		LoopbackRpcDriver a;
+		LoopbackRpcDriver b;
+		a.peer = &b;
+		b.peer = &a;
+		a.setSendCompression(Rpc::CompressionType::Deflate);
+		b.setReceiveCompression(Rpc::CompressionType::Deflate);
+		std::vector<RpcValue> sent;
+		for (int i = 0; i < 50; ++i) {
+			RpcValue::List values;
+			for (int j = 0; j < 20; ++j)
+				values.push_back("shv/device/" + std::to_string(j) + "/status");
+			RpcSignal sig;
+			sig.setShvPath("shv/device/" + std::to_string(i % 3) + "/status");
+			sig.setMethod(Rpc::SIG_VAL_CHANGED);
+			// small frames are sent uncompressed
+			sig.setParams(i % 2? RpcValue(values): RpcValue(i));
+			sent.push_back(sig.value());
+			a.sendRpcValue(sig.value());
+			b.sendRpcValue(sig.value());
+		}
+		QCOMPARE(b.receivedMessages.size(), sent.size());
+		QCOMPARE(a.receivedMessages.size(), sent.size());
+		for (size_t i = 0; i < sent.size(); ++i) {
+			QVERIFY(b.receivedMessages[i] == sent[i]);
+			QVERIFY(b.receivedMessages[i].metaData() == sent[i].metaData());
+		}
+		const RpcDriver::CompressionStats &stats = a.sentCompressionStats();
+		qDebug() << "compressed frames:" << stats.frameCount << "ratio:" << stats.ratio() << "bytes written:" << a.bytesWritten << "uncompressed:" << b.bytesWritten;
+		QCOMPARE(stats.frameCount, static_cast<uint64_t>(sent.size() / 2));
+		QCOMPARE(b.receivedCompressionStats().compressedBytes, stats.compressedBytes);
+		QVERIFY(stats.ratio() > 2);
+		QVERIFY(a.bytesWritten < b.bytesWritten);
+		QCOMPARE(b.sentCompressionStats().frameCount, static_cast<uint64_t>(0));
+		QCOMPARE(a.readDataExceptionCount + b.readDataExceptionCount, 0);
+	}
+	void rejectedCompressedFrameTest()
+	{
+		if(!RpcDriver::isCompressionSupported(Rpc::CompressionType::Deflate))
+			QSKIP("frame compression is not supported by this build");
+		auto make_signal = [](const RpcValue &params) {
+			RpcSignal sig;
+			sig.setShvPath("shv/device/status");
+			sig.setMethod(Rpc::SIG_VAL_CHANGED);
+			sig.setParams(params);
+			return sig.value();
+		};
+		{
+			// compressed frame before compression is negotiated
+			LoopbackRpcDriver a;
+			LoopbackRpcDriver b;
+			a.peer = &b;
+			a.setSendCompression(Rpc::CompressionType::Deflate);
+			a.sendRpcValue(make_signal(std::string(1000, 'x')));
+			QCOMPARE(b.readDataExceptionCount, 1);
+			QVERIFY(b.receivedMessages.empty());
+			QCOMPARE(b.receivedCompressionStats().frameCount, static_cast<uint64_t>(0));
+			// rejected frame is dropped from read buffer
+			a.setSendCompression(Rpc::CompressionType::None);
+			a.sendRpcValue(make_signal(42));
+			QCOMPARE(b.receivedMessages.size(), static_cast<size_t>(1));
+			QVERIFY(b.receivedMessages[0] == make_signal(42));
+		}
+		{
+			// login response still queued when compression is enabled must be sent uncompressed
+			LoopbackRpcDriver a;
+			LoopbackRpcDriver b;
+			a.peer = &b;
+			a.writeBlocked = true;
+			a.sendRpcValue(make_signal(std::string(1000, 'x')));
+			a.setSendCompression(Rpc::CompressionType::Deflate);
+			a.unblockWrite();
+			QCOMPARE(b.readDataExceptionCount, 0);
+			QCOMPARE(b.receivedMessages.size(), static_cast<size_t>(1));
+			QCOMPARE(a.sentCompressionStats().frameCount, static_cast<uint64_t>(0));
+			b.setReceiveCompression(Rpc::CompressionType::Deflate);
+			a.sendRpcValue(make_signal(std::string(1000, 'y')));
+			QCOMPARE(b.readDataExceptionCount, 0);
+			QCOMPARE(b.receivedMessages.size(), static_cast<size_t>(2));
+			QCOMPARE(a.sentCompressionStats().frameCount, static_cast<uint64_t>(1));
+		}
+		{
+			// frame inflating over limit
+			LoopbackRpcDriver a;
+			LoopbackRpcDriver b;
+			a.peer = &b;
+			a.setSendCompression(Rpc::CompressionType::Deflate);
+			b.setReceiveCompression(Rpc::CompressionType::Deflate);
+			b.setMaxDecompressedFrameLength(64 * 1024);
+			a.sendRpcValue(make_signal(std::string(60 * 1024, 'x')));
+			QCOMPARE(b.receivedMessages.size(), static_cast<size_t>(1));
+			a.sendRpcValue(make_signal(std::string(1024 * 1024, 'x')));
+			QVERIFY(a.sentCompressionStats().compressedBytes < 10 * 1024);
+			QCOMPARE(b.readDataExceptionCount, 1);
+			QCOMPARE(b.receivedMessages.size(), static_cast<size_t>(1));
+		}
+	}
+	void messageArenaTest()
+	{
+		LoopbackRpcDriver heap_sender;
+		LoopbackRpcDriver heap_receiver;
+		heap_sender.peer = &heap_receiver;
+		LoopbackRpcDriver arena_sender;
+		LoopbackRpcDriver arena_receiver;
+		arena_sender.peer = &arena_receiver;
+		arena_receiver.setMessageArenaEnabled(true);
+		QVERIFY(arena_receiver.isMessageArenaEnabled());
+		for (int i = 0; i < 20; ++i) {
+			RpcRequest rq;
+			rq.setRequestId(i + 1);
+			rq.setShvPath("shv/device/" + std::to_string(i));
+			rq.setMethod("set");
+			rq.setParams(RpcValue::Map{
+							 {"list", RpcValue::List{i, 2.5, "foo", RpcValue::Blob{'a', 'b'}}},
+							 {"imap", RpcValue::IMap{{1, true}, {2, nullptr}}},
+							 {"str", std::string(static_cast<size_t>(i) * 100, 'x')},
+						 });
+			heap_sender.sendRpcValue(rq.value());
+			arena_sender.sendRpcValue(rq.value());
+		}
+		QCOMPARE(arena_receiver.receivedMessages.size(), heap_receiver.receivedMessages.size());
+		QCOMPARE(arena_receiver.receivedMessages.size(), static_cast<size_t>(20));
+		for (size_t i = 0; i < heap_receiver.receivedMessages.size(); ++i) {
+			const RpcValue &heap_msg = heap_receiver.receivedMessages[i];
+			const RpcValue &arena_msg = arena_receiver.receivedMessages[i];
+			QVERIFY(arena_msg == heap_msg);
+			QVERIFY(arena_msg.metaData() == heap_msg.metaData());
+			QCOMPARE(arena_msg.toChainPack(), heap_msg.toChainPack());
+		}
+	}
 private slots:
 	void initTestCase()
 	{
@@ -154,6 +329,18 @@ private slots:
 	{
 		rpcmessageTest();
 	}
+	void frameCompression()
+	{
+		frameCompressionTest();
+	}
+	void rejectedCompressedFrame()
+	{
+		rejectedCompressedFrameTest();
+	}
+	void messageArena()
+	{
+		messageArenaTest();
+	}
 
 	void cleanupTestCase()
 	{
@@ -3,6 +3,8 @@
 #include <shv/chainpack/chainpackwriter.h>
 #include <shv/chainpack/chainpackreader.h>
 #include <shv/chainpack/cponreader.h>
+#include <shv/chainpack/pullreader.h>
+#include <shv/chainpack/rpcvaluearena.h>
 
 #include <QtTest/QtTest>
 #include <QDebug>
@@ -19,6 +21,10 @@
 #include <unordered_map>
 #include <algorithm>
 #include <type_traits>
+#include <random>
+#include <cfloat>
+#include <cmath>
+#include <thread>
 
 #ifdef __linux
 
@@ -913,6 +919,27 @@ private:
 			QVERIFY(cp1.type() == cp2.type());
 			QVERIFY(cp1.metaData() == cp2.metaData());
 		}
+		for(ChainPack::PackingSchema::Enum schema : {ChainPack::PackingSchema::String, ChainPack::PackingSchema::Blob}) {
+			qDebug() << "------------- Truncated" << ChainPack::PackingSchema::name(schema);
+			// huge length in header must not be preallocated
+			std::stringstream out;
+			{
+				ChainPackWriter wr(out);
+				out.put(static_cast<char>(schema));
+				wr.writeUIntData(uint64_t{1} << 50);
+			}
+			// more data than one unpack chunk, the first chunk is returned before EOF is found
+			out << std::string(4096, 'x');
+			ChainPackReader rd(out);
+			bool parse_error = false;
+			try {
+				rd.read();
+			}
+			catch (const ChainPackReader::ParseException &) {
+				parse_error = true;
+			}
+			QVERIFY(parse_error);
+		}
 #ifdef __linux
 		{
 			qDebug() << "------------- Memory usage";
@@ -1072,6 +1099,220 @@ private slots:
 		QVERIFY(rv3.metaData().isEmpty() == true);
 		QVERIFY(rv3.at("18") == rpcval.at("18"));
 	}
+	void flatMapTest()
+	{
+		qDebug() << "================================= FlatMap Test =====================================";
+		// first occurrence of duplicate key wins like in std::map
+		RpcValue::Map map{{"c", 3}, {"a", 1}, {"b", 2}, {"a", 4}};
+		QCOMPARE(map.size(), static_cast<size_t>(3));
+		QVERIFY(map.keys() == (std::vector<std::string>{"a", "b", "c"}));
+		QVERIFY(map.value("a") == RpcValue(1));
+		QVERIFY(map.value("x", 42) == RpcValue(42));
+		QVERIFY(map.insert({"b", 5}).second == false);
+		QVERIFY(map.emplace("d", 4).second == true);
+		map["0"] = 0;
+		QCOMPARE(map.begin()->first, std::string("0"));
+		map.setValue("c", RpcValue());
+		QVERIFY(!map.hasKey("c"));
+		QCOMPARE(map.erase("x"), static_cast<size_t>(0));
+		QCOMPARE(RpcValue(map).toCpon(), std::string(R"({"0":0,"a":1,"b":2,"d":4})"));
+
+		RpcValue::IMap imap;
+		for(int key : {5, -1, 3, 10, 3, 7, 0, 2, 8, 9, 1, 4})
+			imap[key] = key;
+		QCOMPARE(imap.size(), static_cast<size_t>(11));
+		QVERIFY(imap.keys() == (std::vector<RpcValue::Int>{-1, 0, 1, 2, 3, 4, 5, 7, 8, 9, 10}));
+		for(const auto &kv : imap)
+			QCOMPARE(kv.second.toInt(), kv.first);
+		QVERIFY(!imap.hasKey(6));
+		QVERIFY(imap == RpcValue::fromChainPack(RpcValue(imap).toChainPack()).asIMap());
+	}
+
+
+	void arenaTest()
+	{
+		qDebug() << "================================= Arena Test =====================================";
+		const std::string cpon = R"(<1:2,8:"foo">{"list":[1,2.5,"abc",[true,null]],"imap":i{1:"a",2:b"blob"}})";
+		const RpcValue heap_val = RpcValue::fromCpon(cpon);
+		RpcValue val1;
+		RpcValue val2;
+		{
+			RpcValueArena outer(256);
+			RpcValueArena::Scope outer_scope(outer);
+			QVERIFY(RpcValueArena::current() == &outer);
+			{
+				RpcValueArena inner(256);
+				RpcValueArena::Scope inner_scope(inner);
+				QVERIFY(RpcValueArena::current() == &inner);
+				val2 = RpcValue::fromCpon(cpon);
+				QVERIFY(inner.allocatedBytes() > 0);
+				// inner arena is destroyed here, val2 keeps its memory alive
+			}
+			QVERIFY(RpcValueArena::current() == &outer);
+			QCOMPARE(outer.allocatedBytes(), static_cast<size_t>(0));
+			val1 = RpcValue::fromCpon(cpon);
+			QVERIFY(outer.allocatedBytes() > 0);
+			// more chunks are allocated when the first one is full
+			std::vector<RpcValue> values;
+			for (int i = 0; i < 100; ++i)
+				values.push_back(RpcValue::fromCpon(cpon));
+			QVERIFY(outer.chunkCount() > 1);
+		}
+		QVERIFY(RpcValueArena::current() == nullptr);
+		// values outlive the arena
+		QVERIFY(val1 == heap_val);
+		QVERIFY(val2 == heap_val);
+		QCOMPARE(val1.toCpon(), heap_val.toCpon());
+		val2.set("list", "modified");
+		QVERIFY(val1 == heap_val);
+
+		// values released from other threads while and after the owning thread destroys the arena
+		for (int i = 0; i < 100; ++i) {
+			std::vector<RpcValue> values;
+			std::unique_ptr<RpcValueArena> arena(new RpcValueArena(256));
+			{
+				RpcValueArena::Scope scope(*arena);
+				for (int j = 0; j < 20; ++j)
+					values.push_back(RpcValue::fromCpon(cpon));
+			}
+			std::vector<RpcValue> values2(values.begin() + 10, values.end());
+			values.resize(10);
+			std::thread t1([&values]() {
+				for(auto &v : values) {
+					QVERIFY(v == RpcValue::fromCpon(v.toCpon()));
+					v = RpcValue();
+				}
+			});
+			std::thread t2([&values2]() {
+				for(auto &v : values2)
+					v = RpcValue();
+			});
+			arena.reset();
+			t1.join();
+			t2.join();
+		}
+	}
+
+	void doubleRoundTripTest()
+	{
+		qDebug() << "================================= Double round trip Test =====================================";
+		QCOMPARE(RpcValue(100.25).toCpon(), std::string("100.25"));
+		QCOMPARE(RpcValue(0.1 + 0.2).toCpon(), std::string("0.30000000000000004"));
+		QCOMPARE(RpcValue(-1.5e-7).toCpon(), std::string("-1.5e-7"));
+		std::mt19937_64 gen(1);
+		std::uniform_real_distribution<double> dist(-1e6, 1e6);
+		for (int i = 0; i < 100000; ++i) {
+			double d = (i % 2)? dist(gen): std::ldexp(dist(gen), static_cast<int>(gen() % 2000) - 1000);
+			const std::string cpon = RpcValue(d).toCpon();
+			const double d2 = RpcValue::fromCpon(cpon).toDouble();
+			if(d != d2)
+				qDebug() << "double:" << d << "cpon:" << cpon << "parsed:" << d2;
+			QCOMPARE(d2, d);
+		}
+		for(double d : {DBL_MAX, -DBL_MAX, DBL_MIN, 1e23, 5e-324, 9007199254740993.})
+			QCOMPARE(RpcValue::fromCpon(RpcValue(d).toCpon()).toDouble(), d);
+	}
+	void pullReaderTest()
+	{
+		qDebug() << "================================= PullReader Test =====================================";
+		for(const char *cpon : {
+			R"(<1:2,"foo":"bar",3:<4:5>[1]>{"a":[1,2,{"x":i{1:2,3:"s"}}],"b":x"0001ab","c":null,"d":d"2019-01-01T00:00:00Z","e":1.5,"f":12.3e-2,"g":true,"h":12u})",
+			"[]", "i{}", "[[[]]]", R"("")", R"(<"a":1>{"k":<8:1>"v"})", "i{-1:1,2:i{3:[{}]}}", "123", "[<1:2>[1],<3:4>{}]",
+			}) {
+			const RpcValue rv = RpcValue::fromCpon(cpon);
+			for(PullReader::Format format : {PullReader::Format::ChainPack, PullReader::Format::Cpon}) {
+				std::istringstream in(format == PullReader::Format::ChainPack? rv.toChainPack(): rv.toCpon());
+				PullReader rd(in, format);
+				QCOMPARE(rd.read().toCpon(), rv.toCpon());
+				QVERIFY(rd.next() == PullReader::Event::End);
+			}
+		}
+		for(PullReader::Format format : {PullReader::Format::ChainPack, PullReader::Format::Cpon}) {
+			// concatenated values, every read() starts new top level value
+			const RpcValue v1 = 1;
+			const RpcValue v2 = RpcValue::fromCpon(R"(<1:2>[2,{"a":3}])");
+			const RpcValue v3 = "foo";
+			std::istringstream in(format == PullReader::Format::ChainPack
+								  ? v1.toChainPack() + v2.toChainPack() + v3.toChainPack()
+								  : v1.toCpon() + " " + v2.toCpon() + " " + v3.toCpon());
+			PullReader rd(in, format);
+			QCOMPARE(rd.read().toCpon(), v1.toCpon());
+			QCOMPARE(rd.read().toCpon(), v2.toCpon());
+			// End is reported once after the value was read
+			QVERIFY(rd.next() == PullReader::Event::End);
+			QCOMPARE(rd.read().toCpon(), v3.toCpon());
+		}
+		// getLog like data walked by cursor, not read columns and rows are skipped
+		const RpcValue log = RpcValue::fromCpon(R"(<"fields":["ts","path","val"]>[[d"2019-01-01T00:00:00Z","a/b",{"x":[1,2]}],[d"2019-01-01T00:00:01Z","c",3,"extra",[1,[2]]],"bad",[]])");
+		std::istringstream in(log.toChainPack());
+		PullReader rd(in);
+		QVERIFY(rd.next() == PullReader::Event::MetaBegin);
+		QCOMPARE(rd.readMetaData().value("fields").toList().size(), static_cast<size_t>(3));
+		QVERIFY(rd.next() == PullReader::Event::ListBegin);
+		PullReader::Cursor rows(rd);
+		std::vector<std::string> paths;
+		std::vector<std::string> values;
+		while(rows.next()) {
+			if(rd.event() != PullReader::Event::ListBegin) {
+				rd.skip();
+				continue;
+			}
+			PullReader::Cursor cols(rd);
+			while(cols.next()) {
+				if(cols.index() == 0)
+					QVERIFY(rd.type() == RpcValue::Type::DateTime);
+				else if(cols.index() == 1)
+					paths.push_back(rd.toString());
+				else if(cols.index() == 2)
+					values.push_back(rd.readValue().toCpon());
+			}
+		}
+		QCOMPARE(rows.index(), 3);
+		QVERIFY(paths == (std::vector<std::string>{"a/b", "c"}));
+		QVERIFY(values == (std::vector<std::string>{R"({"x":[1,2]})", "3"}));
+		QVERIFY(rd.next() == PullReader::Event::End);
+	}
+	void benchmarkCponDouble_data()
+	{
+		QTest::addColumn<bool>("parse");
+		QTest::newRow("format") << false;
+		QTest::newRow("parse") << true;
+	}
+	void benchmarkCponDouble()
+	{
+		QFETCH(bool, parse);
+		// journal like numeric data, analog values sampled with few decimal places and full precision computed ones
+		std::mt19937_64 gen(1);
+		std::normal_distribution<double> voltage(230, 5);
+		std::uniform_real_distribution<double> ratio(0, 1);
+		RpcValue::List log;
+		for (int i = 0; i < 10000; ++i) {
+			RpcValue::List row;
+			row.push_back(RpcValue::DateTime::fromMSecsSinceEpoch(1500000000000LL + i * 100));
+			row.push_back("system/voltage/U" + std::to_string(i % 3));
+			row.push_back(std::round(voltage(gen) * 100) / 100);
+			row.push_back(ratio(gen));
+			log.push_back(row);
+		}
+		const RpcValue rv(log);
+		if(parse) {
+			const std::string cpon = rv.toCpon();
+			double sum = 0;
+			QBENCHMARK {
+				const RpcValue rv2 = RpcValue::fromCpon(cpon);
+				for(const RpcValue &row : rv2.toList())
+					sum += row.toList()[2].toDouble() + row.toList()[3].toDouble();
+			}
+			QVERIFY(sum > 0);
+		}
+		else {
+			size_t len = 0;
+			QBENCHMARK {
+				len += rv.toCpon().size();
+			}
+			QVERIFY(len > 0);
+		}
+	}
 
 
 	void cleanupTestCase()
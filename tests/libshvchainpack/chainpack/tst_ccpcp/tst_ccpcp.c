@@ -610,12 +610,16 @@ int main(int argc, const char * argv[])
 	test_pack_double(1.23e7, "1.23e7");
 	test_pack_double(1e8, "1e8");
 	test_pack_double(-1e8, "-1e8");
-	test_pack_double(-123456789e-8, "-1.234567");
-	test_pack_double(-123456789e-9, "-0.123456");
-	test_pack_double(-123456789e-10, "-1.234567e-2");
-	test_pack_double(123456789., "1.234567e8");
-	test_pack_double(123456789e1, "1.234567e9");
-	test_pack_double(123456789e2, "1.234567e10");
+	test_pack_double(-123456789e-8, "-1.23456789");
+	test_pack_double(-123456789e-9, "-0.123456789");
+	test_pack_double(-123456789e-10, "-1.23456789e-2");
+	test_pack_double(123456789., "1.23456789e8");
+	test_pack_double(123456789e1, "1.23456789e9");
+	test_pack_double(123456789e2, "1.23456789e10");
+	test_pack_double(100.25, "100.25");
+	test_pack_double(0.1 + 0.2, "0.30000000000000004");
+	test_pack_double(5e-324, "5e-324");
+	test_pack_double(1.7976931348623157e308, "1.7976931348623157e308");
 
 	test_unpack_number("1", CCPCP_ITEM_INT, 1);
 	test_unpack_number("123u", CCPCP_ITEM_UINT, 123);
@@ -640,6 +644,10 @@ int main(int argc, const char * argv[])
 	test_unpack_number("-21.23e-4", CCPCP_ITEM_DECIMAL, -21.23e-4);
 	test_unpack_number("-0.567e-3", CCPCP_ITEM_DECIMAL, -0.567e-3);
 	test_unpack_number("1.23n", CCPCP_ITEM_DECIMAL, 1.23);
+	test_unpack_number("100.25", CCPCP_ITEM_DECIMAL, 100.25);
+	test_unpack_number("0.30000000000000004", CCPCP_ITEM_DECIMAL, 0.1 + 0.2);
+	test_unpack_number("1.7976931348623157e308", CCPCP_ITEM_DECIMAL, 1.7976931348623157e308);
+	test_unpack_number("5e-324", CCPCP_ITEM_DECIMAL, 5e-324);
 
 	test_unpack_datetime("d\"2018-02-02T0:00:00.001\"", 1, 0);
 	test_unpack_datetime("d\"1970-01-01 00:00:00-01\"", 0, -60);
@@ -19,6 +19,8 @@
 #include <QDir>
 
 #include <fstream>
+#include <random>
+#include <thread>
 
 using namespace std;
 using namespace shv::core::utils;
@@ -448,6 +450,254 @@ private slots:
 		test1();
 	}
 
+	void groupCommitTest()
+	{
+		const string journal_dir = TEST_DIR + "/groupcommitjournal";
+		QDir(QString::fromStdString(journal_dir)).removeRecursively();
+		constexpr int CNT = 5000;
+		auto count_log_entries = [](ShvFileJournal &file_journal) {
+			ShvGetLogParams params;
+			params.withSnapshot = false;
+			params.recordCountLimit = CNT * 2;
+			RpcValue log = file_journal.getLog(params);
+			int cnt = 0;
+			ShvLogRpcValueReader rd(log);
+			while(rd.next()) {
+				// every new file starts with snapshot
+				if(!rd.entry().isSnapshotValue())
+					cnt++;
+			}
+			return cnt;
+		};
+		{
+			ShvFileJournal file_journal("testdev");
+			file_journal.setJournalDir(journal_dir);
+			file_journal.setFileSizeLimit(1024*64*20);
+			file_journal.setJournalSizeLimit(file_journal.fileSizeLimit() * 10);
+			ShvJournalFileWriter::FlushPolicy policy;
+			policy.maxPendingBytes = 64 * 1024;
+			file_journal.setFlushPolicy(policy);
+			auto msec = RpcValue::DateTime::now().msecsSinceEpoch();
+			for (int i = 1; i <= CNT; ++i) {
+				ShvJournalEntry e("node" + std::to_string(i % 10) + "/value", RpcValue(i));
+				e.epochMsec = msec + i;
+				file_journal.append(e);
+			}
+			// getLog() must see pending entries too
+			QCOMPARE(count_log_entries(file_journal), CNT);
+			ShvJournalEntry e("node0/value", RpcValue(0));
+			e.epochMsec = msec + CNT + 1;
+			file_journal.append(e);
+		}
+		{
+			// pending entries are written on journal destruction
+			ShvFileJournal file_journal("testdev");
+			file_journal.setJournalDir(journal_dir);
+			QCOMPARE(count_log_entries(file_journal), CNT + 1);
+		}
+	}
+
+	void asyncWriterTest()
+	{
+		const string journal_dir = TEST_DIR + "/asyncjournal";
+		QDir(QString::fromStdString(journal_dir)).removeRecursively();
+		ShvFileJournal file_journal("testdev");
+		file_journal.setJournalDir(journal_dir);
+		file_journal.setFileSizeLimit(1024*64);
+		file_journal.setJournalSizeLimit(file_journal.fileSizeLimit() * 100);
+		ShvJournalFileWriter::FlushPolicy policy;
+		policy.maxPendingBytes = 16 * 1024;
+		policy.maxPendingMsec = 100;
+		file_journal.setFlushPolicy(policy);
+		// small queue to exercise full queue waiting
+		file_journal.startAsyncWriter(64);
+		constexpr int THREAD_CNT = 4;
+		constexpr int CNT = 2000;
+		auto msec = RpcValue::DateTime::now().msecsSinceEpoch();
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREAD_CNT; ++t) {
+			threads.emplace_back([&file_journal, t, msec]() {
+				for (int i = 1; i <= CNT; ++i) {
+					ShvJournalEntry e("thread" + std::to_string(t) + "/value", RpcValue(i));
+					e.epochMsec = msec + i;
+					file_journal.append(e);
+				}
+			});
+		}
+		for(auto &th : threads)
+			th.join();
+		ShvGetLogParams params;
+		params.withSnapshot = false;
+		params.recordCountLimit = THREAD_CNT * CNT * 2;
+		// flush barrier, all appended entries must be visible
+		RpcValue log = file_journal.getLog(params);
+		int cnt = 0;
+		ShvLogRpcValueReader rd(log);
+		while(rd.next()) {
+			// every new file starts with snapshot
+			if(!rd.entry().isSnapshotValue())
+				cnt++;
+		}
+		QCOMPARE(cnt, THREAD_CNT * CNT);
+		RpcValue::Map snapshot = file_journal.getSnapShotMap().toMap();
+		QCOMPARE(snapshot.size(), static_cast<size_t>(THREAD_CNT));
+		QCOMPARE(snapshot.value("thread0/value").toInt(), CNT);
+		file_journal.stopAsyncWriter();
+	}
+
+	void snapshotCheckpointTest()
+	{
+		const string journal_dir = TEST_DIR + "/checkpointjournal";
+		QDir(QString::fromStdString(journal_dir)).removeRecursively();
+		ShvFileJournal file_journal("testdev");
+		file_journal.setJournalDir(journal_dir);
+		file_journal.setFileSizeLimit(1024*64);
+		file_journal.setJournalSizeLimit(file_journal.fileSizeLimit() * 100);
+		file_journal.setSnapshotCheckpointInterval(4 * 1024);
+		std::mt19937 mt(1);
+		const int64_t msec0 = RpcValue::DateTime::now().msecsSinceEpoch();
+		int64_t msec = msec0;
+		for (int i = 0; i < 20000; ++i) {
+			msec += mt() % 20;
+			ShvJournalEntry e("node" + std::to_string(mt() % 100) + "/value", RpcValue(static_cast<int>(mt() % 3)));
+			e.epochMsec = msec;
+			file_journal.append(e);
+		}
+		file_journal.flush();
+		std::vector<RpcValue> logs;
+		std::vector<ShvGetLogParams> params_list;
+		for (int i = 0; i < 20; ++i) {
+			ShvGetLogParams params;
+			params.since = RpcValue::DateTime::fromMSecsSinceEpoch(msec0 + static_cast<int64_t>(mt() % static_cast<unsigned>(msec - msec0)));
+			params.recordCountLimit = 200;
+			params_list.push_back(params);
+			logs.push_back(file_journal.getLog(params));
+		}
+		// the same result must be generated by full replay of journal files
+		QDir dir(QString::fromStdString(journal_dir));
+		const QStringList index_files = dir.entryList({"*" + QString::fromStdString(ShvFileJournal::FILE_EXT + ShvFileJournal::CHECKPOINT_INDEX_EXT)});
+		QVERIFY(!index_files.isEmpty());
+		for(const QString &fn : index_files)
+			QVERIFY(dir.remove(fn));
+		for (size_t i = 0; i < params_list.size(); ++i) {
+			RpcValue log = file_journal.getLog(params_list[i]);
+			QVERIFY(log.asList() == logs[i].asList());
+		}
+	}
+
+	void manifestTest()
+	{
+		const string journal_dir = TEST_DIR + "/manifestjournal";
+		QDir(QString::fromStdString(journal_dir)).removeRecursively();
+		const int64_t msec0 = RpcValue::DateTime::now().msecsSinceEpoch();
+		int64_t recent_ts;
+		{
+			ShvFileJournal file_journal("testdev");
+			file_journal.setJournalDir(journal_dir);
+			file_journal.setManifestEnabled(true);
+			file_journal.setFileSizeLimit(1024*16);
+			file_journal.setJournalSizeLimit(file_journal.fileSizeLimit() * 20);
+			for (int i = 0; i < 50000; ++i) {
+				ShvJournalEntry e("node" + std::to_string(i % 50) + "/value", RpcValue(i % 7));
+				e.epochMsec = msec0 + i;
+				file_journal.append(e);
+			}
+			recent_ts = file_journal.recentlyWrittenEntryDateTime();
+		}
+		{
+			// manifest is replaced by rename, no temporary file is left
+			const string manifest_fn = journal_dir + '/' + ShvFileJournal::MANIFEST_DIR_NAME + '/' + ShvFileJournal::MANIFEST_FILE_NAME;
+			QVERIFY(std::ifstream(manifest_fn).good());
+			QVERIFY(!std::ifstream(manifest_fn + ".tmp").good());
+		}
+		auto check_journal = [&journal_dir](int64_t recent_ts) {
+			ShvFileJournal file_journal("testdev");
+			file_journal.setJournalDir(journal_dir);
+			file_journal.setManifestEnabled(true);
+			ShvFileJournal::JournalContext ctx = file_journal.checkJournalContext();
+			QCOMPARE(ctx.recentTimeStamp, recent_ts);
+			ShvFileJournal::JournalContext ctx2 = file_journal.checkJournalContext(ShvFileJournal::Force);
+			QCOMPARE(ctx.files, ctx2.files);
+			QCOMPARE(ctx.journalSize, ctx2.journalSize);
+			QCOMPARE(ctx.lastFileSize, ctx2.lastFileSize);
+		};
+		// loaded from manifest
+		check_journal(recent_ts);
+		// journal dir modified outside, manifest must be ignored, recent time stamp is not known then
+		{
+			std::ofstream out(journal_dir + "/2100-01-01T00-00-00-000" + ShvFileJournal::FILE_EXT);
+		}
+		check_journal(0);
+	}
+
+	void parallelGetLogTest()
+	{
+		const string journal_dir = TEST_DIR + "/paralleljournal";
+		QDir(QString::fromStdString(journal_dir)).removeRecursively();
+		ShvFileJournal file_journal("testdev");
+		file_journal.setJournalDir(journal_dir);
+		file_journal.setFileSizeLimit(1024*16);
+		file_journal.setJournalSizeLimit(file_journal.fileSizeLimit() * 100);
+		std::mt19937 mt(1);
+		const int64_t msec0 = RpcValue::DateTime::now().msecsSinceEpoch();
+		int64_t msec = msec0;
+		for (int i = 0; i < 30000; ++i) {
+			msec += mt() % 20;
+			ShvJournalEntry e("node" + std::to_string(mt() % 100) + "/value", RpcValue(static_cast<int>(mt() % 3)));
+			e.epochMsec = msec;
+			file_journal.append(e);
+		}
+		for (int i = 0; i < 20; ++i) {
+			ShvGetLogParams params;
+			int64_t since = msec0 + static_cast<int64_t>(mt() % static_cast<unsigned>(msec - msec0));
+			params.since = RpcValue::DateTime::fromMSecsSinceEpoch(since);
+			if(i % 2)
+				params.until = RpcValue::DateTime::fromMSecsSinceEpoch(since + static_cast<int64_t>(mt() % 100000));
+			if(i % 3 == 0)
+				params.pathPattern = "node1*";
+			params.recordCountLimit = (i % 4 == 0)? 500: 100000;
+			file_journal.setGetLogThreadCount(1);
+			RpcValue log1 = file_journal.getLog(params);
+			file_journal.setGetLogThreadCount(4);
+			RpcValue log2 = file_journal.getLog(params);
+			QVERIFY(log1.asList() == log2.asList());
+			QCOMPARE(log1.metaValue("until"), log2.metaValue("until"));
+		}
+	}
+
+	void getLogCacheTest()
+	{
+		const string journal_dir = TEST_DIR + "/cachejournal";
+		QDir(QString::fromStdString(journal_dir)).removeRecursively();
+		ShvFileJournal file_journal("testdev");
+		file_journal.setJournalDir(journal_dir);
+		file_journal.setGetLogCacheBudget(1024 * 1024);
+		int64_t msec = RpcValue::DateTime::now().msecsSinceEpoch();
+		for (int i = 0; i < 1000; ++i) {
+			ShvJournalEntry e("node" + std::to_string(i % 10) + "/value", i);
+			e.epochMsec = msec++;
+			file_journal.append(e);
+		}
+		ShvGetLogParams params;
+		params.since = RpcValue::DateTime::fromMSecsSinceEpoch(msec - 500);
+		RpcValue log1 = file_journal.getLog(params);
+		RpcValue log2 = file_journal.getLog(params);
+		QVERIFY(log1.asList() == log2.asList());
+		QCOMPARE(log1.metaValue("until"), log2.metaValue("until"));
+		RpcValue stats = file_journal.getLogCacheStats();
+		QCOMPARE(stats.asMap().value("hits").toInt(), 1);
+		QCOMPARE(stats.asMap().value("misses").toInt(), 1);
+
+		ShvJournalEntry e("node1/value", -1);
+		e.epochMsec = msec;
+		file_journal.append(e);
+		RpcValue log3 = file_journal.getLog(params);
+		QCOMPARE(log3.asList().size(), log1.asList().size() + 1);
+		stats = file_journal.getLogCacheStats();
+		QCOMPARE(stats.asMap().value("invalidations").toInt(), 1);
+		QCOMPARE(stats.asMap().value("misses").toInt(), 2);
+	}
+
 	void cleanupTestCase()
 	{
 		//qDebug("called after firstTest and secondTest");
@@ -1,11 +1,15 @@
 #include <shv/core/utils/shvfilejournal.h>
 #include <shv/core/utils/shvlogheader.h>
 #include <shv/core/utils/shvjournalentry.h>
+#include <shv/core/utils/shvlogcolumns.h>
+#include <shv/core/utils/shvlogrpcvaluereader.h>
 #include <shv/core/utils/shvmemoryjournal.h>
 
 #include <QtTest/QtTest>
 #include <QDebug>
 
+#include <sstream>
+
 using namespace shv::core::utils;
 using namespace shv::chainpack;
 
@@ -62,6 +66,89 @@ private:
 
 		QVERIFY(log1.toList().size() == log2.toList().size());
 	}
+
+	static std::vector<ShvJournalEntry> readLog(const RpcValue &log)
+	{
+		std::vector<ShvJournalEntry> ret;
+		ShvLogRpcValueReader rd(log);
+		while(rd.next())
+			ret.push_back(rd.entry());
+		return ret;
+	}
+	static std::vector<ShvJournalEntry> readLog(const RpcValue &log, PullReader::Format format)
+	{
+		std::vector<ShvJournalEntry> ret;
+		std::istringstream in(format == PullReader::Format::ChainPack? log.toChainPack(): log.toCpon());
+		ShvLogRpcValueReader rd(in, format);
+		while(rd.next())
+			ret.push_back(rd.entry());
+		return ret;
+	}
+
+	void testColumnar()
+	{
+		qDebug() << "============= TestShvMemoryJournal columnar ============\n";
+		ShvMemoryJournal journal1;
+		appendEntry(journal1, "path1", 10, 100);
+		appendEntry(journal1, "path2", "foo", 110);
+		journal1.append(ShvJournalEntry("path3", 1.5, ShvJournalEntry::DOMAIN_VAL_FASTCHANGE, 1234, ShvJournalEntry::NO_VALUE_FLAGS, 1000));
+		journal1.append(ShvJournalEntry("path3", 1.6, ShvJournalEntry::DOMAIN_VAL_FASTCHANGE, 65535, ShvJournalEntry::NO_VALUE_FLAGS, 1100));
+		journal1.append(ShvJournalEntry("path4", RpcValue(nullptr), "someEvent", ShvJournalEntry::NO_SHORT_TIME, ShvJournalEntry::NO_VALUE_FLAGS, 5000));
+		{
+			ShvJournalEntry e("path1", RpcValue::List{1, 2}, shv::chainpack::Rpc::SIG_VAL_CHANGED, ShvJournalEntry::NO_SHORT_TIME, ShvJournalEntry::NO_VALUE_FLAGS, 5000);
+			e.setSpontaneous(true);
+			e.userId = "user1";
+			journal1.append(e);
+		}
+		for (int i = 0; i < 100; ++i)
+			appendEntry(journal1, "path" + std::to_string(i % 7), i, 6000 + i * 1000);
+
+		ShvGetLogParams params;
+		params.since = RpcValue::DateTime::fromMSecsSinceEpoch(105);
+		params.withSnapshot = true;
+		params.withPathsDict = false;
+		RpcValue row_log = journal1.getLog(params);
+		params.columnar = true;
+		RpcValue columnar_log = journal1.getLog(params);
+		QVERIFY(ShvLogColumnsReader::isColumnar(columnar_log));
+		QVERIFY(columnar_log.metaValue("withPathsDict").toBool());
+		QCOMPARE(ShvGetLogParams::fromRpcValue(params.toRpcValue()).columnar, true);
+		qDebug() << "row log size:" << row_log.toChainPack().size() << "columnar log size:" << columnar_log.toChainPack().size();
+		QVERIFY(columnar_log.toChainPack().size() < row_log.toChainPack().size());
+
+		std::vector<ShvJournalEntry> row_entries = readLog(row_log);
+		QCOMPARE(row_entries.size(), static_cast<size_t>(106));
+		for(const RpcValue &log : {columnar_log, RpcValue::fromChainPack(columnar_log.toChainPack()), ShvLogColumnsReader::toRowLog(columnar_log)}) {
+			std::vector<ShvJournalEntry> entries = readLog(log);
+			QCOMPARE(entries.size(), row_entries.size());
+			for (size_t i = 0; i < entries.size(); ++i)
+				QVERIFY(entries[i] == row_entries[i]);
+		}
+		for(const RpcValue &log : {row_log, columnar_log}) {
+			for(PullReader::Format format : {PullReader::Format::ChainPack, PullReader::Format::Cpon}) {
+				std::vector<ShvJournalEntry> entries = readLog(log, format);
+				QCOMPARE(entries.size(), row_entries.size());
+				for (size_t i = 0; i < entries.size(); ++i)
+					QVERIFY(entries[i] == row_entries[i]);
+			}
+		}
+
+		ShvMemoryJournal journal2;
+		journal2.loadLog(columnar_log);
+		params.columnar = false;
+		QCOMPARE(readLog(journal2.getLog(params)).size(), row_entries.size());
+
+		{
+			// truncated column
+			RpcValue::Map columns = columnar_log.asMap();
+			RpcValue::Blob timestamps = columns.value("timestamp").asBlob();
+			timestamps.resize(timestamps.size() / 2);
+			columns["timestamp"] = timestamps;
+			RpcValue corrupted = columns;
+			corrupted.setMetaData(RpcValue::MetaData(columnar_log.metaData()));
+			QVERIFY(readLog(corrupted).size() < row_entries.size());
+		}
+	}
 private slots:
 	void initTestCase()
 	{
@@ -70,6 +157,10 @@ private slots:
 	{
 		test1();
 	}
+	void columnarTest()
+	{
+		testColumnar();
+	}
 
 	void cleanupTestCase()
 	{
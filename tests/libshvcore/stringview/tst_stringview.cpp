@@ -1,4 +1,5 @@
 #include <shv/core/stringview.h>
+#include <shv/core/string.h>
 
 #include <QtTest/QtTest>
 #include <QDebug>
@@ -139,6 +140,35 @@ private:
 			QVERIFY(sl2[5].empty());
 			QVERIFY(sl2[6] == "baz");
 		}
+		{
+			qDebug() << "------------- char buffer";
+			const char buff[] = {'x', 'a', '/', 'b', 'c', '\t', '4', '2', 'y'};
+			shv::core::StringView s(buff + 1, 7);
+			QVERIFY(s.length() == 7);
+			QVERIFY(s.data() == buff + 1);
+			QVERIFY(s.startsWith("a/"));
+			QVERIFY(s.endsWith("42"));
+			QVERIFY(s.indexOf('\t') == 4);
+			QVERIFY(s.lastIndexOf('/') == 1);
+			std::vector<shv::core::StringView> sl = s.split('\t');
+			QVERIFY(sl.size() == 2);
+			QVERIFY(sl[0] == std::string("a/bc"));
+			QVERIFY(sl[1] == shv::core::StringView("42"));
+			QVERIFY(sl[1].toInt() == 42);
+			// view can be widened up to the buffer end, but not beyond
+			QVERIFY(sl[1].mid(0, 100).length() == 2);
+			QVERIFY(shv::core::StringView(buff, sizeof(buff), 6, 100) == "42y");
+		}
+		{
+			qDebug() << "------------- toInt";
+			for(const char *str : {"0", "123", "-123", "+7", " 12", "2147483647", "-2147483648", "", "-", "12 ", "1a", "0x10", "2147483648", "-2147483649", "99999999999999999999"}) {
+				bool ok1, ok2;
+				int n1 = shv::core::StringView(str).toInt(&ok1);
+				int n2 = shv::core::String::toInt(str, &ok2);
+				QCOMPARE(ok1, ok2);
+				QCOMPARE(n1, n2);
+			}
+		}
 	}
 private slots:
 	void initTestCase()